@@ -28,32 +28,107 @@ INCLUDEPATH += $$PWD/src
 
 QT += core
 QT += network
-QT += widgets
-QT += multimedia
+
+# The telemetry block uses shm_open(), which lives in librt on older glibcs
+linux: LIBS += -lrt
 
 HEADERS += \
+    $$PWD/src/Core/ControlDecoder.h \
+    $$PWD/src/Core/ControlServer.h \
+    $$PWD/src/Core/EventBus.h \
+    $$PWD/src/Core/EvdevInput.h \
+    $$PWD/src/Core/FleetScheduler.h \
+    $$PWD/src/Core/Impairment.h \
+    $$PWD/src/Core/JoystickStore.h \
+    $$PWD/src/Core/LoopMonitor.h \
+    $$PWD/src/Core/Metrics.h \
+    $$PWD/src/Core/MetricsServer.h \
     $$PWD/src/Core/NetConsole.h \
     $$PWD/src/Core/Protocol.h \
     $$PWD/src/Core/Sockets.h \
+    $$PWD/src/Core/StateSnapshot.h \
+    $$PWD/src/Core/StaticProtocol.h \
+    $$PWD/src/Core/TelemetryExport.h \
+    $$PWD/src/Core/SocketTuning.h \
+    $$PWD/src/Core/Transport.h \
     $$PWD/src/Core/Watchdog.h \
-    $$PWD/src/Protocols/FRC_2014.h \
-    $$PWD/src/Protocols/FRC_2015.h \
-    $$PWD/src/Protocols/FRC_2016.h \
     $$PWD/src/Utilities/CRC32.h \
+    $$PWD/src/Utilities/Clock.h \
+    $$PWD/src/Utilities/Histogram.h \
+    $$PWD/src/Utilities/SeqLock.h \
+    $$PWD/src/Utilities/SpscQueue.h \
+    $$PWD/src/Utilities/StageTimers.h \
+    $$PWD/src/Utilities/StreamFramer.h \
+    $$PWD/src/Utilities/Tracer.h \
     $$PWD/src/DriverStation.h \
+    $$PWD/src/Engine.h \
+    $$PWD/src/Engine_C.h \
+    $$PWD/src/Fleet.h \
+    $$PWD/src/FieldServer.h \
     $$PWD/src/Core/DS_Base.h \
     $$PWD/src/Core/DS_Config.h \
     $$PWD/src/Core/DS_Common.h \
     $$PWD/src/Core/Logger.h
 
 SOURCES += \
+    $$PWD/src/Core/ControlDecoder.cpp \
+    $$PWD/src/Core/ControlServer.cpp \
+    $$PWD/src/Core/EventBus.cpp \
+    $$PWD/src/Core/EvdevInput.cpp \
+    $$PWD/src/Core/FleetScheduler.cpp \
+    $$PWD/src/Core/Impairment.cpp \
+    $$PWD/src/Core/JoystickStore.cpp \
+    $$PWD/src/Core/LoopMonitor.cpp \
+    $$PWD/src/Core/Metrics.cpp \
+    $$PWD/src/Core/MetricsServer.cpp \
     $$PWD/src/Core/NetConsole.cpp \
     $$PWD/src/Core/Sockets.cpp \
+    $$PWD/src/Core/StateSnapshot.cpp \
+    $$PWD/src/Core/SocketTuning.cpp \
+    $$PWD/src/Core/TelemetryExport.cpp \
+    $$PWD/src/Core/Transport.cpp \
     $$PWD/src/Core/Watchdog.cpp \
-    $$PWD/src/Protocols/FRC_2014.cpp \
-    $$PWD/src/Protocols/FRC_2015.cpp \
-    $$PWD/src/Protocols/FRC_2016.cpp \
     $$PWD/src/Utilities/CRC32.cpp \
+    $$PWD/src/Utilities/Clock.cpp \
+    $$PWD/src/Utilities/Histogram.cpp \
+    $$PWD/src/Utilities/StageTimers.cpp \
+    $$PWD/src/Utilities/StreamFramer.cpp \
+    $$PWD/src/Utilities/Tracer.cpp \
     $$PWD/src/DriverStation.cpp \
+    $$PWD/src/Engine.cpp \
+    $$PWD/src/Engine_C.cpp \
+    $$PWD/src/Fleet.cpp \
+    $$PWD/src/FieldServer.cpp \
     $$PWD/src/Core/DS_Config.cpp \
     $$PWD/src/Core/Logger.cpp
+
+#
+# Protocols: by default, every protocol is built and the protocol can be
+# changed at runtime. Run qmake with LIBDS_PROTOCOL=2014, 2015 or 2016 to
+# build only that protocol and bind it statically (see StaticProtocol.h).
+# The unit tests (tests/Tests.pro) are only built with every protocol.
+#
+
+!isEmpty (LIBDS_PROTOCOL) {
+    !equals (LIBDS_PROTOCOL, 2014):!equals (LIBDS_PROTOCOL, 2015):!equals (LIBDS_PROTOCOL, 2016) {
+        error ("Unsupported LIBDS_PROTOCOL: $$LIBDS_PROTOCOL")
+    }
+
+    DEFINES += LIB_DS_STATIC_PROTOCOL=$$LIBDS_PROTOCOL
+    CONFIG += ltcg
+}
+
+isEmpty (LIBDS_PROTOCOL)|equals (LIBDS_PROTOCOL, 2014) {
+    HEADERS += $$PWD/src/Protocols/FRC_2014.h
+    SOURCES += $$PWD/src/Protocols/FRC_2014.cpp
+}
+
+isEmpty (LIBDS_PROTOCOL)|!equals (LIBDS_PROTOCOL, 2014) {
+    HEADERS += $$PWD/src/Protocols/FRC_2015.h
+    SOURCES += $$PWD/src/Protocols/FRC_2015.cpp
+}
+
+isEmpty (LIBDS_PROTOCOL)|equals (LIBDS_PROTOCOL, 2016) {
+    HEADERS += $$PWD/src/Protocols/FRC_2016.h
+    SOURCES += $$PWD/src/Protocols/FRC_2016.cpp
+}
@@ -26,3 +26,5 @@ TEMPLATE = lib
 DEFINES += LIB_DS_SHARED
 
 include ($$PWD/LibDS.pri)
+
+QT -= gui
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <QFile>
+#include <QSettings>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <DriverStation.h>
+
+#if defined Q_OS_UNIX
+#include <signal.h>
+#include <unistd.h>
+#include <QSocketNotifier>
+#elif defined Q_OS_WIN
+#include <windows.h>
+#endif
+
+#if defined Q_OS_UNIX
+static int SIGNAL_PIPE [2] = { -1, -1 };
+
+/**
+ * Wakes up the event loop by writing to the signal pipe, since only
+ * async-signal-safe functions may be called from a signal handler
+ */
+static void SIGNAL_HANDLER (int number) {
+    char byte = static_cast<char> (number);
+    ssize_t written = write (SIGNAL_PIPE [1], &byte, 1);
+    Q_UNUSED (written);
+}
+#elif defined Q_OS_WIN
+/**
+ * Quits the event loop when the console is closed or Ctrl+C is pressed.
+ * The handler runs in its own thread, so the call is queued.
+ */
+static BOOL WINAPI CONSOLE_HANDLER (DWORD type) {
+    Q_UNUSED (type);
+    QMetaObject::invokeMethod (QCoreApplication::instance(), "quit",
+                               Qt::QueuedConnection);
+    return TRUE;
+}
+#endif
+
+/**
+ * Quits the \a app when the daemon is asked to stop (e.g. with Ctrl+C or by
+ * a service manager), so that the DS shuts down cleanly and the trace is
+ * saved. On POSIX systems, a second signal terminates the daemon right away.
+ */
+static void HANDLE_TERMINATION (QCoreApplication* app) {
+#if defined Q_OS_UNIX
+    if (pipe (SIGNAL_PIPE) != 0) {
+        perror ("Cannot handle termination signals");
+        return;
+    }
+
+    QSocketNotifier* notifier = new QSocketNotifier (SIGNAL_PIPE [0],
+                                                     QSocketNotifier::Read,
+                                                     app);
+    QObject::connect (notifier, SIGNAL (activated (int)),
+                      notifier, SLOT (deleteLater()));
+    QObject::connect (notifier, SIGNAL (activated (int)),
+                      app,      SLOT (quit()));
+
+    struct sigaction action;
+    memset (&action, 0, sizeof (action));
+    sigemptyset (&action.sa_mask);
+    action.sa_handler = SIGNAL_HANDLER;
+    action.sa_flags = SA_RESTART | SA_RESETHAND;
+    sigaction (SIGINT, &action, Q_NULLPTR);
+    sigaction (SIGTERM, &action, Q_NULLPTR);
+#elif defined Q_OS_WIN
+    Q_UNUSED (app);
+    SetConsoleCtrlHandler (CONSOLE_HANDLER, TRUE);
+#else
+    Q_UNUSED (app);
+#endif
+}
+
+/**
+ * Returns the value of the given \a option. Values given in the command line
+ * take precedence over the values of the configuration file, which take
+ * precedence over the default values of the options.
+ */
+static QString VALUE (const QCommandLineParser& parser,
+                      const QSettings* config,
+                      const QString& option) {
+    if (!parser.isSet (option) && config && config->contains (option))
+        return config->value (option).toString();
+
+    return parser.value (option);
+}
+
+/**
+ * Returns \c true if the given flag \a option is set in the command line or
+ * in the configuration file
+ */
+static bool FLAG (const QCommandLineParser& parser,
+                  const QSettings* config,
+                  const QString& option) {
+    if (parser.isSet (option))
+        return true;
+
+    return config && config->value (option, false).toBool();
+}
+
+int main (int argc, char* argv[]) {
+    QCoreApplication app (argc, argv);
+    app.setApplicationName ("LibDS Daemon");
+    app.setApplicationVersion ("1.0");
+
+    /* Define the command line options */
+    QCommandLineParser parser;
+    parser.setApplicationDescription ("Runs a headless Driver Station, "
+                                      "configured from the command line or "
+                                      "from an INI file (whose keys are the "
+                                      "names of the long options)");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions ({
+        {"config",         "Read the options from an INI file", "file"},
+        {"team",           "Team number", "number", "0"},
+        {"protocol",       "Protocol year (2014, 2015 or 2016)", "year", "2016"},
+        {"station",        "Team station (red1-3 or blue1-3)", "station", "red1"},
+        {"fms-address",    "Custom FMS address", "address"},
+        {"radio-address",  "Custom radio address", "address"},
+        {"robot-address",  "Custom robot address", "address"},
+        {"low-latency",    "Tune the sockets for low latency"},
+        {"control",        "Accept control commands on this local socket", "name"},
+        {"metrics-port",   "Serve Prometheus metrics on this port (0 disables)", "port", "0"},
+        {"loop-monitor",   "Log the period and lateness of the DS loops"},
+        {"trace",          "Save a Chrome trace of the DS to this file on exit "
+                           "(including SIGINT and SIGTERM)", "file"},
+    });
+
+    parser.process (app);
+
+    /* Load the configuration file */
+    QSettings* config = Q_NULLPTR;
+    if (parser.isSet ("config")) {
+        QString file = parser.value ("config");
+        if (!QFile::exists (file)) {
+            fprintf (stderr, "Configuration file not found: %s\n",
+                     qPrintable (file));
+            return EXIT_FAILURE;
+        }
+
+        config = new QSettings (file, QSettings::IniFormat, &app);
+    }
+
+    /* Validate the protocol */
+    DriverStation::ProtocolType protocol;
+    QString year = VALUE (parser, config, "protocol");
+    if (year == "2016")
+        protocol = DriverStation::kFRC2016;
+    else if (year == "2015")
+        protocol = DriverStation::kFRC2015;
+    else if (year == "2014")
+        protocol = DriverStation::kFRC2014;
+    else {
+        fprintf (stderr, "Unsupported protocol: %s\n", qPrintable (year));
+        return EXIT_FAILURE;
+    }
+
+    /* Validate the team station */
+    QStringList stations;
+    stations << "red1" << "red2" << "red3" << "blue1" << "blue2" << "blue3";
+    QString station = VALUE (parser, config, "station").toLower();
+    if (!stations.contains (station)) {
+        fprintf (stderr, "Invalid team station: %s\n", qPrintable (station));
+        return EXIT_FAILURE;
+    }
+
+    /* Configure the DS */
+    DriverStation* ds = DriverStation::getInstance();
+    ds->setProtocolType (protocol);
+    ds->setTeam (VALUE (parser, config, "team").toInt());
+    ds->setTeamStation (stations.indexOf (station));
+    ds->setCustomFMSAddress (VALUE (parser, config, "fms-address"));
+    ds->setCustomRadioAddress (VALUE (parser, config, "radio-address"));
+    ds->setCustomRobotAddress (VALUE (parser, config, "robot-address"));
+    ds->setLoopMonitorLogging (FLAG (parser, config, "loop-monitor"));
+
+    if (FLAG (parser, config, "low-latency"))
+        ds->setSocketProfile (DS::kSocketProfileLowLatency);
+
+    QString control = VALUE (parser, config, "control");
+    if (!control.isEmpty() && !ds->serveControl (control))
+        return EXIT_FAILURE;
+
+    int metricsPort = VALUE (parser, config, "metrics-port").toInt();
+    if (metricsPort > 0 && !ds->serveMetrics (metricsPort))
+        return EXIT_FAILURE;
+
+    QString trace = VALUE (parser, config, "trace");
+    if (!trace.isEmpty()) {
+        ds->setTracingEnabled (true);
+        QObject::connect (&app, &QCoreApplication::aboutToQuit, [ds, trace]() {
+            ds->saveTrace (trace);
+        });
+    }
+
+    /* Stop cleanly when interrupted or terminated */
+    HANDLE_TERMINATION (&app);
+
+    /* Start the DS */
+    ds->init();
+
+    fprintf (stdout, "Running FRC %s DS for team %d (%s)\n",
+             qPrintable (year), ds->team(), qPrintable (station));
+    fflush (stdout);
+
+    return app.exec();
+}
@@ -1,7 +1,7 @@
 QT += gui
 QT += widgets
 
-include ($$PWD/../LibDS.pri)
+include ($$PWD/../LibDS_Gui.pri)
 
 TEMPLATE = app
 TARGET = SimpleDS
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "SimulatedRobot.h"
+
+#include <QTimer>
+#include <Core/DS_Common.h>
+#include <Utilities/CRC32.h>
+
+/* Voltage under which the simulated roboRIO reports a brownout */
+const qreal BROWNOUT_VOLTAGE = 6.8;
+
+/* Bytes of the roboRIO reply that are parsed by the LibDS */
+const int FRC_2015_HEADER_SIZE = 8;
+
+/* Size of the packets exchanged with the cRIO */
+const int FRC_2014_PACKET_SIZE = 1024;
+
+/* Offset of the sequence echo in the cRIO reply */
+const int FRC_2014_SEQUENCE_OFFSET = 30;
+
+/**
+ * Returns the given \a value as a binary-coded decimal byte (e.g. 12 = 0x12)
+ */
+static char TO_BCD (int value) {
+    return static_cast<char> (((value / 10) << 4) | (value % 10));
+}
+
+SimulatedRobot::SimulatedRobot (int id, const Settings& settings) {
+    m_id = id;
+    m_settings = settings;
+
+    m_cpuUsage = 20;
+    m_ramUsage = 40;
+
+    m_received = 0;
+    m_replied = 0;
+    m_dropped = 0;
+    m_invalid = 0;
+    m_sequenceGaps = 0;
+    m_windowReceived = 0;
+
+    m_lastSequence = -1;
+    m_lastArrival = -1;
+    m_maxInterArrival = 0;
+    m_windowStart = 0;
+
+    m_random.seed (settings.seed + id);
+
+    connect (&m_socket, SIGNAL (readyRead()), this, SLOT (onDataReceived()));
+}
+
+/**
+ * Returns the index of the robot in the simulator
+ */
+int SimulatedRobot::id() const {
+    return m_id;
+}
+
+/**
+ * Binds the robot socket, returns \c false if the address or port is in use
+ */
+bool SimulatedRobot::start() {
+    m_clock.start();
+
+    if (!m_socket.bind (m_settings.address, m_settings.inputPort)) {
+        qWarning() << "Robot" << m_id << "cannot bind to"
+                   << m_settings.address.toString() << m_settings.inputPort
+                   << ":" << m_socket.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Returns a line with the receive statistics of the robot and begins a new
+ * measurement window
+ */
+QString SimulatedRobot::statistics() {
+    qint64 now = m_clock.elapsed();
+    qreal window = qMax (now - m_windowStart, qint64 (1)) / 1000.0;
+    qreal rate = m_windowReceived / window;
+
+    QString line = QString ("Robot %1 (%2:%3): %4 pkt/s, rx %5, tx %6, "
+                            "dropped %7, invalid %8, seq gaps %9, "
+                            "max gap %10 ms")
+                   .arg (m_id, 2)
+                   .arg (m_settings.address.toString())
+                   .arg (m_settings.inputPort)
+                   .arg (rate, 6, 'f', 1)
+                   .arg (m_received)
+                   .arg (m_replied)
+                   .arg (m_dropped)
+                   .arg (m_invalid)
+                   .arg (m_sequenceGaps)
+                   .arg (m_maxInterArrival);
+
+    m_windowStart = now;
+    m_windowReceived = 0;
+    m_maxInterArrival = 0;
+
+    return line;
+}
+
+/**
+ * Reads every datagram sent by the DS, updates the statistics and schedules
+ * the reply for each one of them
+ */
+void SimulatedRobot::onDataReceived() {
+    while (m_socket.hasPendingDatagrams()) {
+        quint16 port;
+        QHostAddress address;
+        QByteArray request;
+
+        request.resize (qMax (m_socket.pendingDatagramSize(), qint64 (0)));
+        m_socket.readDatagram (request.data(), request.size(), &address, &port);
+
+        /* Update arrival statistics */
+        qint64 now = m_clock.elapsed();
+        if (m_lastArrival >= 0)
+            m_maxInterArrival = qMax (m_maxInterArrival, now - m_lastArrival);
+
+        ++m_received;
+        ++m_windowReceived;
+        m_lastArrival = now;
+
+        /* Generate the reply */
+        QByteArray reply;
+        if (m_settings.protocol == 2014)
+            reply = reply2014 (request);
+        else
+            reply = reply2015 (request);
+
+        if (reply.isEmpty()) {
+            ++m_invalid;
+            continue;
+        }
+
+        /* Count the DS packets that never reached us */
+        int sequence = ((quint8) request.at (0) << 8) | (quint8) request.at (1);
+        if (m_lastSequence >= 0) {
+            int diff = (sequence - m_lastSequence) & 0xFFFF;
+            if (diff > 1 && diff < 0x8000)
+                m_sequenceGaps += diff - 1;
+        }
+
+        m_lastSequence = sequence;
+
+        /* Simulate a lossy network */
+        if (dropReply()) {
+            ++m_dropped;
+            continue;
+        }
+
+        /* Reply to the DS */
+        if (!m_settings.replyToSource)
+            port = m_settings.replyPort;
+
+        int delay = replyDelay();
+        if (delay <= 0)
+            sendReply (reply, address, port);
+
+        else {
+            QTimer::singleShot (delay, Qt::PreciseTimer, this, [ = ]() {
+                sendReply (reply, address, port);
+            });
+        }
+    }
+}
+
+/**
+ * Generates a cRIO reply to the given \a request. The reply echoes the
+ * operation code (which reports the e-stop state), the team number and the
+ * sequence number of the request and reports the battery voltage in BCD.
+ */
+QByteArray SimulatedRobot::reply2014 (const QByteArray& request) {
+    if (request.size() < FRC_2014_PACKET_SIZE)
+        return QByteArray();
+
+    QByteArray data;
+    data.resize (FRC_2014_PACKET_SIZE);
+    data.fill (0x00);
+
+    /* Echo operation code */
+    data[0] = request.at (2);
+
+    /* Add the voltage (0x37 0x37 means that there is no robot code) */
+    if (m_settings.hasCode) {
+        int integer = static_cast<int> (m_settings.voltage);
+        int decimal = qRound ((m_settings.voltage - integer) * 100);
+        data[1] = TO_BCD (qBound (0, integer, 99));
+        data[2] = TO_BCD (qBound (0, decimal, 99));
+    }
+
+    else {
+        data[1] = 0x37;
+        data[2] = 0x37;
+    }
+
+    /* Echo team number and sequence number */
+    data[8] = request.at (4);
+    data[9] = request.at (5);
+    data[FRC_2014_SEQUENCE_OFFSET] = request.at (0);
+    data[FRC_2014_SEQUENCE_OFFSET + 1] = request.at (1);
+
+    /* Add CRC checksum */
+    CRC32 crc32;
+    crc32.update (data);
+    quint32 checksum = crc32.value();
+    data[1020] = (checksum & 0xff000000) >> 24;
+    data[1021] = (checksum & 0xff0000) >> 16;
+    data[1022] = (checksum & 0xff00) >> 8;
+    data[1023] = (checksum & 0xff);
+
+    return data;
+}
+
+/**
+ * Generates a roboRIO reply to the given \a request. The reply echoes the
+ * sequence number and control byte of the request, reports the code status
+ * and battery voltage, and carries either a CPU or a RAM usage tag.
+ */
+QByteArray SimulatedRobot::reply2015 (const QByteArray& request) {
+    if (request.size() < 6 || request.at (2) != 0x01)
+        return QByteArray();
+
+    QByteArray data;
+    DS_UByte control = request.at (3) & ~0x10;
+
+    /* Report a brownout if the battery is too low */
+    if (m_settings.voltage < BROWNOUT_VOLTAGE)
+        control |= 0x10;
+
+    /* Get voltage bytes */
+    int integer = static_cast<int> (m_settings.voltage);
+    int decimal = qRound ((m_settings.voltage - integer) * 255);
+
+    data.append (request.at (0));
+    data.append (request.at (1));
+    data.append (0x01);
+    data.append (control);
+    data.append (m_settings.hasCode ? 0x20 : 0x00);
+    data.append (qBound (0, integer, 255));
+    data.append (qBound (0, decimal, 255));
+    data.append (static_cast<char> (0x00));
+    data.append (extended2015());
+
+    Q_ASSERT (data.size() > FRC_2015_HEADER_SIZE);
+    return data;
+}
+
+/**
+ * Returns the extended data appended to the roboRIO reply. The CPU and RAM
+ * tags are sent in alternate packets, since the LibDS reads one tag per
+ * packet. The usage values are updated with a random walk.
+ */
+QByteArray SimulatedRobot::extended2015() {
+    QByteArray data;
+    std::uniform_int_distribution<int> step (-2, 2);
+
+    /* CPU usage: [size][0x05][count][padding][usage at offset 12] */
+    if (m_received % 2 == 0) {
+        m_cpuUsage = qBound (5, m_cpuUsage + step (m_random), 95);
+
+        data.append (0x0C);
+        data.append (0x05);
+        data.append (0x01);
+        data.append (QByteArray (9, 0x00));
+        data.append (m_cpuUsage);
+    }
+
+    /* RAM usage: [size][0x06][padding][usage at offset 5] */
+    else {
+        m_ramUsage = qBound (5, m_ramUsage + step (m_random), 95);
+
+        data.append (0x05);
+        data.append (0x06);
+        data.append (QByteArray (3, 0x00));
+        data.append (m_ramUsage);
+    }
+
+    return data;
+}
+
+/**
+ * Returns the delay (in milliseconds) applied to the next reply
+ */
+int SimulatedRobot::replyDelay() {
+    if (m_settings.jitter <= 0)
+        return m_settings.delay;
+
+    std::uniform_int_distribution<int> jitter (-m_settings.jitter,
+                                               m_settings.jitter);
+
+    return qMax (0, m_settings.delay + jitter (m_random));
+}
+
+/**
+ * Returns \c true if the next reply should be dropped
+ */
+bool SimulatedRobot::dropReply() {
+    if (m_settings.loss <= 0)
+        return false;
+
+    std::uniform_real_distribution<qreal> chance (0, 100);
+    return chance (m_random) < m_settings.loss;
+}
+
+/**
+ * Sends the given reply \a data to the DS
+ */
+void SimulatedRobot::sendReply (const QByteArray& data,
+                                const QHostAddress& address,
+                                quint16 port) {
+    if (m_socket.writeDatagram (data, address, port) == data.size())
+        ++m_replied;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_SIMULATED_ROBOT_H
+#define _LIB_DS_SIMULATED_ROBOT_H
+
+#include <random>
+#include <QUdpSocket>
+#include <QElapsedTimer>
+#include <QHostAddress>
+
+/**
+ * \brief Emulates a roboRIO (2015/2016) or a cRIO (2014) robot controller
+ *
+ * The robot listens for DS packets on the configured address and port and
+ * replies to the DS with packets that report the sequence number, control
+ * mode, voltage, code status and (for the roboRIO) CPU and RAM usage.
+ *
+ * Each reply can be delayed, jittered or dropped, so that the behaviour of
+ * the DS can be tested under bad network conditions. The robot also keeps
+ * receive-rate statistics that are printed periodically by the simulator.
+ */
+class SimulatedRobot : public QObject {
+    Q_OBJECT
+
+  public:
+    struct Settings {
+        int protocol;
+        int inputPort;
+        int replyPort;
+        bool replyToSource;
+        QHostAddress address;
+
+        int delay;
+        int jitter;
+        qreal loss;
+
+        bool hasCode;
+        qreal voltage;
+        quint32 seed;
+    };
+
+    explicit SimulatedRobot (int id, const Settings& settings);
+
+    int id() const;
+    bool start();
+    QString statistics();
+
+  private slots:
+    void onDataReceived();
+
+  private:
+    QByteArray reply2014 (const QByteArray& request);
+    QByteArray reply2015 (const QByteArray& request);
+    QByteArray extended2015();
+
+    int replyDelay();
+    bool dropReply();
+    void sendReply (const QByteArray& data, const QHostAddress& address,
+                    quint16 port);
+
+  private:
+    int m_id;
+    Settings m_settings;
+    QUdpSocket m_socket;
+
+    int m_cpuUsage;
+    int m_ramUsage;
+
+    quint64 m_received;
+    quint64 m_replied;
+    quint64 m_dropped;
+    quint64 m_invalid;
+    quint64 m_sequenceGaps;
+    quint64 m_windowReceived;
+
+    int m_lastSequence;
+    qint64 m_lastArrival;
+    qint64 m_maxInterArrival;
+    qint64 m_windowStart;
+
+    QElapsedTimer m_clock;
+    std::mt19937 m_random;
+};
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include <stdio.h>
+#include <QTimer>
+#include <QDateTime>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include "SimulatedRobot.h"
+
+/**
+ * Returns the integer value of the given command line \a option
+ */
+static int INT_OPTION (const QCommandLineParser& parser, const QString& option) {
+    return parser.value (option).toInt();
+}
+
+int main (int argc, char* argv[]) {
+    QCoreApplication app (argc, argv);
+    app.setApplicationName ("LibDS Simulator");
+    app.setApplicationVersion ("1.0");
+
+    /* Define the command line options */
+    QCommandLineParser parser;
+    parser.setApplicationDescription ("Emulates several FRC robots, so that "
+                                      "the LibDS can be tested without "
+                                      "hardware");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions ({
+        {"robots",        "Number of simulated robots", "count", "1"},
+        {"protocol",      "Protocol year (2014, 2015 or 2016)", "year", "2016"},
+        {"address",       "Address of the first robot", "ip", "127.0.0.2"},
+        {"address-step",  "Address increment between robots", "n", "1"},
+        {"port",          "Port in which the first robot listens", "port", "1110"},
+        {"port-step",     "Port increment between robots", "n", "0"},
+        {"reply-port",    "Port of the DS that receives the replies", "port", "1150"},
+        {"reply-to-source", "Reply to the source port of each DS packet"},
+        {"delay",         "Reply delay in milliseconds", "msecs", "0"},
+        {"jitter",        "Maximum reply jitter in milliseconds", "msecs", "0"},
+        {"loss",          "Percentage of replies that are dropped", "percent", "0"},
+        {"voltage",       "Battery voltage reported by the robots", "volts", "12.43"},
+        {"no-code",       "Report that the robot code is not running"},
+        {"seed",          "Seed used for the delay, jitter and loss", "seed", "0"},
+        {"stats",         "Statistics interval in milliseconds (0 disables)", "msecs", "1000"},
+    });
+
+    parser.process (app);
+
+    /* Validate the protocol */
+    int protocol = INT_OPTION (parser, "protocol");
+    if (protocol != 2014 && protocol != 2015 && protocol != 2016) {
+        fprintf (stderr, "Unsupported protocol: %d\n", protocol);
+        return EXIT_FAILURE;
+    }
+
+    /* Validate the base address */
+    QHostAddress address (parser.value ("address"));
+    if (address.protocol() != QAbstractSocket::IPv4Protocol) {
+        fprintf (stderr, "Invalid IPv4 address: %s\n",
+                 qPrintable (parser.value ("address")));
+        return EXIT_FAILURE;
+    }
+
+    /* Get the common settings */
+    SimulatedRobot::Settings settings;
+    settings.protocol = protocol;
+    settings.replyPort = INT_OPTION (parser, "reply-port");
+    settings.replyToSource = parser.isSet ("reply-to-source");
+    settings.delay = INT_OPTION (parser, "delay");
+    settings.jitter = INT_OPTION (parser, "jitter");
+    settings.loss = parser.value ("loss").toDouble();
+    settings.voltage = parser.value ("voltage").toDouble();
+    settings.hasCode = !parser.isSet ("no-code");
+    settings.seed = parser.isSet ("seed") ?
+                    parser.value ("seed").toUInt() :
+                    static_cast<quint32> (QDateTime::currentMSecsSinceEpoch());
+
+    /* Create the robots */
+    QList<SimulatedRobot*> robots;
+    int count = qMax (INT_OPTION (parser, "robots"), 1);
+    for (int i = 0; i < count; ++i) {
+        quint32 ip = address.toIPv4Address();
+        settings.address = QHostAddress (ip + i * INT_OPTION (parser,
+                                                              "address-step"));
+        settings.inputPort = INT_OPTION (parser, "port")
+                             + i * INT_OPTION (parser, "port-step");
+
+        SimulatedRobot* robot = new SimulatedRobot (i, settings);
+        if (!robot->start())
+            return EXIT_FAILURE;
+
+        robots.append (robot);
+    }
+
+    fprintf (stdout, "Simulating %d FRC %d robot(s)\n", count, protocol);
+    fflush (stdout);
+
+    /* Print the statistics periodically */
+    QTimer stats;
+    QObject::connect (&stats, &QTimer::timeout, [&robots]() {
+        foreach (SimulatedRobot* robot, robots)
+            fprintf (stdout, "%s\n", qPrintable (robot->statistics()));
+
+        fprintf (stdout, "\n");
+        fflush (stdout);
+    });
+
+    if (INT_OPTION (parser, "stats") > 0)
+        stats.start (INT_OPTION (parser, "stats"));
+
+    return app.exec();
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "ControlDecoder.h"
+
+/**
+ * Reads a big endian 16-bit value from the given \a data
+ */
+static quint16 READ_16 (const char* data) {
+    return (quint16 (quint8 (data [0])) << 8) | quint8 (data [1]);
+}
+
+/**
+ * Reads a big endian 32-bit value from the given \a data
+ */
+static quint32 READ_32 (const char* data) {
+    return (quint32 (READ_16 (data)) << 16) | READ_16 (data + 2);
+}
+
+/**
+ * Appends the given 16-bit \a value to the \a data in big endian order
+ */
+static void WRITE_16 (QByteArray* data, quint16 value) {
+    data->append ((char) ((value >> 8) & 0xff));
+    data->append ((char) (value & 0xff));
+}
+
+ControlDecoder::ControlDecoder() {
+    reset();
+}
+
+/**
+ * Returns \c true if an unknown opcode was received. No more commands are
+ * decoded until the decoder is reset.
+ */
+bool ControlDecoder::hasError() const {
+    return m_error;
+}
+
+/**
+ * Returns the number of received bytes that have not been decoded yet
+ */
+int ControlDecoder::bufferedBytes() const {
+    return m_buffer.size() - m_start;
+}
+
+/**
+ * Discards the buffered data and clears the error flag
+ */
+void ControlDecoder::reset() {
+    m_start = 0;
+    m_error = false;
+    m_buffer.resize (0);
+}
+
+/**
+ * Decodes the next complete command into \a command.
+ *
+ * Returns \c false if no complete command is buffered or if the stream
+ * contains an unknown opcode
+ */
+bool ControlDecoder::next (Command* command) {
+    if (m_error || !command || bufferedBytes() < 1)
+        return false;
+
+    const char* data = m_buffer.constData() + m_start;
+    int opcode = quint8 (data [0]);
+    int size = payloadSize (opcode);
+
+    if (size < 0) {
+        m_error = true;
+        return false;
+    }
+
+    if (bufferedBytes() < 1 + size)
+        return false;
+
+    data += 1;
+    command->opcode = opcode;
+    command->value = 0;
+
+    switch (opcode) {
+    case kControlMode:
+    case kTeamStation:
+    case kProtocol:
+        command->value = quint8 (data [0]);
+        break;
+    case kTeam:
+        command->value = READ_16 (data);
+        break;
+    case kJoystick:
+        command->joystick = quint8 (data [0]);
+        data += 1;
+
+        for (int i = 0; i < JoystickStore::MAX_AXES; ++i)
+            command->axes [i] = (DS_SByte) data [i];
+        data += JoystickStore::MAX_AXES;
+
+        command->buttons = READ_32 (data);
+        data += 4;
+
+        for (int i = 0; i < JoystickStore::MAX_POVS; ++i, data += 2)
+            command->povs [i] = (qint16) READ_16 (data);
+        break;
+    default:
+        break;
+    }
+
+    m_start += 1 + size;
+    if (m_start == m_buffer.size()) {
+        m_start = 0;
+        m_buffer.resize (0);
+    }
+
+    return true;
+}
+
+/**
+ * Buffers the given \a length bytes of received \a data
+ */
+void ControlDecoder::append (const char* data, int length) {
+    if (m_start > 0) {
+        m_buffer.remove (0, m_start);
+        m_start = 0;
+    }
+
+    m_buffer.append (data, length);
+}
+
+/**
+ * Returns the payload size of the given \a opcode, or \c -1 if the opcode
+ * is unknown
+ */
+int ControlDecoder::payloadSize (int opcode) {
+    switch (opcode) {
+    case kEnable:
+    case kDisable:
+    case kEmergencyStop:
+        return 0;
+    case kControlMode:
+    case kTeamStation:
+    case kProtocol:
+        return 1;
+    case kTeam:
+        return 2;
+    case kJoystick:
+        return JOYSTICK_PAYLOAD_SIZE;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * Returns the wire representation of the given \a command, or an empty
+ * array if its opcode is unknown
+ */
+QByteArray ControlDecoder::encode (const Command& command) {
+    QByteArray data;
+    int size = payloadSize (command.opcode);
+    if (size < 0)
+        return data;
+
+    data.reserve (1 + size);
+    data.append ((char) command.opcode);
+
+    switch (command.opcode) {
+    case kControlMode:
+    case kTeamStation:
+    case kProtocol:
+        data.append ((char) command.value);
+        break;
+    case kTeam:
+        WRITE_16 (&data, command.value);
+        break;
+    case kJoystick:
+        data.append ((char) command.joystick);
+        for (int i = 0; i < JoystickStore::MAX_AXES; ++i)
+            data.append ((char) command.axes [i]);
+
+        WRITE_16 (&data, command.buttons >> 16);
+        WRITE_16 (&data, command.buttons & 0xffff);
+
+        for (int i = 0; i < JoystickStore::MAX_POVS; ++i)
+            WRITE_16 (&data, command.povs [i]);
+        break;
+    default:
+        break;
+    }
+
+    return data;
+}
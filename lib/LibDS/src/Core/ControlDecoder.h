@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_CONTROL_DECODER_H
+#define _LIB_DS_CONTROL_DECODER_H
+
+#include <Core/JoystickStore.h>
+
+/**
+ * \brief Encodes and decodes the commands of the local control protocol
+ *
+ * Every command is made of a one-byte opcode followed by a payload whose
+ * size is fixed by the opcode, so commands need no length prefix and can be
+ * decoded without copying or allocating memory. Multi-byte values are sent
+ * in big endian order:
+ *
+ * - \c kEnable, \c kDisable and \c kEmergencyStop have no payload
+ * - \c kControlMode, \c kTeamStation and \c kProtocol carry one byte with the
+ *   numeric value of the equivalent \c DriverStation enum
+ * - \c kTeam carries the team number (16 bits)
+ * - \c kJoystick carries a complete joystick frame: the joystick index
+ *   (8 bits), every quantized axis (8 bits each, signed), the button word
+ *   (32 bits, bit N is button N) and every POV angle (16 bits each, signed)
+ *
+ * Clients can write any number of commands at once (e.g. a frame for every
+ * joystick), the decoder returns them one at a time.
+ *
+ * An unknown opcode makes the stream impossible to resynchronize, so the
+ * decoder stops and reports an error.
+ */
+class ControlDecoder {
+  public:
+    explicit ControlDecoder();
+
+    enum Opcode {
+        kEnable        = 0x01,
+        kDisable       = 0x02,
+        kEmergencyStop = 0x03,
+        kControlMode   = 0x04,
+        kTeamStation   = 0x05,
+        kProtocol      = 0x06,
+        kTeam          = 0x07,
+        kJoystick      = 0x08,
+    };
+
+    static const int JOYSTICK_PAYLOAD_SIZE = 1 + JoystickStore::MAX_AXES + 4
+                                             + 2 * JoystickStore::MAX_POVS;
+
+    struct Command {
+        int opcode;   /**< Opcode of the command */
+        int value;    /**< Payload of non-joystick commands */
+        int joystick; /**< Index of the joystick */
+        DS_SByte axes [JoystickStore::MAX_AXES]; /**< Quantized axes */
+        quint32 buttons;                         /**< Button word */
+        qint16 povs [JoystickStore::MAX_POVS];   /**< POV angles */
+    };
+
+    bool hasError() const;
+    int bufferedBytes() const;
+
+    void reset();
+    bool next (Command* command);
+    void append (const char* data, int length);
+
+    static int payloadSize (int opcode);
+    static QByteArray encode (const Command& command);
+
+  private:
+    bool m_error;
+    int m_start;
+    QByteArray m_buffer;
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "ControlServer.h"
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <DriverStation.h>
+
+/* Size of the chunks read from the client sockets */
+const int READ_CHUNK_SIZE = 4096;
+
+ControlServer::ControlServer (DriverStation* ds, QObject* parent) :
+    QObject (parent) {
+    m_ds = ds;
+    m_applied = 0;
+    m_ignored = 0;
+    m_server = Q_NULLPTR;
+}
+
+/**
+ * Stops listening for commands and disconnects the clients
+ */
+ControlServer::~ControlServer() {
+    close();
+}
+
+/**
+ * Returns \c true if the server is listening for clients
+ */
+bool ControlServer::isListening() const {
+    return m_server && m_server->isListening();
+}
+
+/**
+ * Returns the number of commands that were applied to the DS
+ */
+quint64 ControlServer::appliedCommands() const {
+    return m_applied;
+}
+
+/**
+ * Returns the number of commands that were ignored because of an invalid
+ * value
+ */
+quint64 ControlServer::ignoredCommands() const {
+    return m_ignored;
+}
+
+/**
+ * Applies the given \a command to the DS
+ */
+void ControlServer::apply (const ControlDecoder::Command& command) {
+    if (!m_ds)
+        return;
+
+    bool valid = true;
+
+    switch (command.opcode) {
+    case ControlDecoder::kEnable:
+        m_ds->enableRobot();
+        break;
+    case ControlDecoder::kDisable:
+        m_ds->disableRobot();
+        break;
+    case ControlDecoder::kEmergencyStop:
+        m_ds->triggerEmergencyStop();
+        break;
+    case ControlDecoder::kControlMode:
+        valid = command.value <= DS::kControlTeleoperated;
+        if (valid)
+            m_ds->setControlMode ((DS::ControlMode) command.value);
+        break;
+    case ControlDecoder::kTeamStation:
+        valid = command.value <= DriverStation::kBlue3;
+        if (valid)
+            m_ds->setTeamStation (command.value);
+        break;
+    case ControlDecoder::kProtocol:
+        valid = command.value <= DriverStation::kFRC2014;
+        if (valid)
+            m_ds->setProtocolType (command.value);
+        break;
+    case ControlDecoder::kTeam:
+        m_ds->setTeam (command.value);
+        break;
+    case ControlDecoder::kJoystick:
+        valid = command.joystick < m_ds->joystickStore()->count();
+        if (valid)
+            m_ds->joystickStore()->setJoystick (command.joystick,
+                                                command.axes,
+                                                command.buttons,
+                                                command.povs);
+        break;
+    default:
+        valid = false;
+        break;
+    }
+
+    if (valid)
+        ++m_applied;
+    else
+        ++m_ignored;
+}
+
+/**
+ * Stops listening for commands and disconnects the clients
+ */
+void ControlServer::close() {
+    foreach (QLocalSocket* socket, m_decoders.keys()) {
+        socket->disconnect (this);
+        socket->abort();
+        socket->deleteLater();
+    }
+
+    qDeleteAll (m_decoders);
+    m_decoders.clear();
+
+    if (m_server) {
+        m_server->close();
+        m_server->deleteLater();
+        m_server = Q_NULLPTR;
+    }
+}
+
+/**
+ * Listens for commands on the local socket with the given \a name (a Unix
+ * domain socket or a named pipe, depending on the operating system).
+ * Returns \c false if the socket cannot be created.
+ */
+bool ControlServer::listen (const QString& name) {
+    close();
+
+    m_server = new QLocalServer (this);
+    m_server->setSocketOptions (QLocalServer::UserAccessOption);
+    connect (m_server, SIGNAL (newConnection()),
+             this,       SLOT (onNewConnection()));
+
+    QLocalServer::removeServer (name);
+    if (!m_server->listen (name)) {
+        qWarning() << "Cannot listen for commands on" << name
+                   << m_server->errorString();
+        return false;
+    }
+
+    qDebug() << "Listening for commands on" << m_server->fullServerName();
+    return true;
+}
+
+/**
+ * Creates a decoder for each new client
+ */
+void ControlServer::onNewConnection() {
+    while (m_server && m_server->hasPendingConnections()) {
+        QLocalSocket* socket = m_server->nextPendingConnection();
+        m_decoders.insert (socket, new ControlDecoder);
+
+        connect (socket, SIGNAL (readyRead()),    this, SLOT (onReadyRead()));
+        connect (socket, SIGNAL (disconnected()), this, SLOT (onDisconnected()));
+    }
+}
+
+/**
+ * Decodes and applies the commands received from a client. Clients that
+ * send an unknown opcode are disconnected.
+ */
+void ControlServer::onReadyRead() {
+    QLocalSocket* socket = qobject_cast<QLocalSocket*> (sender());
+    ControlDecoder* decoder = m_decoders.value (socket);
+    if (!socket || !decoder)
+        return;
+
+    char chunk [READ_CHUNK_SIZE];
+    ControlDecoder::Command command;
+
+    qint64 bytes;
+    while ((bytes = socket->read (chunk, sizeof (chunk))) > 0) {
+        decoder->append (chunk, bytes);
+        while (decoder->next (&command))
+            apply (command);
+    }
+
+    if (decoder->hasError()) {
+        qWarning() << "Invalid control command, closing connection";
+        socket->disconnectFromServer();
+    }
+}
+
+/**
+ * Releases the decoder of a disconnected client
+ */
+void ControlServer::onDisconnected() {
+    QLocalSocket* socket = qobject_cast<QLocalSocket*> (sender());
+    if (socket) {
+        delete m_decoders.take (socket);
+        socket->deleteLater();
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_CONTROL_SERVER_H
+#define _LIB_DS_CONTROL_SERVER_H
+
+#include <QHash>
+#include <Core/ControlDecoder.h>
+
+class DriverStation;
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * \brief Lets local processes drive the DS with a compact binary protocol
+ *
+ * The server listens on a local (Unix domain) socket and applies the
+ * commands decoded by a \c ControlDecoder directly to the DS: joystick
+ * frames are written into the joystick store with a single write and the
+ * other commands call the equivalent \c DriverStation slot. This allows
+ * test harnesses and automation tools to send hundreds of commands per
+ * second without going through QML.
+ *
+ * Values outside of the range of their enums are ignored. Clients that send
+ * an unknown opcode are disconnected.
+ *
+ * \note The socket is only accessible by the user that runs the DS
+ */
+class ControlServer : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit ControlServer (DriverStation* ds, QObject* parent = Q_NULLPTR);
+    ~ControlServer();
+
+    bool isListening() const;
+    quint64 appliedCommands() const;
+    quint64 ignoredCommands() const;
+
+    void apply (const ControlDecoder::Command& command);
+
+  public slots:
+    void close();
+    bool listen (const QString& name);
+
+  private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+  private:
+    DriverStation* m_ds;
+    QLocalServer* m_server;
+    quint64 m_applied;
+    quint64 m_ignored;
+    QHash<QLocalSocket*, ControlDecoder*> m_decoders;
+};
+
+#endif
@@ -26,6 +26,12 @@
 #include <QHostAddress>
 #include <QJsonDocument>
 
+//------------------------------------------------------------------------------
+// LibDS includes
+//------------------------------------------------------------------------------
+
+#include <Utilities/Clock.h>
+
 //------------------------------------------------------------------------------
 // Hacks to make the code more readable
 //------------------------------------------------------------------------------
@@ -35,7 +41,7 @@
 #define DS_Joysticks QList<DS::Joystick*>
 
 #define DS_Schedule(time,object,slot) \
-    QTimer::singleShot (time, Qt::PreciseTimer, object, slot)
+    Clock::getInstance()->schedule (time, object, slot)
 
 //------------------------------------------------------------------------------
 // Display name of enum instead of numerical value
@@ -68,6 +74,7 @@ class DS : public QObject {
     Q_ENUMS (Alliance)
     Q_ENUMS (Position)
     Q_ENUMS (SocketType)
+    Q_ENUMS (SocketProfile)
     Q_ENUMS (CodeStatus)
     Q_ENUMS (CommStatus)
     Q_ENUMS (ControlMode)
@@ -160,13 +167,22 @@ class DS : public QObject {
     };
     SMART_ENUM (SocketType)
 
+    /**
+     * \brief Represents the tuning profiles that can be applied to the sockets
+     *        used by the DS modules
+     */
+    enum SocketProfile {
+        kSocketProfileDefault,    /**< Use the operating system defaults */
+        kSocketProfileLowLatency, /**< Tune buffers, QoS & polling for latency */
+    };
+    SMART_ENUM (SocketProfile)
+
     /**
      * \brief Represents a joystick and its respective properties
+     *
+     * \note The values of the joystick are kept by the \c JoystickStore
      */
     struct Joystick {
-        int* povs;              /**< Holds the POV angles array */
-        qreal* axes;            /**< Holds the axis values array */
-        bool* buttons;          /**< Holds the button states array */
         int numAxes = 0;        /**< Holds the number of axes used by the DS */
         int numPOVs = 0;        /**< Holds the number of POVs used by the DS */
         int numButtons = 0;     /**< Holds the number of buttons used by the DS */
@@ -214,7 +230,7 @@ class DS : public QObject {
      * \brief Returns the current timezone as a string
      */
     static inline QString timezone() {
-        switch (QDateTime::currentDateTime().offsetFromUtc() / 3600) {
+        switch (Clock::getInstance()->currentDateTime().offsetFromUtc() / 3600) {
         case -11:
             return "BST11BDT";
             break;
@@ -322,6 +338,7 @@ class DS : public QObject {
 Q_DECLARE_METATYPE (DS::Alliance)
 Q_DECLARE_METATYPE (DS::Position)
 Q_DECLARE_METATYPE (DS::SocketType)
+Q_DECLARE_METATYPE (DS::SocketProfile)
 Q_DECLARE_METATYPE (DS::CodeStatus)
 Q_DECLARE_METATYPE (DS::CommStatus)
 Q_DECLARE_METATYPE (DS::ControlMode)
@@ -10,12 +10,14 @@
 #include "DriverStation.h"
 
 #include <QThread>
-#include <QElapsedTimer>
 #include <Core/Logger.h>
+#include <Utilities/StageTimers.h>
 
-DS_Config::DS_Config() {
-    m_timer = new QElapsedTimer;
-    m_logger = new Logger;
+DS_Config::DS_Config (const QString& name,
+                      QThread* loggerThread,
+                      bool externalClock) {
+    m_logger = new Logger (name);
+    m_driverStation = Q_NULLPTR;
 
     m_team = 0;
     m_voltage = 0;
@@ -26,7 +28,9 @@ DS_Config::DS_Config() {
     m_pcmVersion = "";
     m_pdpVersion = "";
     m_simulated = false;
+    m_timerStart = 0;
     m_timerEnabled = false;
+    m_externalClock = externalClock;
     m_position = kPosition1;
     m_alliance = kAllianceRed;
     m_codeStatus = kCodeFailing;
@@ -38,13 +42,36 @@ DS_Config::DS_Config() {
     m_robotCommStatus = kCommsFailing;
     m_controlMode = kControlTeleoperated;
 
-    /* Move the robot logger to another thread */
-    QThread* thread = new QThread (this);
-    m_logger->moveToThread (thread);
-    thread->start (QThread::NormalPriority);
+    /* Move the robot logger to another (or the given) thread */
+    m_loggerThread = loggerThread;
+    m_ownsLoggerThread = (loggerThread == Q_NULLPTR);
+    if (m_ownsLoggerThread) {
+        m_loggerThread = new QThread (this);
+        m_loggerThread->start (QThread::NormalPriority);
+    }
+
+    m_logger->setEvents (m_events.subscribe (Logger::EVENTS, m_logger,
+                                             "processEvents()"));
+    m_logger->moveToThread (m_loggerThread);
+}
+
+/**
+ * Stops the logger thread (if we own it) and deletes the logger
+ */
+DS_Config::~DS_Config() {
+    m_events.clear();
+
+    if (m_ownsLoggerThread) {
+        m_loggerThread->quit();
+        m_loggerThread->wait();
+        delete m_logger;
+    }
 
-    /* Begin elapsed time loop */
-    updateElapsedTime();
+    else if (m_logger->thread() == QThread::currentThread())
+        delete m_logger;
+
+    else
+        m_logger->deleteLater();
 }
 
 /**
@@ -54,6 +81,40 @@ Logger* DS_Config::logger() {
     return m_logger;
 }
 
+/**
+ * Returns the bus on which the state changes are published
+ */
+EventBus* DS_Config::events() {
+    return &m_events;
+}
+
+/**
+ * Returns the \c DriverStation that owns this configuration. If no
+ * \c DriverStation has been assigned, the global instance is returned.
+ */
+DriverStation* DS_Config::driverStation() const {
+    if (m_driverStation)
+        return m_driverStation;
+
+    return DriverStation::getInstance();
+}
+
+/**
+ * Returns \c true if the timed operations of this configuration (and its
+ * \c DriverStation) are driven by an external clock (e.g. a \c Fleet tick)
+ * instead of their own timers.
+ */
+bool DS_Config::externalClock() const {
+    return m_externalClock;
+}
+
+/**
+ * Changes the \c DriverStation that owns this configuration
+ */
+void DS_Config::setDriverStation (DriverStation* driverStation) {
+    m_driverStation = driverStation;
+}
+
 /**
  * Returns the one and only instance of
  */
@@ -254,9 +315,12 @@ DS::OperationStatus DS_Config::operationStatus() const {
  * Changes the \a team number and fires the appropriate signals if required
  */
 void DS_Config::updateTeam (int team) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_team != team) {
         m_team = team;
-        emit teamChanged (m_team);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kTeam, m_team);
 
         qDebug() << "Team number set to" << team;
     }
@@ -287,24 +351,39 @@ void DS_Config::setEnabled (bool enabled) {
  * Changes the CPU \a usage and fires the appropriate signals if required
  */
 void DS_Config::updateCpuUsage (int usage) {
-    m_cpuUsage = 0;
-    emit cpuUsageChanged (usage);
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
+    if (m_cpuUsage != usage) {
+        m_cpuUsage = usage;
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kCpuUsage, usage);
+    }
 }
 
 /**
  * Changes the RAM \a usage and fires the appropriate signals if required
  */
 void DS_Config::updateRamUsage (int usage) {
-    m_ramUsage = 0;
-    emit ramUsageChanged (usage);
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
+    if (m_ramUsage != usage) {
+        m_ramUsage = usage;
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kRamUsage, usage);
+    }
 }
 
 /**
  * Changes the disk \a usage and fires the appropriate signals if required
  */
 void DS_Config::updateDiskUsage (int usage) {
-    m_diskUsage = 0;
-    emit diskUsageChanged (usage);
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
+    if (m_diskUsage != usage) {
+        m_diskUsage = usage;
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kDiskUsage, usage);
+    }
 }
 
 /**
@@ -332,31 +411,20 @@ void DS_Config::setEmergencyStop (bool estop) {
  * Changes the robot \a voltage and fires the appropriate signals if required
  */
 void DS_Config::updateVoltage (qreal voltage) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     /* Round voltage to two decimal places */
-    m_voltage = roundf (voltage * 100) / 100;
+    qreal rounded = roundf (voltage * 100) / 100;
 
     /* Avoid this: http://i.imgur.com/iAAi1bX.png */
-    if (m_voltage > DriverStation::getInstance()->maxBatteryVoltage())
-        m_voltage = DriverStation::getInstance()->maxBatteryVoltage();
-
-    /* Separate voltage into natural and decimal numbers */
-    int integer = static_cast<int> (m_voltage);
-    int decimal = static_cast<qreal> (m_voltage - integer) * 100;
-
-    /* Convert the obtained numbers into strings */
-    QString integer_str = QString::number (integer);
-    QString decimal_str = QString::number (decimal);
+    if (rounded > driverStation()->maxBatteryVoltage())
+        rounded = driverStation()->maxBatteryVoltage();
 
-    /* Prepend a 0 to the decimal numbers if required */
-    if (decimal < 10)
-        decimal_str.prepend ("0");
-
-    /* Emit signals */
-    emit voltageChanged (m_voltage);
-    emit voltageChanged (integer_str + "." + decimal_str + " V");
-
-    /* Log robot voltage */
-    m_logger->registerVoltage (m_voltage);
+    if (m_voltage != rounded) {
+        m_voltage = rounded;
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kVoltage, m_voltage);
+    }
 }
 
 /**
@@ -364,32 +432,39 @@ void DS_Config::updateVoltage (qreal voltage) {
  * required
  */
 void DS_Config::updateSimulated (bool simulated) {
-    m_simulated = simulated;
-    emit simulatedChanged (simulated);
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
+    if (m_simulated != simulated) {
+        m_simulated = simulated;
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kSimulated, simulated);
+    }
 }
 
 /**
  * Changes the \a alliance and fires the appropriate signals if required
  */
 void DS_Config::updateAlliance (Alliance alliance) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_alliance != alliance) {
         m_alliance = alliance;
-        m_logger->registerAlliance (alliance);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kAlliance, m_alliance);
     }
-
-    emit allianceChanged (m_alliance);
 }
 
 /**
  * Changes the \a position and fires the appropriate signals if required
  */
 void DS_Config::updatePosition (Position position) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_position != position) {
         m_position = position;
-        m_logger->registerPosition (position);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kPosition, m_position);
     }
-
-    emit positionChanged (m_position);
 }
 
 /**
@@ -397,13 +472,13 @@ void DS_Config::updatePosition (Position position) {
  * required
  */
 void DS_Config::updateRobotCodeStatus (CodeStatus status) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_codeStatus != status) {
         m_codeStatus = status;
-        m_logger->registerCodeStatus (status);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kCodeStatus, m_codeStatus);
     }
-
-    emit codeStatusChanged (m_codeStatus);
-    emit statusChanged (DriverStation::getInstance()->generalStatus());
 }
 
 /**
@@ -411,13 +486,13 @@ void DS_Config::updateRobotCodeStatus (CodeStatus status) {
  * required
  */
 void DS_Config::updateControlMode (ControlMode mode) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_controlMode != mode) {
         m_controlMode = mode;
-        m_logger->registerControlMode (mode);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kControlMode, m_controlMode);
     }
-
-    emit controlModeChanged (m_controlMode);
-    emit statusChanged (DriverStation::getInstance()->generalStatus());
 }
 
 /**
@@ -425,58 +500,67 @@ void DS_Config::updateControlMode (ControlMode mode) {
  * required
  */
 void DS_Config::updateLibVersion (const QString& version) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_libVersion != version) {
         m_libVersion = version;
         qDebug() << "LIB version set to" << version;
-    }
 
-    emit libVersionChanged (m_libVersion);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kLibVersion);
+    }
 }
 
 /**
  * Changes the PCM \a version and fires the appropriate signals if required
  */
 void DS_Config::updatePcmVersion (const QString& version) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_pcmVersion != version) {
         m_pcmVersion = version;
         qDebug() << "PCM version set to" << version;
-    }
 
-    emit pcmVersionChanged (m_pcmVersion);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kPcmVersion);
+    }
 }
 
 /**
  * Changes the PDP/PDB \a version and fires the appropriate signals if required
  */
 void DS_Config::updatePdpVersion (const QString& version) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_pdpVersion != version) {
         m_pdpVersion = version;
         qDebug() << "PDP version set to" << version;
-    }
 
-    emit pdpVersionChanged (m_pdpVersion);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kPdpVersion);
+    }
 }
 
 /**
  * Changes the enabled \a status and fires the appropriate signals if required
  */
 void DS_Config::updateEnabled (EnableStatus status) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_enableStatus != status) {
         m_enableStatus = status;
 
         if (status == DS::kEnabled) {
-            m_timer->restart();
+            m_timerStart = Clock::getInstance()->elapsed();
             m_timerEnabled = true;
         }
 
         else
             m_timerEnabled = false;
 
-        m_logger->registerEnableStatus (status);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kEnableStatus, m_enableStatus);
     }
-
-    emit enabledChanged (m_enableStatus);
-    emit statusChanged (DriverStation::getInstance()->generalStatus());
 }
 
 /**
@@ -484,13 +568,15 @@ void DS_Config::updateEnabled (EnableStatus status) {
  * if required
  */
 void DS_Config::updateFMSCommStatus (CommStatus status) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_fmsCommStatus != status) {
         m_fmsCommStatus = status;
         qDebug() << "FMS comm. status set to" << status;
-    }
 
-    emit fmsCommStatusChanged (m_fmsCommStatus);
-    emit statusChanged (DriverStation::getInstance()->generalStatus());
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kFMSCommStatus, m_fmsCommStatus);
+    }
 }
 
 /**
@@ -498,12 +584,13 @@ void DS_Config::updateFMSCommStatus (CommStatus status) {
  * if required
  */
 void DS_Config::updateRadioCommStatus (CommStatus status) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_radioCommStatus != status) {
         m_radioCommStatus = status;
-        m_logger->registerRadioCommStatus (status);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kRadioCommStatus, m_radioCommStatus);
     }
-
-    emit radioCommStatusChanged (m_radioCommStatus);
 }
 
 /**
@@ -511,13 +598,13 @@ void DS_Config::updateRadioCommStatus (CommStatus status) {
  * if required
  */
 void DS_Config::updateRobotCommStatus (CommStatus status) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_robotCommStatus != status) {
         m_robotCommStatus = status;
-        m_logger->registerRobotCommStatus (status);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kRobotCommStatus, m_robotCommStatus);
     }
-
-    emit robotCommStatusChanged (m_robotCommStatus);
-    emit statusChanged (DriverStation::getInstance()->generalStatus());
 }
 
 /**
@@ -525,14 +612,13 @@ void DS_Config::updateRobotCommStatus (CommStatus status) {
  * if required
  */
 void DS_Config::updateVoltageStatus (VoltageStatus status) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_voltageStatus != status) {
         m_voltageStatus = status;
-        m_logger->registerVoltageStatus (status);
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kVoltageStatus, m_voltageStatus);
     }
-
-    emit voltageStatusChanged (m_voltageStatus);
-    emit statusChanged (DriverStation::getInstance()->generalStatus());
-
 }
 
 /**
@@ -540,21 +626,22 @@ void DS_Config::updateVoltageStatus (VoltageStatus status) {
  * if required
  */
 void DS_Config::updateOperationStatus (OperationStatus status) {
+    StageTimers::Scope timer (StageTimers::kConfigUpdates);
+
     if (m_operationStatus != status) {
         m_operationStatus = status;
         updateEnabled (DS::kDisabled);
-        m_logger->registerOperationStatus (status);
-    }
 
-    emit operationStatusChanged (m_operationStatus);
-    emit statusChanged (DriverStation::getInstance()->generalStatus());
+        StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        m_events.publish (EventBus::kOperationStatus, m_operationStatus);
+    }
 }
 
 /**
  * Calculates the elapsed time since the robot has been enabled (regardless of
  * the operation mode).
  *
- * This function is called every 100 milliseconds.
+ * This function is called every 100 milliseconds by the \c DriverStation.
  *
  * \note This function will not run if there is no communication status with
  *       the robot or if the robot is emergency stopped
@@ -562,20 +649,7 @@ void DS_Config::updateOperationStatus (OperationStatus status) {
  *       mode of the robot
  */
 void DS_Config::updateElapsedTime() {
-    if (m_timerEnabled && isConnectedToRobot() && !isEmergencyStopped()) {
-        quint32 msec = m_timer->elapsed();
-        quint32 secs = (msec / 1000);
-        quint32 mins = (secs / 60) % 60;
-
-        secs = secs % 60;
-        msec = msec % 1000;
-
-        emit elapsedTimeChanged (msec);
-        emit elapsedTimeChanged (QString ("%1:%2.%3")
-                                 .arg (mins, 2, 10, QLatin1Char ('0'))
-                                 .arg (secs, 2, 10, QLatin1Char ('0'))
-                                 .arg (QString::number (msec).at (0)));
-    }
-
-    DS_Schedule (100, this, SLOT (updateElapsedTime()));
+    if (m_timerEnabled && isConnectedToRobot() && !isEmergencyStopped())
+        m_events.publish (EventBus::kElapsedTime,
+                          (int) (Clock::getInstance()->elapsed() - m_timerStart));
 }
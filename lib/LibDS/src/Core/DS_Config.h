@@ -10,9 +10,11 @@
 #define _LIB_DS_PRIVATE_CONFIG_H
 
 #include <Core/DS_Base.h>
+#include <Core/EventBus.h>
 
 class Logger;
-class QElapsedTimer;
+class QThread;
+class DriverStation;
 
 /**
  * \brief Updates the variables shared across the LibDS classes
@@ -27,6 +29,7 @@ class QElapsedTimer;
  */
 class DS_Config : public DS_Base {
     Q_OBJECT
+    friend class FleetScheduler;
     friend class DriverStation;
 
   public:
@@ -87,8 +90,16 @@ class DS_Config : public DS_Base {
     void updateElapsedTime();
 
   protected:
-    DS_Config();
+    explicit DS_Config (const QString& name = "",
+                        QThread* loggerThread = Q_NULLPTR,
+                        bool externalClock = false);
+    ~DS_Config();
+
     Logger* logger();
+    EventBus* events();
+    bool externalClock() const;
+    DriverStation* driverStation() const;
+    void setDriverStation (DriverStation* driverStation);
 
   private:
     int m_team;
@@ -113,9 +124,14 @@ class DS_Config : public DS_Base {
 
     bool m_simulated;
     bool m_timerEnabled;
+    bool m_externalClock;
+    bool m_ownsLoggerThread;
 
-    QElapsedTimer* m_timer;
+    qint64 m_timerStart;
+    EventBus m_events;
     Logger* m_logger;
+    QThread* m_loggerThread;
+    DriverStation* m_driverStation;
 };
 
 #endif
@@ -0,0 +1,693 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "EvdevInput.h"
+
+#include <QDir>
+#include <DriverStation.h>
+
+#if defined Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <linux/input.h>
+#endif
+
+/* Directory in which the kernel creates the evdev nodes */
+const QString INPUT_DIRECTORY = "/dev/input";
+
+/* Range of the axes of injected devices */
+const int INJECTED_AXIS_MIN = -32768;
+const int INJECTED_AXIS_MAX = 32767;
+
+/* Maximum number of hats (POVs) reported by evdev */
+const int MAX_HATS = 4;
+
+/* Epoll tags of the wake-up descriptor, inotify and the first device */
+const quint32 WAKE_TAG = 0;
+const quint32 INOTIFY_TAG = 1;
+const quint32 FIRST_DEVICE_TAG = 2;
+
+#if defined Q_OS_LINUX
+
+#define BITS_PER_LONG (sizeof (unsigned long) * 8)
+#define NBITS(x) (((x) - 1) / BITS_PER_LONG + 1)
+
+/**
+ * Holds the descriptor of a device and the maps from evdev codes to the
+ * axes, buttons and POVs registered with the DS
+ */
+struct EvdevInput::Device {
+    int fd;
+    int slot;
+    QString path;
+
+    int axes;
+    int povs;
+    int buttons;
+
+    int axisIndex [ABS_CNT];
+    int axisMin [ABS_CNT];
+    int axisMax [ABS_CNT];
+    int buttonIndex [KEY_CNT];
+
+    int hatX [MAX_HATS];
+    int hatY [MAX_HATS];
+    int hatIndex [MAX_HATS];
+};
+
+/**
+ * Returns \c true if the given \a bit is set in the \a bits array
+ */
+static bool TEST_BIT (const unsigned long* bits, int bit) {
+    return (bits [bit / BITS_PER_LONG] >> (bit % BITS_PER_LONG)) & 1;
+}
+
+/**
+ * Returns \c true if the given absolute axis \a code belongs to a hat
+ */
+static bool IS_HAT (int code) {
+    return code >= ABS_HAT0X && code <= ABS_HAT3Y;
+}
+
+/**
+ * Returns the POV angle of a hat with the given \a x and \a y directions,
+ * or \c -1 if the hat is centered
+ */
+static int POV_ANGLE (int x, int y) {
+    static const int angles [3][3] = {
+        /* y = -1, 0, 1 */
+        { 315, 270, 225 }, /* x = -1 */
+        {   0,  -1, 180 }, /* x =  0 */
+        {  45,  90, 135 }, /* x =  1 */
+    };
+
+    return angles [qBound (-1, x, 1) + 1][qBound (-1, y, 1) + 1];
+}
+
+/**
+ * Returns a new device with no axes, buttons or POVs
+ */
+static EvdevInput::Device* NEW_DEVICE (int fd, const QString& path) {
+    EvdevInput::Device* device = new EvdevInput::Device;
+
+    device->fd = fd;
+    device->slot = -1;
+    device->path = path;
+    device->axes = 0;
+    device->povs = 0;
+    device->buttons = 0;
+
+    for (int i = 0; i < ABS_CNT; ++i) {
+        device->axisIndex [i] = -1;
+        device->axisMin [i] = INJECTED_AXIS_MIN;
+        device->axisMax [i] = INJECTED_AXIS_MAX;
+    }
+
+    for (int i = 0; i < KEY_CNT; ++i)
+        device->buttonIndex [i] = -1;
+
+    for (int i = 0; i < MAX_HATS; ++i) {
+        device->hatX [i] = 0;
+        device->hatY [i] = 0;
+        device->hatIndex [i] = -1;
+    }
+
+    return device;
+}
+
+/**
+ * Maps the given button \a code to the next button of the \a device
+ */
+static void ADD_BUTTON (EvdevInput::Device* device, int code) {
+    if (device->buttons < JoystickStore::MAX_BUTTONS) {
+        device->buttonIndex [code] = device->buttons;
+        device->buttons += 1;
+    }
+}
+
+/**
+ * Queries the capabilities of the given \a device and builds its maps.
+ * Returns \c false if the device is not a joystick or gamepad.
+ */
+static bool PROBE_DEVICE (EvdevInput::Device* device) {
+    unsigned long absBits [NBITS (ABS_CNT)] = {0};
+    unsigned long keyBits [NBITS (KEY_CNT)] = {0};
+
+    if (ioctl (device->fd, EVIOCGBIT (EV_ABS, sizeof (absBits)), absBits) < 0)
+        return false;
+    if (ioctl (device->fd, EVIOCGBIT (EV_KEY, sizeof (keyBits)), keyBits) < 0)
+        return false;
+
+    /* Ignore keyboards, mice and touchpads */
+    if (!TEST_BIT (keyBits, BTN_JOYSTICK) && !TEST_BIT (keyBits, BTN_GAMEPAD))
+        return false;
+
+    /* Map buttons, joystick buttons first */
+    for (int code = BTN_JOYSTICK; code < KEY_CNT; ++code) {
+        if (TEST_BIT (keyBits, code))
+            ADD_BUTTON (device, code);
+    }
+    for (int code = BTN_MISC; code < BTN_JOYSTICK; ++code) {
+        if (TEST_BIT (keyBits, code))
+            ADD_BUTTON (device, code);
+    }
+
+    /* Map axes and hats */
+    for (int code = 0; code < ABS_MISC; ++code) {
+        if (!TEST_BIT (absBits, code))
+            continue;
+
+        if (IS_HAT (code)) {
+            int hat = (code - ABS_HAT0X) / 2;
+            if (device->hatIndex [hat] < 0) {
+                device->hatIndex [hat] = device->povs;
+                device->povs += 1;
+            }
+        }
+
+        else if (device->axes < JoystickStore::MAX_AXES) {
+            struct input_absinfo info;
+            if (ioctl (device->fd, EVIOCGABS (code), &info) < 0)
+                continue;
+
+            device->axisIndex [code] = device->axes;
+            device->axisMin [code] = info.minimum;
+            device->axisMax [code] = info.maximum;
+            device->axes += 1;
+        }
+    }
+
+    return true;
+}
+
+#else
+
+struct EvdevInput::Device {
+    int fd;
+    int slot;
+};
+
+#endif
+
+EvdevInput::EvdevInput (DriverStation* driverStation, QObject* parent) :
+    QThread (parent) {
+    m_epoll = -1;
+    m_wakeFd = -1;
+    m_inotify = -1;
+    m_autoDetect = true;
+
+    m_driverStation = driverStation;
+    m_store = driverStation->joystickStore();
+
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        m_devices [i] = Q_NULLPTR;
+        m_slotsInUse [i].storeRelease (0);
+        m_joystickIds [i].storeRelease (-1);
+    }
+
+#if defined Q_OS_LINUX
+    m_wakeFd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+
+    connect (this, SIGNAL (deviceAttached (int, int, int, int)),
+             this,   SLOT (registerDevice (int, int, int, int)),
+             Qt::QueuedConnection);
+    connect (this, SIGNAL (deviceDetached (int)),
+             this,   SLOT (unregisterDevice (int)),
+             Qt::QueuedConnection);
+
+    /* Both signals are emitted by the same removal, in our thread */
+    connect (driverStation, SIGNAL (joystickAboutToBeRemoved (int)),
+             this,            SLOT (lockJoystickIds()),
+             Qt::DirectConnection);
+    connect (driverStation, SIGNAL (joystickRemoved (int)),
+             this,            SLOT (remapJoystickIds (int)),
+             Qt::DirectConnection);
+}
+
+EvdevInput::~EvdevInput() {
+    stop();
+
+#if defined Q_OS_LINUX
+    foreach (Device* device, m_pendingDevices) {
+        close (device->fd);
+        delete device;
+    }
+
+    if (m_wakeFd != -1)
+        close (m_wakeFd);
+#endif
+}
+
+/**
+ * Returns \c true if the input thread opens the devices at \c /dev/input
+ * and watches the directory for new devices
+ */
+bool EvdevInput::autoDetect() const {
+    return m_autoDetect;
+}
+
+/**
+ * Returns the ID of the DS joystick that is fed by the device at the given
+ * \a slot, or \c -1 if the slot is empty or the device is not registered yet
+ */
+int EvdevInput::joystickId (int slot) const {
+    if (slot >= 0 && slot < MAX_DEVICES)
+        return m_joystickIds [slot].loadAcquire();
+
+    return -1;
+}
+
+/**
+ * Stops the input thread, closes every device and removes its joystick
+ * from the DS
+ */
+void EvdevInput::stop() {
+    if (isRunning()) {
+        m_quit.storeRelease (1);
+        wake();
+        wait();
+    }
+
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        if (m_slotsInUse [i].loadAcquire())
+            unregisterDevice (i);
+    }
+
+    m_quit.storeRelease (0);
+}
+
+/**
+ * If \a enabled is set to \c true, the input thread will open the devices
+ * at \c /dev/input and watch for new devices.
+ *
+ * \note This setting is applied when the thread is started
+ */
+void EvdevInput::setAutoDetect (bool enabled) {
+    m_autoDetect = enabled;
+}
+
+/**
+ * Makes the input thread read the \c input_event structures from the given
+ * file descriptor \a fd (e.g. a pipe or an \c uinput device). The injected
+ * device reports the given number of \a axes (\c ABS_X onwards, with a
+ * 16-bit range), \a buttons (\c BTN_JOYSTICK onwards) and \a povs
+ * (\c ABS_HAT0X onwards).
+ *
+ * The descriptor is owned (and closed) by this object.
+ * Returns \c false if the device cannot be added.
+ */
+bool EvdevInput::addDevice (int fd, int axes, int buttons, int povs) {
+#if defined Q_OS_LINUX
+    if (fd < 0)
+        return false;
+
+    Device* device = NEW_DEVICE (fd, QString());
+
+    for (int i = 0; i < qMin (axes, JoystickStore::MAX_AXES); ++i) {
+        device->axisIndex [ABS_X + i] = i;
+        device->axes += 1;
+    }
+
+    for (int i = 0; i < qMin (buttons, JoystickStore::MAX_BUTTONS); ++i)
+        ADD_BUTTON (device, BTN_JOYSTICK + i);
+
+    for (int i = 0; i < qMin (povs, MAX_HATS); ++i) {
+        device->hatIndex [i] = i;
+        device->povs += 1;
+    }
+
+    fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK);
+
+    m_pendingLock.lock();
+    m_pendingDevices.append (device);
+    m_pendingLock.unlock();
+
+    wake();
+    return true;
+#else
+    Q_UNUSED (fd);
+    Q_UNUSED (axes);
+    Q_UNUSED (povs);
+    Q_UNUSED (buttons);
+    return false;
+#endif
+}
+
+/**
+ * Waits for device events and writes them to the joystick store
+ */
+void EvdevInput::run() {
+#if defined Q_OS_LINUX
+    struct epoll_event event;
+    m_epoll = epoll_create1 (EPOLL_CLOEXEC);
+    if (m_epoll == -1 || m_wakeFd == -1) {
+        qWarning() << "Cannot start evdev input thread";
+        return;
+    }
+
+    /* Watch the wake-up descriptor */
+    event.events = EPOLLIN;
+    event.data.u32 = WAKE_TAG;
+    epoll_ctl (m_epoll, EPOLL_CTL_ADD, m_wakeFd, &event);
+
+    /* Watch for new devices and open the current ones */
+    if (m_autoDetect) {
+        m_inotify = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+        if (m_inotify != -1) {
+            inotify_add_watch (m_inotify,
+                               INPUT_DIRECTORY.toUtf8().constData(),
+                               IN_CREATE | IN_ATTRIB | IN_DELETE);
+
+            event.events = EPOLLIN;
+            event.data.u32 = INOTIFY_TAG;
+            epoll_ctl (m_epoll, EPOLL_CTL_ADD, m_inotify, &event);
+        }
+
+        scanDevices();
+    }
+
+    while (!m_quit.loadAcquire()) {
+        /* Attach injected devices */
+        m_pendingLock.lock();
+        QList<Device*> pending = m_pendingDevices;
+        m_pendingDevices.clear();
+        m_pendingLock.unlock();
+
+        foreach (Device* device, pending)
+            attachDevice (device);
+
+        /* Wait for events */
+        struct epoll_event events [16];
+        int count = epoll_wait (m_epoll, events, 16, -1);
+        if (count < 0 && errno == EINTR)
+            continue;
+        else if (count < 0)
+            break;
+
+        for (int i = 0; i < count; ++i) {
+            quint32 tag = events [i].data.u32;
+
+            if (tag == WAKE_TAG) {
+                quint64 value;
+                if (read (m_wakeFd, &value, sizeof (value)) < 0)
+                    continue;
+            }
+
+            else if (tag == INOTIFY_TAG)
+                readNotifications();
+
+            else if (tag - FIRST_DEVICE_TAG < (quint32) MAX_DEVICES) {
+                Device* device = m_devices [tag - FIRST_DEVICE_TAG];
+                if (device)
+                    readDevice (device);
+            }
+        }
+    }
+
+    /* Close everything */
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        if (m_devices [i])
+            detachDevice (m_devices [i]);
+    }
+
+    if (m_inotify != -1)
+        close (m_inotify);
+
+    close (m_epoll);
+    m_epoll = -1;
+    m_inotify = -1;
+#endif
+}
+
+/**
+ * Stops the input thread from writing to the joystick store until the
+ * joystick that the DS is removing is gone and the IDs have been remapped.
+ * This function is called in the thread of the DS.
+ */
+void EvdevInput::lockJoystickIds() {
+    m_idLock.lock();
+}
+
+/**
+ * Forgets the ID of the joystick that was removed by the DS (if it was fed
+ * by one of our devices) and moves down the IDs of the joysticks that were
+ * registered after it. This function is called in the thread of the DS.
+ */
+void EvdevInput::remapJoystickIds (int removedId) {
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        int id = m_joystickIds [i].loadAcquire();
+        if (id == removedId)
+            m_joystickIds [i].storeRelease (-1);
+        else if (id > removedId)
+            m_joystickIds [i].storeRelease (id - 1);
+    }
+
+    m_idLock.unlock();
+}
+
+/**
+ * Registers the joystick of the device at the given \a slot with the DS.
+ * This function is called in the thread of the DS.
+ */
+void EvdevInput::registerDevice (int slot, int axes, int buttons, int povs) {
+    if (m_driverStation->registerJoystick (axes, buttons, povs)) {
+        int id = m_driverStation->joystickCount() - 1;
+        m_joystickIds [slot].storeRelease (id);
+    }
+}
+
+/**
+ * Removes the joystick of the device at the given \a slot from the DS and
+ * frees the slot. The IDs of the other devices are remapped when the DS
+ * reports the removal. This function is called in the thread of the DS.
+ */
+void EvdevInput::unregisterDevice (int slot) {
+    m_idLock.lock();
+    int id = m_joystickIds [slot].fetchAndStoreOrdered (-1);
+    m_idLock.unlock();
+
+    if (id >= 0)
+        m_driverStation->removeJoystick (id);
+
+    m_slotsInUse [slot].storeRelease (0);
+}
+
+/**
+ * Wakes up the input thread
+ */
+void EvdevInput::wake() {
+#if defined Q_OS_LINUX
+    quint64 value = 1;
+    if (m_wakeFd != -1 && write (m_wakeFd, &value, sizeof (value)) < 0)
+        qWarning() << "Cannot wake evdev input thread";
+#endif
+}
+
+/**
+ * Opens the joysticks that are already connected
+ */
+void EvdevInput::scanDevices() {
+#if defined Q_OS_LINUX
+    QDir directory (INPUT_DIRECTORY);
+    foreach (const QString& name, directory.entryList (QStringList ("event*"),
+                                                       QDir::System)) {
+        openDevice (directory.absoluteFilePath (name));
+    }
+#endif
+}
+
+/**
+ * Opens the devices that were created (or whose permissions were changed)
+ * and closes the devices that were removed
+ */
+void EvdevInput::readNotifications() {
+#if defined Q_OS_LINUX
+    char buffer [4096]
+    __attribute__ ((aligned (__alignof__ (struct inotify_event))));
+
+    ssize_t bytes = read (m_inotify, buffer, sizeof (buffer));
+    for (char* ptr = buffer; bytes > 0 && ptr < buffer + bytes;) {
+        const struct inotify_event* event = (struct inotify_event*) ptr;
+        ptr += sizeof (struct inotify_event) + event->len;
+
+        QString name = QString::fromUtf8 (event->name);
+        if (event->len == 0 || !name.startsWith ("event"))
+            continue;
+
+        QString path = INPUT_DIRECTORY + "/" + name;
+        if (event->mask & (IN_CREATE | IN_ATTRIB))
+            openDevice (path);
+
+        else if (event->mask & IN_DELETE) {
+            for (int i = 0; i < MAX_DEVICES; ++i) {
+                if (m_devices [i] && m_devices [i]->path == path)
+                    detachDevice (m_devices [i]);
+            }
+        }
+    }
+#endif
+}
+
+/**
+ * Reads the pending events of the given \a device and writes the new axis,
+ * button and POV values to the joystick store
+ */
+void EvdevInput::readDevice (Device* device) {
+#if defined Q_OS_LINUX
+    struct input_event events [64];
+    ssize_t bytes = read (device->fd, events, sizeof (events));
+
+    /* Nothing to read */
+    if (bytes < 0 && (errno == EAGAIN || errno == EINTR))
+        return;
+
+    /* Device was unplugged (or the injected pipe was closed) */
+    if (bytes <= 0) {
+        detachDevice (device);
+        return;
+    }
+
+    /* The DS cannot remove (or move) the joystick while we write to it */
+    QMutexLocker lock (&m_idLock);
+
+    /* The DS has not registered the joystick yet */
+    int id = m_joystickIds [device->slot].loadAcquire();
+    if (id < 0)
+        return;
+
+    int count = bytes / sizeof (struct input_event);
+    for (int i = 0; i < count; ++i) {
+        const struct input_event& event = events [i];
+
+        if (event.type == EV_KEY && event.code < KEY_CNT) {
+            int button = device->buttonIndex [event.code];
+            if (button >= 0)
+                m_store->setButton (id, button, event.value != 0);
+        }
+
+        else if (event.type == EV_ABS && IS_HAT (event.code)) {
+            int hat = (event.code - ABS_HAT0X) / 2;
+            if (device->hatIndex [hat] < 0)
+                continue;
+
+            if ((event.code - ABS_HAT0X) % 2 == 0)
+                device->hatX [hat] = event.value;
+            else
+                device->hatY [hat] = event.value;
+
+            m_store->setPOV (id, device->hatIndex [hat],
+                             POV_ANGLE (device->hatX [hat],
+                                        device->hatY [hat]));
+        }
+
+        else if (event.type == EV_ABS && event.code < ABS_CNT) {
+            int axis = device->axisIndex [event.code];
+            int min = device->axisMin [event.code];
+            int max = device->axisMax [event.code];
+
+            if (axis >= 0 && max > min) {
+                qreal value = 2 * (qreal) (event.value - min) / (max - min) - 1;
+                m_store->setAxis (id, axis, value);
+            }
+        }
+    }
+#else
+    Q_UNUSED (device);
+#endif
+}
+
+/**
+ * Opens the evdev node at the given \a path if it is a joystick that is not
+ * open already
+ */
+void EvdevInput::openDevice (const QString& path) {
+#if defined Q_OS_LINUX
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        if (m_devices [i] && m_devices [i]->path == path)
+            return;
+    }
+
+    int fd = open (path.toUtf8().constData(),
+                   O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1)
+        return;
+
+    Device* device = NEW_DEVICE (fd, path);
+    if (!PROBE_DEVICE (device)) {
+        close (fd);
+        delete device;
+        return;
+    }
+
+    if (attachDevice (device))
+        qDebug() << "Opened evdev joystick" << path;
+#else
+    Q_UNUSED (path);
+#endif
+}
+
+/**
+ * Assigns a free slot to the given \a device, adds it to the epoll set and
+ * asks the DS to register its joystick.
+ *
+ * If there are no free slots, the device is closed and \c false is returned.
+ */
+bool EvdevInput::attachDevice (Device* device) {
+#if defined Q_OS_LINUX
+    for (int i = 0; i < MAX_DEVICES; ++i) {
+        if (!m_slotsInUse [i].testAndSetOrdered (0, 1))
+            continue;
+
+        device->slot = i;
+        m_devices [i] = device;
+        m_joystickIds [i].storeRelease (-1);
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u32 = FIRST_DEVICE_TAG + i;
+        epoll_ctl (m_epoll, EPOLL_CTL_ADD, device->fd, &event);
+
+        emit deviceAttached (i, device->axes, device->buttons, device->povs);
+        return true;
+    }
+
+    qWarning() << "Too many evdev joysticks, ignoring" << device->path;
+
+    close (device->fd);
+    delete device;
+#else
+    Q_UNUSED (device);
+#endif
+
+    return false;
+}
+
+/**
+ * Closes the given \a device and asks the DS to remove its joystick
+ */
+void EvdevInput::detachDevice (Device* device) {
+#if defined Q_OS_LINUX
+    int slot = device->slot;
+
+    epoll_ctl (m_epoll, EPOLL_CTL_DEL, device->fd, Q_NULLPTR);
+    close (device->fd);
+
+    m_devices [slot] = Q_NULLPTR;
+    delete device;
+
+    emit deviceDetached (slot);
+#else
+    Q_UNUSED (device);
+#endif
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_EVDEV_INPUT_H
+#define _LIB_DS_EVDEV_INPUT_H
+
+#include <QMutex>
+#include <QThread>
+#include <Core/JoystickStore.h>
+
+class DriverStation;
+
+/**
+ * \brief Reads Linux evdev gamepads on a dedicated input thread
+ *
+ * The input thread opens the joysticks and gamepads found at
+ * \c /dev/input/event*, waits for their events with \c epoll and writes the
+ * axis, button and POV changes directly to the joystick store of the DS.
+ * Since the store is lock-free for readers, the values reach the next robot
+ * packet without going through any event loop.
+ *
+ * Devices that are plugged or unplugged are detected with \c inotify. Their
+ * registration (which is rare) is done through the regular
+ * \c DriverStation::registerJoystick() and \c removeJoystick() functions,
+ * which are called in the thread in which this object was created. Since
+ * the DS reports every removal, the IDs of the evdev joysticks are moved
+ * down when any joystick registered before them is removed, and the input
+ * thread never writes to a joystick while it is being removed.
+ *
+ * Other event sources (such as pipes or \c uinput devices) can be injected
+ * with \c addDevice(), which is mostly useful for testing.
+ *
+ * \note This object must be created in the thread of the \c DriverStation
+ * \note On operating systems other than Linux, \c start() does nothing
+ */
+class EvdevInput : public QThread {
+    Q_OBJECT
+
+  signals:
+    void deviceDetached (int slot);
+    void deviceAttached (int slot, int axes, int buttons, int povs);
+
+  public:
+    explicit EvdevInput (DriverStation* driverStation,
+                         QObject* parent = Q_NULLPTR);
+    ~EvdevInput();
+
+    struct Device;
+    static const int MAX_DEVICES = JoystickStore::MAX_JOYSTICKS;
+
+    bool autoDetect() const;
+    int joystickId (int slot) const;
+
+  public slots:
+    void stop();
+    void setAutoDetect (bool enabled);
+    bool addDevice (int fd, int axes, int buttons, int povs);
+
+  protected:
+    void run();
+
+  private slots:
+    void lockJoystickIds();
+    void remapJoystickIds (int removedId);
+    void registerDevice (int slot, int axes, int buttons, int povs);
+    void unregisterDevice (int slot);
+
+  private:
+    void wake();
+    void scanDevices();
+    void readNotifications();
+    void readDevice (Device* device);
+    void openDevice (const QString& path);
+    bool attachDevice (Device* device);
+    void detachDevice (Device* device);
+
+  private:
+    bool m_autoDetect;
+    QAtomicInt m_quit;
+
+    int m_epoll;
+    int m_wakeFd;
+    int m_inotify;
+
+    JoystickStore* m_store;
+    DriverStation* m_driverStation;
+
+    Device* m_devices [MAX_DEVICES];
+    QAtomicInt m_slotsInUse [MAX_DEVICES];
+    QAtomicInt m_joystickIds [MAX_DEVICES];
+
+    QMutex m_idLock;
+
+    QMutex m_pendingLock;
+    QList<Device*> m_pendingDevices;
+};
+
+#endif
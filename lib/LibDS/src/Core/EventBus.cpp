@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "EventBus.h"
+
+#include <QDebug>
+#include <QtAlgorithms>
+
+EventBus::Subscriber::Subscriber (quint32 mask,
+                                  QObject* receiver,
+                                  const QMetaMethod& slot) :
+    m_mask (mask),
+    m_pending (0),
+    m_receiver (receiver),
+    m_slot (slot),
+    m_notified (false),
+    m_dirty (0),
+    m_coalesced (0) {
+    for (int i = 0; i < EVENT_TYPE_COUNT; ++i)
+        m_latestReal [i].store (0, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the event types that are delivered to the subscriber
+ */
+quint32 EventBus::Subscriber::mask() const {
+    return m_mask;
+}
+
+/**
+ * Returns the number of events that were coalesced because the queue of
+ * the subscriber was full
+ */
+quint64 EventBus::Subscriber::coalescedEvents() const {
+    return m_coalesced.load (std::memory_order_relaxed);
+}
+
+/**
+ * Copies the next pending event to \a event. Returns \c false if there are
+ * no pending events, after which the subscriber is notified again when a
+ * new event is published.
+ */
+bool EventBus::Subscriber::next (Event* event) {
+    if (!event)
+        return false;
+
+    if (take (event))
+        return true;
+
+    m_notified.store (false);
+    return take (event);
+}
+
+/**
+ * Copies the next pending event to \a event. The queued events are returned
+ * first, followed by the latest value of each coalesced event type.
+ *
+ * Only the real value of a coalesced event is stored, and its integer value
+ * is derived from it (as \c publish() does), so that both values always
+ * come from the same event.
+ */
+bool EventBus::Subscriber::take (Event* event) {
+    if (m_pending == 0) {
+        if (m_queue.pop (event))
+            return true;
+
+        m_pending = m_dirty.exchange (0, std::memory_order_acquire);
+        if (m_pending == 0)
+            return false;
+    }
+
+    int type = qCountTrailingZeroBits (m_pending);
+    m_pending &= m_pending - 1;
+
+    event->type = type;
+    event->real = m_latestReal [type].load (std::memory_order_relaxed);
+    event->value = qRound (event->real);
+    return true;
+}
+
+/**
+ * Queues the given \a event and notifies the receiver if it has read every
+ * event since the last notification.
+ *
+ * Once an event type has been coalesced, the following events of that type
+ * are coalesced too until the subscriber reads them, so that the subscriber
+ * never receives an older value after a newer one.
+ */
+void EventBus::Subscriber::post (const Event& event) {
+    quint32 bit = 1u << event.type;
+    bool coalesced = (m_dirty.load (std::memory_order_relaxed) & bit)
+                     || !m_queue.push (event);
+
+    if (coalesced) {
+        m_latestReal [event.type].store (event.real, std::memory_order_relaxed);
+        m_dirty.fetch_or (bit, std::memory_order_release);
+        m_coalesced.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    if (!m_notified.exchange (true))
+        m_slot.invoke (m_receiver, Qt::AutoConnection);
+}
+
+/**
+ * Returns the mask that selects the given event \a type
+ */
+quint32 EventBus::mask (EventType type) {
+    return 1u << type;
+}
+
+/**
+ * Creates a subscriber for the event types selected by the given \a mask.
+ * The \a slot (e.g. "processEvents()") of the \a receiver is invoked when
+ * new events are available. The returned subscription must be kept to read
+ * the events, and removed with \c unsubscribe() before the receiver is
+ * destroyed.
+ *
+ * Returns a null subscription if the receiver has no such slot
+ */
+EventBus::Subscription EventBus::subscribe (quint32 mask,
+                                            QObject* receiver,
+                                            const char* slot) {
+    if (!receiver || !slot)
+        return Subscription();
+
+    const QMetaObject* meta = receiver->metaObject();
+    int index = meta->indexOfSlot (QMetaObject::normalizedSignature (slot));
+    if (index < 0) {
+        qWarning() << "Cannot subscribe" << receiver << "with slot" << slot;
+        return Subscription();
+    }
+
+    Subscription subscriber (new Subscriber (mask & ALL_EVENTS,
+                                             receiver,
+                                             meta->method (index)));
+    m_subscribers.append (subscriber);
+    return subscriber;
+}
+
+/**
+ * Stops delivering events to the given \a subscriber
+ */
+void EventBus::unsubscribe (const Subscription& subscriber) {
+    m_subscribers.removeAll (subscriber);
+}
+
+/**
+ * Removes every subscriber
+ */
+void EventBus::clear() {
+    m_subscribers.clear();
+}
+
+/**
+ * Publishes an event of the given \a type with an integer \a value
+ */
+void EventBus::publish (EventType type, int value) {
+    Event event;
+    event.type = type;
+    event.value = value;
+    event.real = value;
+    deliver (event);
+}
+
+/**
+ * Publishes an event of the given \a type with a real \a value
+ */
+void EventBus::publish (EventType type, qreal value) {
+    Event event;
+    event.type = type;
+    event.value = qRound (value);
+    event.real = value;
+    deliver (event);
+}
+
+/**
+ * Delivers the given \a event to every subscriber interested in its type
+ */
+void EventBus::deliver (const Event& event) {
+    quint32 bit = mask ((EventType) event.type);
+
+    /* foreach iterates over a copy, so subscribers may unsubscribe while
+     * they are being notified */
+    foreach (const Subscription& subscriber, m_subscribers) {
+        if (subscriber->mask() & bit)
+            subscriber->post (event);
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_EVENT_BUS_H
+#define _LIB_DS_EVENT_BUS_H
+
+#include <atomic>
+#include <QList>
+#include <QMetaMethod>
+#include <QSharedPointer>
+#include <Utilities/SpscQueue.h>
+
+/**
+ * \brief Delivers the state changes of a DS to its internal consumers
+ *
+ * The \c DS_Config publishes a typed event every time that a value changes.
+ * Each subscriber selects the event types that it needs and receives them
+ * through its own lock-free queue, so a subscriber living in another thread
+ * (e.g. the logger) never blocks the DS and never causes arguments to be
+ * marshalled through the meta-object system.
+ *
+ * Subscribers are notified by invoking one of their slots (directly if they
+ * live in the publishing thread, queued otherwise). The slot is invoked once
+ * for every batch of events, and must read every pending event with
+ * \c Subscriber::next().
+ *
+ * If a subscriber cannot keep up and its queue fills up, the following
+ * events of each type are coalesced: the subscriber receives the latest
+ * value of each type instead of every intermediate change.
+ *
+ * \note Events must be published (and subscribers added and removed) from
+ *       the thread of the bus owner
+ */
+class EventBus {
+  public:
+    enum EventType {
+        kTeam            = 0,
+        kCpuUsage        = 1,
+        kRamUsage        = 2,
+        kDiskUsage       = 3,
+        kVoltage         = 4,
+        kSimulated       = 5,
+        kAlliance        = 6,
+        kPosition        = 7,
+        kCodeStatus      = 8,
+        kControlMode     = 9,
+        kEnableStatus    = 10,
+        kFMSCommStatus   = 11,
+        kRadioCommStatus = 12,
+        kRobotCommStatus = 13,
+        kVoltageStatus   = 14,
+        kOperationStatus = 15,
+        kElapsedTime     = 16,
+        kPacketLoss      = 17,
+        kLibVersion      = 18,
+        kPcmVersion      = 19,
+        kPdpVersion      = 20,
+    };
+
+    static const int EVENT_TYPE_COUNT = 21;
+    static const quint32 ALL_EVENTS = (1u << EVENT_TYPE_COUNT) - 1;
+
+    /**
+     * A state change. Integer, boolean and enumerated values are stored in
+     * \c value and the voltage is stored in \c real. Version events carry no
+     * value, the new version must be read from the \c DS_Config.
+     */
+    struct Event {
+        int type;   /**< Type of the event */
+        int value;  /**< New integer value */
+        qreal real; /**< New real value */
+    };
+
+    /**
+     * \brief Receives the events selected by a consumer
+     *
+     * \note Only one thread may read the events of a subscriber
+     */
+    class Subscriber {
+        friend class EventBus;
+
+      public:
+        quint32 mask() const;
+        quint64 coalescedEvents() const;
+        bool next (Event* event);
+
+      private:
+        Subscriber (quint32 mask, QObject* receiver, const QMetaMethod& slot);
+
+        bool take (Event* event);
+        void post (const Event& event);
+
+      private:
+        static const unsigned QUEUE_SIZE = 64;
+
+        quint32 m_mask;
+        quint32 m_pending;
+        QObject* m_receiver;
+        QMetaMethod m_slot;
+
+        std::atomic<bool> m_notified;
+        std::atomic<quint32> m_dirty;
+        std::atomic<quint64> m_coalesced;
+        std::atomic<qreal> m_latestReal [EVENT_TYPE_COUNT];
+        SpscQueue<Event, QUEUE_SIZE> m_queue;
+    };
+
+    typedef QSharedPointer<Subscriber> Subscription;
+
+    static quint32 mask (EventType type);
+
+    Subscription subscribe (quint32 mask, QObject* receiver, const char* slot);
+    void unsubscribe (const Subscription& subscriber);
+    void clear();
+
+    void publish (EventType type, int value = 0);
+    void publish (EventType type, qreal value);
+
+  private:
+    void deliver (const Event& event);
+
+  private:
+    QList<Subscription> m_subscribers;
+};
+
+#endif
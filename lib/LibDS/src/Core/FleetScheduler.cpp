@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "FleetScheduler.h"
+
+#include <DriverStation.h>
+#include <Core/DS_Config.h>
+
+FleetScheduler::FleetScheduler() : m_timer (this) {
+    m_clock.start();
+    m_timer.setTimerType (Qt::PreciseTimer);
+    connect (&m_timer, SIGNAL (timeout()), this, SLOT (tick()));
+}
+
+/**
+ * Creates a new externally clocked DS engine with the given \a name.
+ * The robot logger of the engine will be moved to the given \a loggerThread.
+ *
+ * \note This function must be called from the network thread
+ */
+DriverStation* FleetScheduler::createEngine (const QString& name,
+                                             QThread* loggerThread) {
+    DS_Config* config = new DS_Config (name, loggerThread, true);
+    DriverStation* engine = new DriverStation (config);
+
+    m_engines.append (engine);
+    engine->init();
+
+    qDebug() << "Fleet engine" << name << "created";
+
+    return engine;
+}
+
+/**
+ * Stops driving the given \a engine and deletes it
+ */
+void FleetScheduler::destroyEngine (DriverStation* engine) {
+    if (m_engines.removeAll (engine) > 0)
+        delete engine;
+}
+
+/**
+ * Changes the interval (in milliseconds) of the shared tick. A smaller value
+ * reduces the jitter of the packets sent by the engines.
+ */
+void FleetScheduler::setTickInterval (int msecs) {
+    m_timer.start (qMax (msecs, 1));
+}
+
+/**
+ * Deletes all the engines, this is called before the network thread quits
+ */
+void FleetScheduler::destroyAllEngines() {
+    m_timer.stop();
+
+    qDeleteAll (m_engines);
+    m_engines.clear();
+}
+
+/**
+ * Lets every engine send the packets (and perform the operations) that are
+ * due at the current time
+ */
+void FleetScheduler::tick() {
+    qint64 now = m_clock.elapsed();
+
+    foreach (DriverStation* engine, m_engines)
+        engine->processTick (now);
+}
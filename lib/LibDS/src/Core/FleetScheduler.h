@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_FLEET_SCHEDULER_H
+#define _LIB_DS_FLEET_SCHEDULER_H
+
+#include <QTimer>
+#include <QElapsedTimer>
+#include <Core/DS_Common.h>
+
+class DriverStation;
+
+/**
+ * \brief Creates, destroys and clocks the DS engines of a \c Fleet
+ *
+ * This object lives in the network thread of the \c Fleet, so that every
+ * engine (and its sockets, watchdogs and timers) is created in that thread.
+ * A single timer is used to drive all the engines, instead of each engine
+ * running its own set of packet timers.
+ */
+class FleetScheduler : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit FleetScheduler();
+
+  public slots:
+    DriverStation* createEngine (const QString& name, QThread* loggerThread);
+    void destroyEngine (DriverStation* engine);
+    void setTickInterval (int msecs);
+    void destroyAllEngines();
+
+  private slots:
+    void tick();
+
+  private:
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QList<DriverStation*> m_engines;
+};
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Impairment.h"
+
+#include <cmath>
+#include <string.h>
+#include <Utilities/Clock.h>
+
+/**
+ * Creates settings that do not impair the link. The bad state of the
+ * Gilbert-Elliott model loses every packet unless told otherwise.
+ */
+Impairment::Settings::Settings() {
+    lossRate = 0;
+    burstEnterRate = 0;
+    burstExitRate = 0;
+    burstLossRate = 1;
+    delay = 0;
+    jitter = 0;
+    reorderRate = 0;
+    duplicateRate = 0;
+    bandwidth = 0;
+    seed = 0;
+}
+
+Impairment::Impairment (int target, QObject* parent) : QObject (parent) {
+    m_target = target;
+    m_burst = false;
+    m_linkFree = 0;
+    m_releaseTime = -1;
+    m_random.seed (m_settings.seed);
+    memset (&m_statistics, 0, sizeof (m_statistics));
+}
+
+/**
+ * Returns the target (FMS, radio or robot) of the impaired packets
+ */
+int Impairment::target() const {
+    return m_target;
+}
+
+/**
+ * Returns the number of packets that are being delayed
+ */
+int Impairment::pendingPackets() const {
+    return m_queue.count();
+}
+
+/**
+ * Returns the current impairment settings
+ */
+Impairment::Settings Impairment::settings() const {
+    return m_settings;
+}
+
+/**
+ * Returns the number of packets processed, dropped, duplicated, reordered
+ * and delivered by the stage
+ */
+Impairment::Statistics Impairment::statistics() const {
+    return m_statistics;
+}
+
+/**
+ * Changes the impairment \a settings and restarts the random generator with
+ * their seed. The packets that are already delayed are not affected.
+ */
+void Impairment::setSettings (const Settings& settings) {
+    m_settings = settings;
+    m_burst = false;
+    m_random.seed (settings.seed);
+}
+
+/**
+ * Impairs the given packet \a data, which is emitted with \c packetReady()
+ * when (and if) it crosses the emulated link
+ */
+void Impairment::process (const QByteArray& data) {
+    ++m_statistics.packets;
+
+    if (isLost()) {
+        ++m_statistics.dropped;
+        return;
+    }
+
+    bool duplicate = m_settings.duplicateRate > 0
+                     && random() < m_settings.duplicateRate;
+
+    enqueue (data);
+    if (duplicate) {
+        ++m_statistics.duplicated;
+        enqueue (data);
+    }
+
+    releaseDue();
+}
+
+/**
+ * Called when the earliest delayed packet is due
+ */
+void Impairment::release() {
+    m_releaseTime = -1;
+    releaseDue();
+}
+
+/**
+ * Returns \c true if the next packet must be dropped. The state of the
+ * Gilbert-Elliott model is updated before every packet.
+ */
+bool Impairment::isLost() {
+    if (m_burst)
+        m_burst = !(random() < m_settings.burstExitRate);
+    else if (m_settings.burstEnterRate > 0)
+        m_burst = random() < m_settings.burstEnterRate;
+
+    qreal rate = m_burst ? m_settings.burstLossRate : m_settings.lossRate;
+    return rate > 0 && random() < rate;
+}
+
+/**
+ * Returns a random number between 0 (inclusive) and 1 (exclusive). The
+ * conversion is done by hand, since the standard distributions may yield
+ * different sequences with different compilers.
+ */
+qreal Impairment::random() {
+    return m_random() / 4294967296.0;
+}
+
+/**
+ * Emits the delayed packets that are due and schedules the next release
+ */
+void Impairment::releaseDue() {
+    qint64 now = Clock::getInstance()->elapsed();
+
+    while (!m_queue.isEmpty() && m_queue.first().time <= now) {
+        Packet packet = m_queue.takeFirst();
+        ++m_statistics.delivered;
+        emit packetReady (m_target, packet.data);
+    }
+
+    scheduleRelease();
+}
+
+/**
+ * Schedules a release at the time of the earliest delayed packet, unless a
+ * release is already scheduled at (or before) that time
+ */
+void Impairment::scheduleRelease() {
+    if (m_queue.isEmpty())
+        return;
+
+    qint64 next = m_queue.first().time;
+    if (m_releaseTime >= 0 && m_releaseTime <= next)
+        return;
+
+    qint64 now = Clock::getInstance()->elapsed();
+    m_releaseTime = next;
+    Clock::getInstance()->schedule (static_cast<int> (qMax (next - now,
+                                                            qint64 (0))),
+                                    this, SLOT (release()));
+}
+
+/**
+ * Calculates when the given packet \a data leaves the emulated link and
+ * adds it to the delayed packets. Packets with the same release time keep
+ * the order in which they were processed.
+ */
+void Impairment::enqueue (const QByteArray& data) {
+    qreal now = Clock::getInstance()->elapsed();
+    qreal time = now;
+
+    /* Packets wait until the link has transmitted the previous ones */
+    if (m_settings.bandwidth > 0) {
+        time = qMax (now, m_linkFree)
+               + data.size() * 1000.0 / m_settings.bandwidth;
+        m_linkFree = time;
+    }
+
+    qreal delay = m_settings.delay;
+    if (m_settings.jitter > 0)
+        delay += (random() * 2 - 1) * m_settings.jitter;
+
+    delay = qMax (delay, qreal (0));
+
+    /* Only delayed packets can overtake the others */
+    if (delay > 0 && m_settings.reorderRate > 0
+            && random() < m_settings.reorderRate) {
+        delay = 0;
+        ++m_statistics.reordered;
+    }
+
+    Packet packet;
+    packet.data = data;
+    packet.time = static_cast<qint64> (std::ceil (time + delay));
+
+    int index = m_queue.count();
+    while (index > 0 && m_queue.at (index - 1).time > packet.time)
+        --index;
+
+    m_queue.insert (index, packet);
+}
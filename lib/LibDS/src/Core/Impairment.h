@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_IMPAIRMENT_H
+#define _LIB_DS_IMPAIRMENT_H
+
+#include <random>
+#include <QList>
+#include <QObject>
+#include <QByteArray>
+
+/**
+ * \brief Emulates a bad network link between the DS and one of its targets
+ *
+ * The \c Sockets pass the packets of an impaired target through an instance
+ * of this class, which drops, delays, reorders or duplicates them before
+ * emitting \c packetReady(). This allows testing how the DS behaves under
+ * field-like conditions without root privileges or \c netem.
+ *
+ * The stage supports:
+ * - Random loss, either independent (Bernoulli) or in bursts (Gilbert-Elliott
+ *   model, where the link alternates between a good and a bad state, each
+ *   with its own loss rate)
+ * - A fixed delay with optional uniform jitter
+ * - Reordering, where some packets skip the delay and overtake the packets
+ *   that are still delayed (as in \c netem, this requires a delay)
+ * - Duplication
+ * - A bandwidth cap, which serializes the packets at the given rate
+ *
+ * Every random decision is taken with a generator seeded from the settings,
+ * so the same settings and traffic always produce the same impairments.
+ * Delays are measured with the LibDS \c Clock, which makes the stage
+ * deterministic when a \c VirtualClock is used.
+ */
+class Impairment : public QObject {
+    Q_OBJECT
+
+  signals:
+    void packetReady (int target, const QByteArray& data);
+
+  public:
+    struct Settings {
+        Settings();
+
+        qreal lossRate;       /**< Loss probability (good state) */
+        qreal burstEnterRate; /**< Probability of entering the bad state */
+        qreal burstExitRate;  /**< Probability of leaving the bad state */
+        qreal burstLossRate;  /**< Loss probability in the bad state */
+        int delay;            /**< Delay of every packet (msecs) */
+        int jitter;           /**< Maximum random delay variation (msecs) */
+        qreal reorderRate;    /**< Probability of sending without delay */
+        qreal duplicateRate;  /**< Probability of sending a packet twice */
+        int bandwidth;        /**< Link capacity (bytes/sec), 0 = no cap */
+        quint32 seed;         /**< Seed of the random decisions */
+    };
+
+    struct Statistics {
+        quint64 packets;    /**< Packets given to the stage */
+        quint64 dropped;    /**< Packets lost */
+        quint64 duplicated; /**< Packets sent twice */
+        quint64 reordered;  /**< Packets that skipped the delay */
+        quint64 delivered;  /**< Packets emitted (including duplicates) */
+    };
+
+    explicit Impairment (int target, QObject* parent = Q_NULLPTR);
+
+    int target() const;
+    int pendingPackets() const;
+    Settings settings() const;
+    Statistics statistics() const;
+
+    void setSettings (const Settings& settings);
+    void process (const QByteArray& data);
+
+  private slots:
+    void release();
+
+  private:
+    bool isLost();
+    qreal random();
+    void releaseDue();
+    void scheduleRelease();
+    void enqueue (const QByteArray& data);
+
+  private:
+    struct Packet {
+        qint64 time;
+        QByteArray data;
+    };
+
+    int m_target;
+    bool m_burst;
+    qreal m_linkFree;
+    qint64 m_releaseTime;
+
+    Settings m_settings;
+    Statistics m_statistics;
+    std::mt19937 m_random;
+    QList<Packet> m_queue;
+};
+
+#endif
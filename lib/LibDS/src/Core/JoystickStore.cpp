@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "JoystickStore.h"
+
+#include <chrono>
+
+/**
+ * Sets the given \a joystick to its neutral state
+ */
+static void NEUTRALIZE (JoystickStore::State* joystick) {
+    memset (joystick, 0, sizeof (JoystickStore::State));
+
+    for (int i = 0; i < JoystickStore::MAX_POVS; ++i)
+        joystick->povs [i] = -1;
+}
+
+JoystickStore::JoystickStore() : m_timestamps (false) {
+    memset (&m_data, 0, sizeof (m_data));
+    memset (m_changeTimes, 0, sizeof (m_changeTimes));
+
+    for (int i = 0; i < MAX_JOYSTICKS; ++i)
+        NEUTRALIZE (&m_data.joysticks [i]);
+}
+
+/**
+ * Returns the number of registered joysticks
+ */
+int JoystickStore::count() const {
+    unsigned sequence;
+    int count;
+
+    do {
+        sequence = m_lock.readBegin();
+        count = m_data.count;
+    } while (m_lock.readRetry (sequence));
+
+    return count;
+}
+
+/**
+ * Returns \c true if the store records the time of the joystick changes
+ */
+bool JoystickStore::timestampsEnabled() const {
+    return m_timestamps.load (std::memory_order_relaxed);
+}
+
+/**
+ * Returns a consistent copy of the values of every joystick
+ */
+JoystickStore::Snapshot JoystickStore::snapshot() const {
+    Snapshot data;
+    snapshot (&data);
+    return data;
+}
+
+/**
+ * Copies the values of every joystick into the given \a snapshot. This
+ * function never blocks the writers and can be called from any thread.
+ */
+void JoystickStore::snapshot (Snapshot* snapshot) const {
+    if (snapshot)
+        m_lock.read (m_data, snapshot);
+}
+
+/**
+ * Returns the current time (in nanoseconds) of the monotonic clock used to
+ * timestamp the joystick changes
+ */
+qint64 JoystickStore::timestamp() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds> (
+               steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Converts the given axis \a value (from -1 to 1) to the signed byte sent
+ * to the robot
+ */
+DS_SByte JoystickStore::quantizeAxis (qreal value) {
+    return static_cast<DS_SByte> (qBound (qreal (-1), value, qreal (1)) * 127);
+}
+
+/**
+ * Returns \c true if the given \a button of the \a joystick is pressed
+ */
+bool JoystickStore::isPressed (const State& joystick, int button) {
+    if (button >= 0 && button < MAX_BUTTONS)
+        return (joystick.buttons >> button) & 1;
+
+    return false;
+}
+
+/**
+ * Removes all the joysticks
+ */
+void JoystickStore::reset() {
+    m_lock.lockForWrite();
+    for (int i = 0; i < m_data.count; ++i)
+        NEUTRALIZE (&m_data.joysticks [i]);
+    m_data.count = 0;
+    m_lock.unlockForWrite();
+}
+
+/**
+ * Tells the store that the values of the \a sent snapshot left the DS,
+ * so that the next change of each joystick gets a new timestamp.
+ *
+ * Joysticks that changed after the snapshot was taken keep the time of their
+ * first change after the snapshot, since their new values have not been sent
+ * yet.
+ */
+void JoystickStore::markSent (const Snapshot& sent) {
+    m_lock.lockForWrite();
+    for (int i = 0; i < qMin (m_data.count, sent.count); ++i) {
+        State* joystick = &m_data.joysticks [i];
+        quint32 version = sent.joysticks [i].version;
+
+        if (joystick->version == version)
+            joystick->changeTime = 0;
+
+        else if (joystick->changeTime != 0) {
+            qint64 time = firstChangeAfter (i, version);
+            if (time != 0)
+                joystick->changeTime = time;
+        }
+    }
+    m_lock.unlockForWrite();
+}
+
+/**
+ * Enables or disables the timestamping of joystick changes. Disabling the
+ * timestamps clears the pending timestamps of every joystick.
+ */
+void JoystickStore::setTimestampsEnabled (bool enabled) {
+    m_lock.lockForWrite();
+    m_timestamps.store (enabled, std::memory_order_relaxed);
+    for (int i = 0; i < MAX_JOYSTICKS; ++i)
+        m_data.joysticks [i].changeTime = 0;
+    memset (m_changeTimes, 0, sizeof (m_changeTimes));
+    m_lock.unlockForWrite();
+}
+
+/**
+ * Removes the joystick with the given \a id, the joysticks registered after
+ * it are moved down one position
+ */
+void JoystickStore::removeJoystick (int id) {
+    m_lock.lockForWrite();
+    if (id >= 0 && id < m_data.count) {
+        for (int i = id; i < m_data.count - 1; ++i) {
+            m_data.joysticks [i] = m_data.joysticks [i + 1];
+            memcpy (m_changeTimes [i], m_changeTimes [i + 1],
+                    sizeof (m_changeTimes [i]));
+        }
+
+        m_data.count -= 1;
+        NEUTRALIZE (&m_data.joysticks [m_data.count]);
+        memset (m_changeTimes [m_data.count], 0,
+                sizeof (m_changeTimes [m_data.count]));
+    }
+    m_lock.unlockForWrite();
+}
+
+/**
+ * Registers a new joystick with the given number of \a axes, \a buttons and
+ * \a povs. The values are clamped to the capacity of the store.
+ *
+ * Returns \c false if the store is full.
+ */
+bool JoystickStore::addJoystick (int axes, int buttons, int povs) {
+    bool added = false;
+
+    m_lock.lockForWrite();
+    if (m_data.count < MAX_JOYSTICKS) {
+        State* joystick = &m_data.joysticks [m_data.count];
+        NEUTRALIZE (joystick);
+
+        joystick->numAxes = qBound (0, axes, MAX_AXES);
+        joystick->numPOVs = qBound (0, povs, MAX_POVS);
+        joystick->numButtons = qBound (0, buttons, MAX_BUTTONS);
+
+        m_data.count += 1;
+        added = true;
+    }
+    m_lock.unlockForWrite();
+
+    return added;
+}
+
+/**
+ * Updates the \a angle of the given \a pov of the joystick with the given
+ * \a id. Invalid joysticks and POVs are ignored.
+ */
+void JoystickStore::setPOV (int id, int pov, int angle) {
+    qint16 value = static_cast<qint16> (angle);
+    qint64 time = timestampsEnabled() ? timestamp() : 0;
+
+    m_lock.lockForWrite();
+    if (id >= 0 && id < m_data.count && pov >= 0) {
+        State* joystick = &m_data.joysticks [id];
+        if (pov < joystick->numPOVs && joystick->povs [pov] != value) {
+            joystick->povs [pov] = value;
+            touch (id, time);
+        }
+    }
+    m_lock.unlockForWrite();
+}
+
+/**
+ * Updates the \a value of the given \a axis of the joystick with the given
+ * \a id. Invalid joysticks and axes are ignored.
+ */
+void JoystickStore::setAxis (int id, int axis, qreal value) {
+    DS_SByte quantized = quantizeAxis (value);
+    qint64 time = timestampsEnabled() ? timestamp() : 0;
+
+    m_lock.lockForWrite();
+    if (id >= 0 && id < m_data.count && axis >= 0) {
+        State* joystick = &m_data.joysticks [id];
+        if (axis < joystick->numAxes && joystick->axes [axis] != quantized) {
+            joystick->axes [axis] = quantized;
+            touch (id, time);
+        }
+    }
+    m_lock.unlockForWrite();
+}
+
+/**
+ * Updates the \a pressed state of the given \a button of the joystick with
+ * the given \a id. Invalid joysticks and buttons are ignored.
+ *
+ * The button word is kept up to date with every change, so that the
+ * protocols can copy it into the robot packets as-is.
+ */
+void JoystickStore::setButton (int id, int button, bool pressed) {
+    qint64 time = timestampsEnabled() ? timestamp() : 0;
+
+    m_lock.lockForWrite();
+    if (id >= 0 && id < m_data.count && button >= 0) {
+        State* joystick = &m_data.joysticks [id];
+        if (button < joystick->numButtons) {
+            quint32 mask = quint32 (1) << button;
+            quint32 buttons = pressed ? (joystick->buttons | mask) :
+                              (joystick->buttons & ~mask);
+
+            if (buttons != joystick->buttons) {
+                joystick->buttons = buttons;
+                touch (id, time);
+            }
+        }
+    }
+    m_lock.unlockForWrite();
+}
+
+/**
+ * Replaces every value of the joystick with the given \a id with a single
+ * write: the quantized \a axes, the \a buttons word and the \a povs angles.
+ * The arrays must hold \c MAX_AXES and \c MAX_POVS values, the values beyond
+ * the axes, buttons and POVs of the joystick are ignored.
+ */
+void JoystickStore::setJoystick (int id, const DS_SByte* axes,
+                                 quint32 buttons, const qint16* povs) {
+    qint64 time = timestampsEnabled() ? timestamp() : 0;
+
+    m_lock.lockForWrite();
+    if (id >= 0 && id < m_data.count) {
+        State* joystick = &m_data.joysticks [id];
+        bool changed = false;
+
+        for (int i = 0; i < joystick->numAxes; ++i) {
+            if (joystick->axes [i] != axes [i]) {
+                joystick->axes [i] = axes [i];
+                changed = true;
+            }
+        }
+
+        for (int i = 0; i < joystick->numPOVs; ++i) {
+            if (joystick->povs [i] != povs [i]) {
+                joystick->povs [i] = povs [i];
+                changed = true;
+            }
+        }
+
+        if (joystick->numButtons < MAX_BUTTONS)
+            buttons &= (quint32 (1) << joystick->numButtons) - 1;
+
+        if (joystick->buttons != buttons) {
+            joystick->buttons = buttons;
+            changed = true;
+        }
+
+        if (changed)
+            touch (id, time);
+    }
+    m_lock.unlockForWrite();
+}
+
+/**
+ * Registers a change of the joystick with the given \a id, which happened at
+ * the given \a time. The time is recorded in the change history, and becomes
+ * the change time of the joystick if it is its first unsent change.
+ *
+ * \note Must be called with the write lock held
+ */
+void JoystickStore::touch (int id, qint64 time) {
+    State* joystick = &m_data.joysticks [id];
+    joystick->version += 1;
+    m_changeTimes [id][joystick->version % CHANGE_HISTORY] = time;
+
+    if (time != 0 && joystick->changeTime == 0)
+        joystick->changeTime = time;
+}
+
+/**
+ * Returns the time of the first change of the joystick with the given \a id
+ * after the given \a version. If the joystick changed more times than the
+ * history holds, the time of the oldest change in the history is returned.
+ *
+ * \note Must be called with the write lock held
+ */
+qint64 JoystickStore::firstChangeAfter (int id, quint32 version) const {
+    quint32 latest = m_data.joysticks [id].version;
+    if (latest - version > quint32 (CHANGE_HISTORY))
+        version = latest - CHANGE_HISTORY;
+
+    return m_changeTimes [id][(version + 1) % CHANGE_HISTORY];
+}
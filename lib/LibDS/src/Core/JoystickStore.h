@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_JOYSTICK_STORE_H
+#define _LIB_DS_JOYSTICK_STORE_H
+
+#include <Core/DS_Common.h>
+#include <Utilities/SeqLock.h>
+
+/**
+ * \brief Holds the values of every registered joystick in a single block
+ *
+ * The joystick values are stored in the format in which they are sent to the
+ * robot: axes are quantized to signed bytes, buttons are packed in a bitset
+ * and POV angles are stored as 16-bit integers. All the joysticks live in a
+ * contiguous, fixed-size block, so that no allocations take place when
+ * joysticks are registered or updated.
+ *
+ * Writers (e.g. input backends running in their own threads) publish their
+ * changes through a \c SeqLock, while the protocols take a consistent,
+ * lock-free snapshot of every joystick before generating a robot packet.
+ *
+ * If timestamps are enabled, the store remembers when the first change that
+ * was not sent to the robot yet happened, which allows the DS to measure the
+ * input-to-wire latency of each joystick. The times of the latest changes
+ * are kept as well, so that the changes that happened after a snapshot was
+ * taken keep their own timestamp once the snapshot is sent.
+ */
+class JoystickStore {
+  public:
+    static const int MAX_JOYSTICKS = 6;
+    static const int MAX_AXES = 12;
+    static const int MAX_POVS = 12;
+    static const int MAX_BUTTONS = 32;
+
+    struct State {
+        DS_SByte axes [MAX_AXES];  /**< Quantized axis values */
+        DS_UByte numAxes;          /**< Number of axes used by the DS */
+        DS_UByte numButtons;       /**< Number of buttons used by the DS */
+        DS_UByte numPOVs;          /**< Number of POVs used by the DS */
+        DS_UByte reserved;         /**< Keeps the button word aligned */
+        quint32 buttons;           /**< Button states, bit N is button N */
+        qint16 povs [MAX_POVS];    /**< POV angles, -1 if not pressed */
+        quint32 version;           /**< Incremented with every change */
+        qint64 changeTime;         /**< Time of the first unsent change */
+    };
+
+    struct Snapshot {
+        int count;                       /**< Number of registered joysticks */
+        State joysticks [MAX_JOYSTICKS]; /**< Values of each joystick */
+    };
+
+    explicit JoystickStore();
+
+    int count() const;
+    bool timestampsEnabled() const;
+    Snapshot snapshot() const;
+    void snapshot (Snapshot* snapshot) const;
+
+    static qint64 timestamp();
+    static DS_SByte quantizeAxis (qreal value);
+    static bool isPressed (const State& joystick, int button);
+
+    void reset();
+    void markSent (const Snapshot& sent);
+    void setTimestampsEnabled (bool enabled);
+
+    void removeJoystick (int id);
+    bool addJoystick (int axes, int buttons, int povs);
+
+    void setPOV (int id, int pov, int angle);
+    void setAxis (int id, int axis, qreal value);
+    void setButton (int id, int button, bool pressed);
+    void setJoystick (int id, const DS_SByte* axes, quint32 buttons,
+                      const qint16* povs);
+
+  private:
+    static const int CHANGE_HISTORY = 16;
+
+    void touch (int id, qint64 time);
+    qint64 firstChangeAfter (int id, quint32 version) const;
+
+  private:
+    std::atomic<bool> m_timestamps;
+    mutable SeqLock m_lock;
+    Snapshot m_data;
+    qint64 m_changeTimes [MAX_JOYSTICKS][CHANGE_HISTORY];
+};
+
+#endif
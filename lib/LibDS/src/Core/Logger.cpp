@@ -9,15 +9,16 @@
 #include <QDir>
 #include <QJsonArray>
 #include <QJsonObject>
-#include <QApplication>
-#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <Utilities/Tracer.h>
 
 #include "Logger.h"
 
 /* Used for the custom message handler */
 #define PRINT_FMT "%-14s %-13s %-12s\n"
 #define PRINT(string) QString(string).toLocal8Bit().constData()
-#define GET_DATE_TIME(format) QDateTime::currentDateTime().toString(format)
+#define GET_DATE_TIME(format) \
+    Clock::getInstance()->currentDateTime().toString(format)
 
 /* JSON logger keys */
 const QString TIME = "t";
@@ -35,18 +36,33 @@ static QString REPEAT (QString input, int n) {
     return string;
 }
 
-Logger::Logger() {
+Logger::Logger (const QString& name) {
     m_dump = Q_NULLPTR;
-    m_timer = new QElapsedTimer;
 
     m_closed = false;
     m_initialized = false;
     m_eventsRegistered = false;
+    m_events = 0;
 
-    m_timer->start();
+    m_startTime = Clock::getInstance()->elapsed();
     m_logFilePath = logsPath() + "/"
-                    + GET_DATE_TIME ("yyyy_MM_dd hh_mm_ss ddd")
-                    + "." + extension();
+                    + GET_DATE_TIME ("yyyy_MM_dd hh_mm_ss ddd");
+
+    /* Avoid file name collisions when running several DS engines */
+    if (!name.isEmpty())
+        m_logFilePath.append (" [" + name + "]");
+
+    m_logFilePath.append ("." + extension());
+}
+
+/**
+ * Returns the number of robot events registered by the logger. The events
+ * are held in memory until the logger is closed.
+ *
+ * \note This function can be called from any thread
+ */
+int Logger::eventCount() const {
+    return m_events.load (std::memory_order_relaxed);
 }
 
 /**
@@ -108,7 +124,7 @@ void Logger::messageHandler (QtMsgType type,
     if (!m_initialized) initializeLogger();
 
     /* Get elapsed time */
-    quint32 msec = m_timer->elapsed();
+    quint32 msec = elapsedTime();
     quint32 secs = (msec / 1000);
     quint32 mins = (secs / 60) % 60;
 
@@ -150,12 +166,23 @@ void Logger::messageHandler (QtMsgType type,
     fflush (m_dump);
 }
 
+/**
+ * Registers the robot events received by the given \a events subscription
+ *
+ * \note This must be called before the logger is moved to its thread
+ */
+void Logger::setEvents (const EventBus::Subscription& events) {
+    m_subscription = events;
+}
+
 /**
  * Saves the robot events and the application logs into a compact JSON file.
  * This file can later be used by teams to diagnostic their robots or by the
  * LibDS developers to fix an issue.
  */
 void Logger::saveLogs() {
+    Tracer::Span span ("logger", "Save logs");
+
     /* Register voltage values */
     QVariantList voltageList;
     for (int i = 0; i < m_voltage.count(); ++i) {
@@ -258,7 +285,7 @@ void Logger::saveLogs() {
     /* Serialize event data */
     QJsonArray array;
     QJsonDocument document;
-    array.append (QJsonValue::fromVariant (m_timer->elapsed()));
+    array.append (QJsonValue::fromVariant (elapsedTime()));
     array.append (QJsonValue::fromVariant (cpuList));
     array.append (QJsonValue::fromVariant (ramList));
     array.append (QJsonValue::fromVariant (pktList));
@@ -311,6 +338,61 @@ void Logger::closeLogs() {
     }
 }
 
+/**
+ * Registers the robot events published by the DS since the last call
+ */
+void Logger::processEvents() {
+    if (!m_subscription)
+        return;
+
+    EventBus::Event event;
+    while (m_subscription->next (&event)) {
+        switch (event.type) {
+        case EventBus::kVoltage:
+            registerVoltage (event.real);
+            break;
+        case EventBus::kCpuUsage:
+            registerRobotCPUUsage (event.value);
+            break;
+        case EventBus::kRamUsage:
+            registerRobotRAMUsage (event.value);
+            break;
+        case EventBus::kAlliance:
+            registerAlliance ((DS::Alliance) event.value);
+            break;
+        case EventBus::kPosition:
+            registerPosition ((DS::Position) event.value);
+            break;
+        case EventBus::kPacketLoss:
+            registerPacketLoss (event.value);
+            break;
+        case EventBus::kCodeStatus:
+            registerCodeStatus ((DS::CodeStatus) event.value);
+            break;
+        case EventBus::kControlMode:
+            registerControlMode ((DS::ControlMode) event.value);
+            break;
+        case EventBus::kEnableStatus:
+            registerEnableStatus ((DS::EnableStatus) event.value);
+            break;
+        case EventBus::kVoltageStatus:
+            registerVoltageStatus ((DS::VoltageStatus) event.value);
+            break;
+        case EventBus::kRadioCommStatus:
+            registerRadioCommStatus ((DS::CommStatus) event.value);
+            break;
+        case EventBus::kRobotCommStatus:
+            registerRobotCommStatus ((DS::CommStatus) event.value);
+            break;
+        case EventBus::kOperationStatus:
+            registerOperationStatus ((DS::OperationStatus) event.value);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
 /**
  * Registers the inital robot events in the event lists
  */
@@ -341,7 +423,8 @@ void Logger::registerInitialEvents() {
 void Logger::registerVoltage (qreal voltage) {
     if (m_previousVoltage != voltage) {
         m_previousVoltage = voltage;
-        m_voltage.append (qMakePair (m_timer->elapsed(), voltage));
+        m_voltage.append (qMakePair (elapsedTime(), voltage));
+        ++m_events;
     }
 }
 
@@ -353,7 +436,8 @@ void Logger::registerVoltage (qreal voltage) {
 void Logger::registerPacketLoss (int pktLoss) {
     if (pktLoss != m_previousLoss) {
         m_previousLoss = pktLoss;
-        m_pktLoss.append (qMakePair (m_timer->elapsed(), pktLoss));
+        m_pktLoss.append (qMakePair (elapsedTime(), pktLoss));
+        ++m_events;
     }
 }
 
@@ -365,7 +449,8 @@ void Logger::registerPacketLoss (int pktLoss) {
 void Logger::registerRobotRAMUsage (int usage) {
     if (m_previousRAM != usage) {
         m_previousRAM = usage;
-        m_ramUsage.append (qMakePair (m_timer->elapsed(), usage));
+        m_ramUsage.append (qMakePair (elapsedTime(), usage));
+        ++m_events;
     }
 }
 
@@ -377,7 +462,8 @@ void Logger::registerRobotRAMUsage (int usage) {
 void Logger::registerRobotCPUUsage (int usage) {
     if (m_previousCPU != usage) {
         m_previousCPU = usage;
-        m_cpuUsage.append (qMakePair (m_timer->elapsed(), usage));
+        m_cpuUsage.append (qMakePair (elapsedTime(), usage));
+        ++m_events;
     }
 }
 
@@ -403,7 +489,8 @@ void Logger::registerPosition (DS::Position position) {
 void Logger::registerControlMode (DS::ControlMode mode) {
     if (m_previousControlMode != mode) {
         m_previousControlMode = mode;
-        m_controlMode.append (qMakePair (m_timer->elapsed(), mode));
+        m_controlMode.append (qMakePair (elapsedTime(), mode));
+        ++m_events;
         qDebug() << "Robot control mode set to" << mode;
     }
 }
@@ -416,7 +503,8 @@ void Logger::registerControlMode (DS::ControlMode mode) {
 void Logger::registerCodeStatus (DS::CodeStatus status) {
     if (m_previousCodeStatus != status) {
         m_previousCodeStatus = status;
-        m_codeStatus.append (qMakePair (m_timer->elapsed(), status));
+        m_codeStatus.append (qMakePair (elapsedTime(), status));
+        ++m_events;
         qDebug() << "Robot code status set to" << status;
     }
 }
@@ -429,7 +517,8 @@ void Logger::registerCodeStatus (DS::CodeStatus status) {
 void Logger::registerEnableStatus (DS::EnableStatus status) {
     if (m_previousEnabledStatus != status) {
         m_previousEnabledStatus = status;
-        m_enabledStatus.append (qMakePair (m_timer->elapsed(), status));
+        m_enabledStatus.append (qMakePair (elapsedTime(), status));
+        ++m_events;
         qDebug() << "Robot enabled status set to" << status;
     }
 }
@@ -442,7 +531,8 @@ void Logger::registerEnableStatus (DS::EnableStatus status) {
 void Logger::registerRadioCommStatus (DS::CommStatus status) {
     if (m_previousRadioCommStatus != status) {
         m_previousRadioCommStatus = status;
-        m_radioCommStatus.append (qMakePair (m_timer->elapsed(), status));
+        m_radioCommStatus.append (qMakePair (elapsedTime(), status));
+        ++m_events;
         qDebug() << "Radio communication status set to" << status;
     }
 }
@@ -455,7 +545,8 @@ void Logger::registerRadioCommStatus (DS::CommStatus status) {
 void Logger::registerRobotCommStatus (DS::CommStatus status) {
     if (m_previousRobotCommStatus != status) {
         m_previousRobotCommStatus = status;
-        m_robotCommStatus.append (qMakePair (m_timer->elapsed(), status));
+        m_robotCommStatus.append (qMakePair (elapsedTime(), status));
+        ++m_events;
         qDebug() << "Robot communication status set to" << status;
     }
 }
@@ -468,7 +559,8 @@ void Logger::registerRobotCommStatus (DS::CommStatus status) {
 void Logger::registerVoltageStatus (DS::VoltageStatus status) {
     if (m_previousVoltageStatus != status) {
         m_previousVoltageStatus = status;
-        m_voltageStatus.append (qMakePair (m_timer->elapsed(), status));
+        m_voltageStatus.append (qMakePair (elapsedTime(), status));
+        ++m_events;
         qDebug() << "Robot voltage status set to" << status;
     }
 }
@@ -488,7 +580,8 @@ void Logger::registerNetConsoleMessage (const QString& message) {
 void Logger::registerOperationStatus (DS::OperationStatus status) {
     if (m_previousOperationStatus != status) {
         m_previousOperationStatus = status;
-        m_operationStatus.append (qMakePair (m_timer->elapsed(), status));
+        m_operationStatus.append (qMakePair (elapsedTime(), status));
+        ++m_events;
         qDebug() << "Radio operation status set to" << status;
     }
 }
@@ -551,3 +644,10 @@ void Logger::initializeLogger() {
     fprintf (m_dump, PRINT_FMT, "ELAPSED TIME", "ERROR LEVEL", "MESSAGE");
     fprintf (m_dump, "%s\n", PRINT (REPEAT ("-", 72)));
 }
+
+/**
+ * Returns the milliseconds elapsed since the logger was created
+ */
+qint64 Logger::elapsedTime() const {
+    return Clock::getInstance()->elapsed() - m_startTime;
+}
@@ -9,9 +9,9 @@
 #ifndef _LIB_DS_ROBOT_LOGGER_H
 #define _LIB_DS_ROBOT_LOGGER_H
 
+#include <atomic>
 #include <Core/DS_Common.h>
-
-class QElapsedTimer;
+#include <Core/EventBus.h>
 
 /**
  * \brief Creates and reads files with robot events and application logs
@@ -26,10 +26,25 @@ class Logger : public QObject {
     void logsSaved (const QString& file);
 
   public:
-    explicit Logger();
+    explicit Logger (const QString& name = "");
+
+    static const quint32 EVENTS = (1u << EventBus::kVoltage)
+                                  | (1u << EventBus::kCpuUsage)
+                                  | (1u << EventBus::kRamUsage)
+                                  | (1u << EventBus::kAlliance)
+                                  | (1u << EventBus::kPosition)
+                                  | (1u << EventBus::kPacketLoss)
+                                  | (1u << EventBus::kCodeStatus)
+                                  | (1u << EventBus::kControlMode)
+                                  | (1u << EventBus::kEnableStatus)
+                                  | (1u << EventBus::kVoltageStatus)
+                                  | (1u << EventBus::kRadioCommStatus)
+                                  | (1u << EventBus::kRobotCommStatus)
+                                  | (1u << EventBus::kOperationStatus);
 
     QString logsPath() const;
     QString extension() const;
+    int eventCount() const;
     QStringList availableLogs() const;
     QJsonDocument openLog (const QString& name) const;
 
@@ -37,9 +52,12 @@ class Logger : public QObject {
                          const QMessageLogContext& context,
                          const QString& data);
 
+    void setEvents (const EventBus::Subscription& events);
+
   public slots:
     void saveLogs();
     void closeLogs();
+    void processEvents();
     void registerInitialEvents();
     void registerVoltage (qreal voltage);
     void registerPacketLoss (int pktLoss);
@@ -59,10 +77,15 @@ class Logger : public QObject {
   private slots:
     void initializeLogger();
 
+  private:
+    qint64 elapsedTime() const;
+
   private:
     QString m_netConsole;
-    QElapsedTimer* m_timer;
+    qint64 m_startTime;
+    EventBus::Subscription m_subscription;
     bool m_eventsRegistered;
+    std::atomic<int> m_events;
 
     /* Used for console output (both to stderr and a dump file) */
     FILE* m_dump;
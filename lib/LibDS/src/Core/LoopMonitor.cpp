@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "LoopMonitor.h"
+
+#include <Utilities/Clock.h>
+
+LoopMonitor::LoopMonitor() {
+    for (int i = 0; i < LOOP_COUNT; ++i)
+        m_loops [i].period = 0;
+
+    reset();
+}
+
+/**
+ * Returns the current time of the clock used by the LibDS (see \c Clock),
+ * in microseconds
+ */
+qint64 LoopMonitor::timestamp() {
+    return Clock::getInstance()->nsecsElapsed() / 1000;
+}
+
+/**
+ * Returns a human-readable name of the given \a loop
+ */
+QString LoopMonitor::loopName (int loop) {
+    switch (loop) {
+    case kRobotPackets:
+        return "Robot packets";
+    case kFMSPackets:
+        return "FMS packets";
+    case kRadioPackets:
+        return "Radio packets";
+    case kPacketLoss:
+        return "Packet loss";
+    case kElapsedTime:
+        return "Elapsed time";
+    default:
+        return "Invalid";
+    }
+}
+
+/**
+ * Returns the expected period (in milliseconds) of the given \a loop
+ */
+int LoopMonitor::period (int loop) const {
+    if (isValid (loop))
+        return m_loops [loop].period;
+
+    return 0;
+}
+
+/**
+ * Returns the largest difference (in microseconds) between the measured and
+ * the expected period of the given \a loop. A loop that always fired early
+ * has a lateness of \c 0.
+ */
+qint64 LoopMonitor::maxLateness (int loop) const {
+    if (isValid (loop))
+        return m_loops [loop].maxLateness;
+
+    return 0;
+}
+
+/**
+ * Returns a single-line summary of the measured intervals (in microseconds)
+ * and the worst-case lateness of the given \a loop
+ */
+QString LoopMonitor::summary (int loop) const {
+    if (!isValid (loop))
+        return "";
+
+    return QString ("%1: period=%2ms %3 late=%4us")
+           .arg (loopName (loop))
+           .arg (m_loops [loop].period)
+           .arg (m_loops [loop].intervals.summary())
+           .arg (m_loops [loop].maxLateness);
+}
+
+/**
+ * Returns the histogram with the intervals (in microseconds) measured between
+ * consecutive fires of the given \a loop, or \c NULL if the loop is invalid
+ */
+const Histogram* LoopMonitor::intervals (int loop) const {
+    if (isValid (loop))
+        return &m_loops [loop].intervals;
+
+    return Q_NULLPTR;
+}
+
+/**
+ * Clears the statistics of every loop
+ */
+void LoopMonitor::reset() {
+    for (int i = 0; i < LOOP_COUNT; ++i)
+        reset (i);
+}
+
+/**
+ * Clears the statistics of the given \a loop. The next fire of the loop will
+ * not be measured, since there is no previous fire to compare it with.
+ */
+void LoopMonitor::reset (int loop) {
+    if (isValid (loop)) {
+        m_loops [loop].lastFire = -1;
+        m_loops [loop].maxLateness = 0;
+        m_loops [loop].intervals.reset();
+    }
+}
+
+/**
+ * Registers that the given \a loop has just fired
+ */
+void LoopMonitor::mark (int loop) {
+    mark (loop, timestamp());
+}
+
+/**
+ * Registers that the given \a loop fired at the given \a time (in
+ * microseconds), e.g. the time of the tick of an externally clocked DS
+ */
+void LoopMonitor::mark (int loop, qint64 time) {
+    if (!isValid (loop))
+        return;
+
+    State* state = &m_loops [loop];
+    if (state->lastFire >= 0) {
+        qint64 interval = time - state->lastFire;
+        qint64 lateness = interval - state->period * 1000;
+
+        state->intervals.record (interval);
+        state->maxLateness = qMax (state->maxLateness, lateness);
+    }
+
+    state->lastFire = time;
+}
+
+/**
+ * Changes the expected period (in milliseconds) of the given \a loop. The
+ * statistics of the loop are cleared if the period changes.
+ */
+void LoopMonitor::setPeriod (int loop, int msecs) {
+    if (isValid (loop) && m_loops [loop].period != msecs) {
+        m_loops [loop].period = msecs;
+        reset (loop);
+    }
+}
+
+/**
+ * Returns \c true if the given \a loop exists
+ */
+bool LoopMonitor::isValid (int loop) {
+    return loop >= 0 && loop < LOOP_COUNT;
+}
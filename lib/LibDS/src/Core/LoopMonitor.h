@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_LOOP_MONITOR_H
+#define _LIB_DS_LOOP_MONITOR_H
+
+#include <Utilities/Histogram.h>
+
+/**
+ * \brief Measures the drift and jitter of the periodic DS loops
+ *
+ * Each loop calls \c mark() when it fires. The time elapsed since the
+ * previous fire (in microseconds) is recorded in a histogram and compared
+ * with the configured period of the loop, which allows us to know the
+ * worst-case lateness of the loop (e.g. to verify that the robot packets
+ * are really sent at 50 Hz on a given computer).
+ *
+ * \note This class is not thread-safe, all the loops of a DS run in the
+ *       thread of the DS
+ */
+class LoopMonitor {
+  public:
+    explicit LoopMonitor();
+
+    enum Loop {
+        kRobotPackets  = 0,
+        kFMSPackets    = 1,
+        kRadioPackets  = 2,
+        kPacketLoss    = 3,
+        kElapsedTime   = 4,
+    };
+
+    static const int LOOP_COUNT = 5;
+
+    static qint64 timestamp();
+    static QString loopName (int loop);
+
+    int period (int loop) const;
+    qint64 maxLateness (int loop) const;
+    QString summary (int loop) const;
+    const Histogram* intervals (int loop) const;
+
+    void reset();
+    void reset (int loop);
+    void mark (int loop);
+    void mark (int loop, qint64 time);
+    void setPeriod (int loop, int msecs);
+
+  private:
+    static bool isValid (int loop);
+
+  private:
+    struct State {
+        int period;
+        qint64 lastFire;
+        qint64 maxLateness;
+        Histogram intervals;
+    };
+
+    State m_loops [LOOP_COUNT];
+};
+
+#endif
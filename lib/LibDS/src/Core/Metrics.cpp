@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Metrics.h"
+
+/* All metrics are independent, so we do not need any ordering guarantees */
+const std::memory_order ORDER = std::memory_order_relaxed;
+
+Metrics::Metrics() {
+    reset();
+}
+
+/**
+ * Returns the number of packets sent to the given \a target
+ */
+quint64 Metrics::sentPackets (int target) const {
+    return isValid (target) ? m_sent [target].load (ORDER) : 0;
+}
+
+/**
+ * Returns the number of packets received from the given \a target
+ */
+quint64 Metrics::receivedPackets (int target) const {
+    return isValid (target) ? m_received [target].load (ORDER) : 0;
+}
+
+/**
+ * Returns the number of times that the watchdog of the given \a target
+ * expired
+ */
+quint64 Metrics::watchdogExpirations (int target) const {
+    return isValid (target) ? m_expirations [target].load (ORDER) : 0;
+}
+
+/**
+ * Returns the last sampled CPU usage of the robot
+ */
+int Metrics::cpuUsage() const {
+    return m_cpuUsage.load (ORDER);
+}
+
+/**
+ * Returns the last sampled number of events held by the robot logger
+ */
+int Metrics::logEvents() const {
+    return m_logEvents.load (ORDER);
+}
+
+/**
+ * Returns the last calculated robot packet loss
+ */
+int Metrics::packetLoss() const {
+    return m_packetLoss.load (ORDER);
+}
+
+/**
+ * Returns the last sampled robot voltage
+ */
+qreal Metrics::voltage() const {
+    return m_millivolts.load (ORDER) / 1000.0;
+}
+
+/**
+ * Returns the last measured round-trip time (in microseconds) between
+ * sending a robot packet and receiving its echo
+ */
+qint64 Metrics::lastRoundTrip() const {
+    return m_lastRoundTrip.load (ORDER);
+}
+
+/**
+ * Returns the sum (in microseconds) of every measured round-trip time
+ */
+qint64 Metrics::totalRoundTrip() const {
+    return m_totalRoundTrip.load (ORDER);
+}
+
+/**
+ * Returns the number of measured round-trip times
+ */
+quint64 Metrics::roundTripCount() const {
+    return m_roundTrips.load (ORDER);
+}
+
+/**
+ * Clears every counter and gauge
+ */
+void Metrics::reset() {
+    for (int i = 0; i < TARGET_COUNT; ++i) {
+        m_sent [i].store (0, ORDER);
+        m_received [i].store (0, ORDER);
+        m_expirations [i].store (0, ORDER);
+    }
+
+    m_cpuUsage.store (0, ORDER);
+    m_logEvents.store (0, ORDER);
+    m_packetLoss.store (0, ORDER);
+    m_millivolts.store (0, ORDER);
+    m_lastRoundTrip.store (0, ORDER);
+    m_totalRoundTrip.store (0, ORDER);
+    m_roundTrips.store (0, ORDER);
+}
+
+/**
+ * Registers that a packet was sent to the given \a target
+ */
+void Metrics::packetSent (int target) {
+    if (isValid (target))
+        m_sent [target].fetch_add (1, ORDER);
+}
+
+/**
+ * Registers that a packet was received from the given \a target
+ */
+void Metrics::packetReceived (int target) {
+    if (isValid (target))
+        m_received [target].fetch_add (1, ORDER);
+}
+
+/**
+ * Registers that the watchdog of the given \a target expired
+ */
+void Metrics::watchdogExpired (int target) {
+    if (isValid (target))
+        m_expirations [target].fetch_add (1, ORDER);
+}
+
+/**
+ * Adds a round-trip time of \a usecs microseconds
+ */
+void Metrics::recordRoundTrip (qint64 usecs) {
+    m_lastRoundTrip.store (usecs, ORDER);
+    m_totalRoundTrip.fetch_add (usecs, ORDER);
+    m_roundTrips.fetch_add (1, ORDER);
+}
+
+/**
+ * Changes the CPU \a usage of the robot
+ */
+void Metrics::setCpuUsage (int usage) {
+    m_cpuUsage.store (usage, ORDER);
+}
+
+/**
+ * Changes the number of \a events held by the robot logger
+ */
+void Metrics::setLogEvents (int events) {
+    m_logEvents.store (events, ORDER);
+}
+
+/**
+ * Changes the robot packet \a loss
+ */
+void Metrics::setPacketLoss (int loss) {
+    m_packetLoss.store (loss, ORDER);
+}
+
+/**
+ * Changes the robot \a voltage
+ */
+void Metrics::setVoltage (qreal voltage) {
+    m_millivolts.store (qRound (voltage * 1000), ORDER);
+}
+
+/**
+ * Returns \c true if the given \a target exists
+ */
+bool Metrics::isValid (int target) {
+    return target >= 0 && target < TARGET_COUNT;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_METRICS_H
+#define _LIB_DS_METRICS_H
+
+#include <atomic>
+#include <QtGlobal>
+
+/**
+ * \brief Health counters and gauges of a DS, readable from any thread
+ *
+ * Counters (packets, watchdog expirations and round-trip times) are updated
+ * by the DS when the events happen. Gauges (packet loss, voltage, CPU usage
+ * and logger events) are sampled by the DS every time that the packet loss
+ * is calculated.
+ *
+ * Every value is stored in an atomic variable, so that the metrics can be
+ * read (e.g. by a \c MetricsServer running in another thread) without
+ * locking the packet loop.
+ */
+class Metrics {
+  public:
+    explicit Metrics();
+
+    enum Target {
+        kFMS   = 0,
+        kRadio = 1,
+        kRobot = 2,
+    };
+
+    static const int TARGET_COUNT = 3;
+
+    quint64 sentPackets (int target) const;
+    quint64 receivedPackets (int target) const;
+    quint64 watchdogExpirations (int target) const;
+
+    int cpuUsage() const;
+    int logEvents() const;
+    int packetLoss() const;
+    qreal voltage() const;
+
+    qint64 lastRoundTrip() const;
+    qint64 totalRoundTrip() const;
+    quint64 roundTripCount() const;
+
+    void reset();
+    void packetSent (int target);
+    void packetReceived (int target);
+    void watchdogExpired (int target);
+    void recordRoundTrip (qint64 usecs);
+
+    void setCpuUsage (int usage);
+    void setLogEvents (int events);
+    void setPacketLoss (int loss);
+    void setVoltage (qreal voltage);
+
+  private:
+    static bool isValid (int target);
+
+  private:
+    std::atomic<quint64> m_sent [TARGET_COUNT];
+    std::atomic<quint64> m_received [TARGET_COUNT];
+    std::atomic<quint64> m_expirations [TARGET_COUNT];
+
+    std::atomic<int> m_cpuUsage;
+    std::atomic<int> m_logEvents;
+    std::atomic<int> m_packetLoss;
+    std::atomic<int> m_millivolts;
+
+    std::atomic<qint64> m_lastRoundTrip;
+    std::atomic<qint64> m_totalRoundTrip;
+    std::atomic<quint64> m_roundTrips;
+};
+
+#endif
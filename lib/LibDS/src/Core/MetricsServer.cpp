@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Metrics.h"
+#include "MetricsServer.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+/* Requests larger than this are rejected */
+const int MAX_REQUEST_SIZE = 8 * 1024;
+
+/* Label values of each metrics target */
+static const char* TARGET_LABELS [Metrics::TARGET_COUNT] = {
+    "fms", "radio", "robot"
+};
+
+/**
+ * Returns the given \a value escaped as a Prometheus label value
+ */
+static QString ESCAPE (QString value) {
+    return value.replace ("\\", "\\\\")
+           .replace ("\"", "\\\"")
+           .replace ("\n", "\\n");
+}
+
+/**
+ * Returns the label set of a sample, made of the \a instance of the source
+ * (if any) and the given \a extra label
+ */
+static QString LABELS (const QString& instance, const QString& extra = "") {
+    QStringList labels;
+
+    if (!instance.isEmpty())
+        labels.append (QString ("instance=\"%1\"").arg (ESCAPE (instance)));
+
+    if (!extra.isEmpty())
+        labels.append (extra);
+
+    if (labels.isEmpty())
+        return "";
+
+    return "{" + labels.join (",") + "}";
+}
+
+/**
+ * Appends the help and type lines of a metric family to the \a output
+ */
+static void HEADER (QString* output, const char* name,
+                    const char* type, const char* help) {
+    output->append (QString ("# HELP %1 %2\n").arg (name, help));
+    output->append (QString ("# TYPE %1 %2\n").arg (name, type));
+}
+
+MetricsServer::MetricsServer (QObject* parent) : QObject (parent) {
+    m_tcpServer = Q_NULLPTR;
+    m_localServer = Q_NULLPTR;
+}
+
+/**
+ * Stops listening for requests
+ */
+MetricsServer::~MetricsServer() {
+    close();
+}
+
+/**
+ * Returns \c true if the server is listening on a TCP port or on a local
+ * socket
+ */
+bool MetricsServer::isListening() const {
+    return (m_tcpServer && m_tcpServer->isListening())
+           || (m_localServer && m_localServer->isListening());
+}
+
+/**
+ * Serves the given \a metrics. If the server has more than one source, the
+ * \a instance label is used to distinguish them.
+ *
+ * \note The \a metrics must outlive the server (or be removed first)
+ */
+void MetricsServer::addSource (const Metrics* metrics,
+                               const QString& instance) {
+    if (metrics) {
+        removeSource (metrics);
+        m_sources.append (qMakePair (metrics, instance));
+    }
+}
+
+/**
+ * Stops serving the given \a metrics
+ */
+void MetricsServer::removeSource (const Metrics* metrics) {
+    for (int i = m_sources.count() - 1; i >= 0; --i) {
+        if (m_sources.at (i).first == metrics)
+            m_sources.removeAt (i);
+    }
+}
+
+/**
+ * Returns the metrics of every source in the Prometheus text format
+ */
+QByteArray MetricsServer::render() const {
+    QString output;
+    typedef QPair<const Metrics*, QString> Source;
+
+    HEADER (&output, "ds_packets_sent_total", "counter",
+            "Packets sent by the DS");
+    foreach (const Source& source, m_sources) {
+        for (int i = 0; i < Metrics::TARGET_COUNT; ++i)
+            output.append (QString ("ds_packets_sent_total%1 %2\n")
+                           .arg (LABELS (source.second, QString ("target=\"%1\"")
+                                         .arg (TARGET_LABELS [i])))
+                           .arg (source.first->sentPackets (i)));
+    }
+
+    HEADER (&output, "ds_packets_received_total", "counter",
+            "Packets received by the DS");
+    foreach (const Source& source, m_sources) {
+        for (int i = 0; i < Metrics::TARGET_COUNT; ++i)
+            output.append (QString ("ds_packets_received_total%1 %2\n")
+                           .arg (LABELS (source.second, QString ("target=\"%1\"")
+                                         .arg (TARGET_LABELS [i])))
+                           .arg (source.first->receivedPackets (i)));
+    }
+
+    HEADER (&output, "ds_watchdog_expirations_total", "counter",
+            "Times that the communications watchdog expired");
+    foreach (const Source& source, m_sources) {
+        for (int i = 0; i < Metrics::TARGET_COUNT; ++i)
+            output.append (QString ("ds_watchdog_expirations_total%1 %2\n")
+                           .arg (LABELS (source.second, QString ("target=\"%1\"")
+                                         .arg (TARGET_LABELS [i])))
+                           .arg (source.first->watchdogExpirations (i)));
+    }
+
+    HEADER (&output, "ds_robot_packet_loss_percent", "gauge",
+            "Robot packet loss");
+    foreach (const Source& source, m_sources)
+        output.append (QString ("ds_robot_packet_loss_percent%1 %2\n")
+                       .arg (LABELS (source.second))
+                       .arg (source.first->packetLoss()));
+
+    HEADER (&output, "ds_robot_rtt_seconds", "summary",
+            "Round-trip time of the robot packets");
+    foreach (const Source& source, m_sources) {
+        output.append (QString ("ds_robot_rtt_seconds_sum%1 %2\n")
+                       .arg (LABELS (source.second))
+                       .arg (source.first->totalRoundTrip() / 1e6, 0, 'f', 6));
+        output.append (QString ("ds_robot_rtt_seconds_count%1 %2\n")
+                       .arg (LABELS (source.second))
+                       .arg (source.first->roundTripCount()));
+    }
+
+    HEADER (&output, "ds_robot_rtt_last_seconds", "gauge",
+            "Last measured round-trip time of the robot packets");
+    foreach (const Source& source, m_sources)
+        output.append (QString ("ds_robot_rtt_last_seconds%1 %2\n")
+                       .arg (LABELS (source.second))
+                       .arg (source.first->lastRoundTrip() / 1e6, 0, 'f', 6));
+
+    HEADER (&output, "ds_log_events", "gauge",
+            "Robot events held in memory by the logger");
+    foreach (const Source& source, m_sources)
+        output.append (QString ("ds_log_events%1 %2\n")
+                       .arg (LABELS (source.second))
+                       .arg (source.first->logEvents()));
+
+    HEADER (&output, "ds_robot_voltage_volts", "gauge",
+            "Robot battery voltage");
+    foreach (const Source& source, m_sources)
+        output.append (QString ("ds_robot_voltage_volts%1 %2\n")
+                       .arg (LABELS (source.second))
+                       .arg (source.first->voltage(), 0, 'f', 3));
+
+    HEADER (&output, "ds_robot_cpu_percent", "gauge",
+            "Robot CPU usage");
+    foreach (const Source& source, m_sources)
+        output.append (QString ("ds_robot_cpu_percent%1 %2\n")
+                       .arg (LABELS (source.second))
+                       .arg (source.first->cpuUsage()));
+
+    return output.toUtf8();
+}
+
+/**
+ * Stops listening for requests
+ */
+void MetricsServer::close() {
+    if (m_tcpServer) {
+        m_tcpServer->close();
+        m_tcpServer->deleteLater();
+        m_tcpServer = Q_NULLPTR;
+    }
+
+    if (m_localServer) {
+        m_localServer->close();
+        m_localServer->deleteLater();
+        m_localServer = Q_NULLPTR;
+    }
+}
+
+/**
+ * Serves the metrics over HTTP on the given TCP \a port of the loopback
+ * interface. Returns \c false if the port cannot be used.
+ */
+bool MetricsServer::listen (quint16 port) {
+    if (m_tcpServer) {
+        m_tcpServer->close();
+        m_tcpServer->deleteLater();
+    }
+
+    m_tcpServer = new QTcpServer (this);
+    connect (m_tcpServer, SIGNAL (newConnection()),
+             this,          SLOT (onNewConnection()));
+
+    if (!m_tcpServer->listen (QHostAddress::LocalHost, port)) {
+        qWarning() << "Cannot serve metrics on port" << port
+                   << m_tcpServer->errorString();
+        return false;
+    }
+
+    qDebug() << "Serving metrics on port" << port;
+    return true;
+}
+
+/**
+ * Serves the metrics over HTTP on the local socket with the given \a name
+ * (a Unix domain socket or a named pipe, depending on the operating system).
+ * Returns \c false if the socket cannot be created.
+ */
+bool MetricsServer::listenLocal (const QString& name) {
+    if (m_localServer) {
+        m_localServer->close();
+        m_localServer->deleteLater();
+    }
+
+    m_localServer = new QLocalServer (this);
+    connect (m_localServer, SIGNAL (newConnection()),
+             this,            SLOT (onNewConnection()));
+
+    QLocalServer::removeServer (name);
+    if (!m_localServer->listen (name)) {
+        qWarning() << "Cannot serve metrics on" << name
+                   << m_localServer->errorString();
+        return false;
+    }
+
+    qDebug() << "Serving metrics on" << m_localServer->fullServerName();
+    return true;
+}
+
+/**
+ * Waits for the requests of the new clients
+ */
+void MetricsServer::onNewConnection() {
+    while (m_tcpServer && m_tcpServer->hasPendingConnections()) {
+        QTcpSocket* socket = m_tcpServer->nextPendingConnection();
+        connect (socket, SIGNAL (readyRead()),    this,   SLOT (onReadyRead()));
+        connect (socket, SIGNAL (disconnected()), socket, SLOT (deleteLater()));
+    }
+
+    while (m_localServer && m_localServer->hasPendingConnections()) {
+        QLocalSocket* socket = m_localServer->nextPendingConnection();
+        connect (socket, SIGNAL (readyRead()),    this,   SLOT (onReadyRead()));
+        connect (socket, SIGNAL (disconnected()), socket, SLOT (deleteLater()));
+    }
+}
+
+/**
+ * Answers the request of a client once its headers have been received, and
+ * closes the connection
+ */
+void MetricsServer::onReadyRead() {
+    QIODevice* socket = qobject_cast<QIODevice*> (sender());
+    if (!socket)
+        return;
+
+    /* Wait until we have the complete request headers */
+    QByteArray request = socket->peek (MAX_REQUEST_SIZE);
+    bool complete = request.contains ("\r\n\r\n") || request.contains ("\n\n");
+    if (!complete && request.size() < MAX_REQUEST_SIZE)
+        return;
+
+    socket->readAll();
+
+    /* Generate the response */
+    QByteArray body;
+    QByteArray status = "200 OK";
+    QByteArray type = "text/plain; version=0.0.4; charset=utf-8";
+    if (!complete) {
+        status = "413 Request Entity Too Large";
+        type = "text/plain";
+    }
+
+    else if (!request.startsWith ("GET ")) {
+        status = "405 Method Not Allowed";
+        type = "text/plain";
+    }
+
+    else
+        body = render();
+
+    socket->write ("HTTP/1.0 " + status + "\r\n"
+                   + "Content-Type: " + type + "\r\n"
+                   + "Content-Length: " + QByteArray::number (body.size())
+                   + "\r\n"
+                   + "Connection: close\r\n\r\n"
+                   + body);
+
+    /* Close the connection once the response has been written */
+    QTcpSocket* tcpSocket = qobject_cast<QTcpSocket*> (socket);
+    QLocalSocket* localSocket = qobject_cast<QLocalSocket*> (socket);
+    if (tcpSocket)
+        tcpSocket->disconnectFromHost();
+    else if (localSocket)
+        localSocket->disconnectFromServer();
+}
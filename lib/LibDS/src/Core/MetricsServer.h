@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_METRICS_SERVER_H
+#define _LIB_DS_METRICS_SERVER_H
+
+#include <Core/DS_Common.h>
+
+class Metrics;
+class QTcpServer;
+class QLocalServer;
+
+/**
+ * \brief Serves the DS metrics in the Prometheus text format
+ *
+ * The server answers every HTTP request with the current value of the
+ * metrics of the registered sources (e.g. each engine of a \c Fleet), so that
+ * they can be scraped by Prometheus and displayed in Grafana. The server
+ * can listen on a local TCP port and/or on a local (Unix domain) socket.
+ *
+ * The metrics are read from atomic variables, so serving a request never
+ * blocks the packet loop of the DS.
+ *
+ * \note The TCP server only listens on the loopback interface
+ */
+class MetricsServer : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit MetricsServer (QObject* parent = Q_NULLPTR);
+    ~MetricsServer();
+
+    bool isListening() const;
+    void addSource (const Metrics* metrics, const QString& instance = "");
+    void removeSource (const Metrics* metrics);
+
+    QByteArray render() const;
+
+  public slots:
+    void close();
+    bool listen (quint16 port);
+    bool listenLocal (const QString& name);
+
+  private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+  private:
+    QTcpServer* m_tcpServer;
+    QLocalServer* m_localServer;
+    QList<QPair<const Metrics*, QString>> m_sources;
+};
+
+#endif
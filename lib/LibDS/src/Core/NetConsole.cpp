@@ -8,22 +8,60 @@
 
 #include "DS_Common.h"
 #include "NetConsole.h"
+#include "SocketTuning.h"
 
 NetConsole::NetConsole() {
     m_outputPort = 0;
+    m_kernelDrops = 0;
+    m_socketProfile = DS::kSocketProfileDefault;
+
     connect (&m_inputSocket, &QUdpSocket::readyRead, [ = ]() {
-        emit newMessage (QString::fromUtf8 (DS::readSocket (&m_inputSocket)));
+        QByteArray data = SocketTuning::readDatagrams (&m_inputSocket,
+                                                       m_socketProfile,
+                                                       &m_kernelDrops);
+        emit newMessage (QString::fromUtf8 (data));
     });
 }
 
+/**
+ * Returns the number of NetConsole datagrams dropped by the kernel because
+ * the receive buffer of the input socket was full.
+ *
+ * \note This value is only updated when the low-latency profile is active
+ */
+quint32 NetConsole::kernelDrops() const {
+    return m_kernelDrops;
+}
+
+/**
+ * Returns the tuning profile applied to the NetConsole sockets
+ */
+DS::SocketProfile NetConsole::socketProfile() const {
+    return m_socketProfile;
+}
+
 /**
  * Changes the port in which we receive broadcasted robot messages.
  * If the \a port is set to \c 0, then the \c NetConsole will disable the
  * input socket.
  */
 void NetConsole::setInputPort (int port) {
-    if (port != DS_DISABLED_PORT)
+    if (port != DS_DISABLED_PORT) {
         m_inputSocket.bind (QHostAddress::Broadcast, port, DS_BIND_MODE);
+        SocketTuning::apply (&m_inputSocket, m_socketProfile, false);
+    }
+}
+
+/**
+ * Changes the tuning \a profile of the NetConsole sockets.
+ *
+ * \note NetConsole messages are not considered control traffic, so only the
+ *       buffer sizes, busy-polling and the kernel drop counter are affected
+ */
+void NetConsole::setSocketProfile (DS::SocketProfile profile) {
+    m_socketProfile = profile;
+    SocketTuning::apply (&m_inputSocket, profile, false);
+    SocketTuning::apply (&m_outputSocket, profile, false);
 }
 
 /**
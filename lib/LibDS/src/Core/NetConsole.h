@@ -27,13 +27,19 @@ class NetConsole : public QObject {
   public:
     explicit NetConsole();
 
+    quint32 kernelDrops() const;
+    DS::SocketProfile socketProfile() const;
+
   public slots:
     void setInputPort (int port);
+    void setSocketProfile (DS::SocketProfile profile);
     void setOutputPort (int port);
     void sendMessage (const QString& message);
 
   private:
     int m_outputPort;
+    quint32 m_kernelDrops;
+    DS::SocketProfile m_socketProfile;
     QUdpSocket m_inputSocket;
     QUdpSocket m_outputSocket;
 };
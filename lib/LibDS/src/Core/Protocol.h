@@ -31,6 +31,26 @@ class Protocol {
 
         m_recvRobotPacketsSinceConnect = 0;
         m_sentRobotPacketsSinceConnect = 0;
+
+        m_config = Q_NULLPTR;
+        m_driverStation = Q_NULLPTR;
+
+        m_joysticksEncoded = false;
+        m_joystickSnapshot.count = 0;
+    }
+
+    virtual ~Protocol() {}
+
+    /**
+     * Binds the protocol to the given \a driverStation and its \a config.
+     *
+     * This is done automatically by the \c DriverStation when the protocol is
+     * loaded. Protocols that are not bound to any Driver Station will use the
+     * global \c DriverStation and \c DS_Config instances.
+     */
+    void attach (DriverStation* driverStation, DS_Config* config) {
+        m_config = config;
+        m_driverStation = driverStation;
     }
 
     /**
@@ -232,6 +252,31 @@ class Protocol {
      */
     virtual void onRobotWatchdogExpired() {}
 
+    /**
+     * Returns the sequence number of the DS packet that is echoed by the
+     * given robot packet \a data, which is used to measure the round-trip
+     * time of the robot packets.
+     *
+     * \note If you do not re-implement this function, the round-trip time
+     *       will not be measured
+     */
+    virtual int robotPacketEcho (const QByteArray& data) {
+        Q_UNUSED (data);
+        return -1;
+    }
+
+    /**
+     * Returns \c true if the protocol can bring a robot packet that was
+     * generated ahead of time up to date without encoding it again (see
+     * \c updateRobotPacket()).
+     *
+     * \note If you do not re-implement this function, the Driver Station
+     *       will not generate robot packets ahead of their send deadline
+     */
+    virtual bool supportsRobotPacketPatching() {
+        return false;
+    }
+
     /**
      * Returns the socket type (UDP or TCP) used for client/FMS interacion.
      *
@@ -334,10 +379,55 @@ class Protocol {
     QByteArray generateRobotPacket() {
         ++m_sentRobotPackets;
         ++m_sentRobotPacketsSinceConnect;
+        m_joysticksEncoded = false;
 
         return getRobotPacket();
     }
 
+    /**
+     * Generates an out-of-band client-to-robot packet, used to notify the
+     * robot about safety-critical changes (e.g. an emergency stop) before
+     * the next periodic packet is due.
+     *
+     * The packet uses the sequence number of the next periodic packet, but
+     * the packet counters are not modified, so that the periodic cadence,
+     * numbering and packet loss calculations are not disturbed. The joystick
+     * snapshot of the last periodic packet is kept as well.
+     *
+     * If the next periodic packet was already generated ahead of its send
+     * deadline, \a pending must be \c true, so that the urgent packet reuses
+     * the sequence number of that packet instead of overtaking it.
+     */
+    QByteArray generateUrgentRobotPacket (bool pending = false) {
+        bool encoded = m_joysticksEncoded;
+        JoystickStore::Snapshot snapshot = m_joystickSnapshot;
+        int offset = pending ? 0 : 1;
+
+        m_sentRobotPackets += offset;
+        QByteArray data = getUrgentRobotPacket();
+        m_sentRobotPackets -= offset;
+
+        m_joysticksEncoded = encoded;
+        m_joystickSnapshot = snapshot;
+
+        return data;
+    }
+
+    /**
+     * Brings a robot \a packet that was generated ahead of its send deadline
+     * (with \c generateRobotPacket()) up to date, by sampling the current
+     * robot state and joystick values into it.
+     *
+     * The sequence number and the packet counters are not modified, since the
+     * packet was already accounted for when it was generated.
+     */
+    void patchRobotPacket (QByteArray* packet) {
+        if (packet) {
+            m_joysticksEncoded = false;
+            updateRobotPacket (packet);
+        }
+    }
+
     /**
      * Lets the protocol implementation interpret the given \a data and updates
      * the received FMS packets counter.
@@ -417,6 +507,20 @@ class Protocol {
         return m_sentRobotPackets;
     }
 
+    /**
+     * Returns \c true if the last robot packet contained joystick data
+     */
+    bool joysticksEncoded() const {
+        return m_joysticksEncoded;
+    }
+
+    /**
+     * Returns the joystick values that were encoded in the last robot packet
+     */
+    const JoystickStore::Snapshot& joystickSnapshot() const {
+        return m_joystickSnapshot;
+    }
+
     /**
      * Returns the number of packets received from the FMS
      */
@@ -465,6 +569,9 @@ class Protocol {
      * Gives direct access to the Driver Station variables/configs
      */
     DS_Config* config() {
+        if (m_config)
+            return m_config;
+
         return DS_Config::getInstance();
     }
 
@@ -472,9 +579,33 @@ class Protocol {
      * Gives direct access to the registered joysticks of the DS
      */
     DS_Joysticks* joysticks() {
+        if (m_driverStation)
+            return m_driverStation->joysticks();
+
         return DriverStation::getInstance()->joysticks();
     }
 
+    /**
+     * Gives access to the values of the registered joysticks of the DS
+     */
+    JoystickStore* joystickStore() {
+        if (m_driverStation)
+            return m_driverStation->joystickStore();
+
+        return DriverStation::getInstance()->joystickStore();
+    }
+
+    /**
+     * Takes a consistent copy of the joystick values, which should be used to
+     * encode the joystick data of the robot packet being generated. The DS
+     * uses the copy to know which joystick changes were sent to the robot.
+     */
+    const JoystickStore::Snapshot& takeJoystickSnapshot() {
+        joystickStore()->snapshot (&m_joystickSnapshot);
+        m_joysticksEncoded = true;
+        return m_joystickSnapshot;
+    }
+
     /**
      * Returns a packet that is sent to the FMS.
      *
@@ -505,6 +636,32 @@ class Protocol {
         return QByteArray();
     }
 
+    /**
+     * Returns an out-of-band packet that is sent to the robot, which must not
+     * change the state used to generate the periodic robot packets.
+     *
+     * \note If you do not re-implement this function, the packet will be
+     *       generated with \c getRobotPacket(). Re-implement it if generating
+     *       a robot packet changes the state of your protocol.
+     */
+    virtual QByteArray getUrgentRobotPacket() {
+        return getRobotPacket();
+    }
+
+    /**
+     * Updates the state and joystick data of the given pre-encoded robot
+     * \a packet, leaving its sequence number untouched.
+     *
+     * \note If you do not re-implement this function, the packet will be
+     *       generated again from scratch. This is always correct, but it
+     *       defeats the purpose of encoding the packet ahead of time, so
+     *       the Driver Station only pipelines the robot packets of the
+     *       protocols that re-implement \c supportsRobotPacketPatching().
+     */
+    virtual void updateRobotPacket (QByteArray* packet) {
+        *packet = getRobotPacket();
+    }
+
     /**
      * Interprets the \a data received from the FMS and adjusts the Driver
      * Station properties accordingly.
@@ -542,6 +699,12 @@ class Protocol {
 
     int m_recvRobotPacketsSinceConnect;
     int m_sentRobotPacketsSinceConnect;
+
+    DS_Config* m_config;
+    DriverStation* m_driverStation;
+
+    bool m_joysticksEncoded;
+    JoystickStore::Snapshot m_joystickSnapshot;
 };
 
 #endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "SocketTuning.h"
+
+#if defined Q_OS_LINUX
+#include <string.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#endif
+
+/* Buffer sizes used by the low-latency profile */
+const int LOW_LATENCY_SEND_BUFFER = 32 * 1024;
+const int LOW_LATENCY_RECV_BUFFER = 256 * 1024;
+
+/* DSCP EF (Expedited Forwarding, 46) shifted into the TOS byte */
+const int LOW_LATENCY_TOS = 0xB8;
+
+/* Highest priority that can be set without CAP_NET_ADMIN */
+const int LOW_LATENCY_PRIORITY = 6;
+
+/* Microseconds that the kernel may busy-poll the device queue */
+const int LOW_LATENCY_BUSY_POLL = 50;
+
+#if defined Q_OS_LINUX
+/**
+ * Changes the given integer socket \a option of the native socket \a fd.
+ * Failures are not fatal, most of them are caused by missing privileges
+ * (e.g. when raising \c SO_BUSY_POLL without \c CAP_NET_ADMIN).
+ */
+static void SET_NATIVE_OPTION (qintptr fd, int level, int option, int value) {
+    if (fd != -1)
+        setsockopt (fd, level, option, &value, sizeof (value));
+}
+#endif
+
+/**
+ * Applies the given socket \a profile to the given \a socket.
+ *
+ * If \a controlTraffic is set to \c true, the packets sent by the socket will
+ * be marked with DSCP EF and a high \c SO_PRIORITY, so that they are not
+ * queued behind bulk traffic (such as NetConsole messages or camera streams).
+ *
+ * \note Switching back to the default profile restores the QoS, polling and
+ *       drop-counter options, but the buffer sizes are kept until the socket
+ *       is re-created.
+ */
+void SocketTuning::apply (QAbstractSocket* socket,
+                          DS::SocketProfile profile,
+                          bool controlTraffic) {
+    if (!socket)
+        return;
+
+    bool lowLatency = (profile == DS::kSocketProfileLowLatency);
+
+    /* Options that are always applied */
+    socket->setSocketOption (QAbstractSocket::LowDelayOption, 1);
+    socket->setSocketOption (QAbstractSocket::MulticastLoopbackOption, 0);
+
+    /* Nothing else to do until the native socket exists */
+    if (socket->socketDescriptor() == -1)
+        return;
+
+    /* Size the buffers and mark control traffic */
+    if (lowLatency) {
+        socket->setSocketOption (QAbstractSocket::SendBufferSizeSocketOption,
+                                 LOW_LATENCY_SEND_BUFFER);
+        socket->setSocketOption (QAbstractSocket::ReceiveBufferSizeSocketOption,
+                                 LOW_LATENCY_RECV_BUFFER);
+    }
+
+    socket->setSocketOption (QAbstractSocket::TypeOfServiceOption,
+                             lowLatency && controlTraffic ? LOW_LATENCY_TOS : 0);
+
+    /* Linux-specific options */
+#if defined Q_OS_LINUX
+    qintptr fd = socket->socketDescriptor();
+
+#if defined SO_PRIORITY
+    SET_NATIVE_OPTION (fd, SOL_SOCKET, SO_PRIORITY,
+                       lowLatency && controlTraffic ? LOW_LATENCY_PRIORITY : 0);
+#endif
+
+#if defined SO_BUSY_POLL
+    SET_NATIVE_OPTION (fd, SOL_SOCKET, SO_BUSY_POLL,
+                       lowLatency ? LOW_LATENCY_BUSY_POLL : 0);
+#endif
+
+#if defined SO_RXQ_OVFL
+    if (socket->socketType() == QAbstractSocket::UdpSocket)
+        SET_NATIVE_OPTION (fd, SOL_SOCKET, SO_RXQ_OVFL, lowLatency ? 1 : 0);
+#endif
+#endif
+}
+
+/**
+ * Reads the datagrams received by the given UDP \a socket.
+ *
+ * If the low-latency \a profile is active and the operating system supports
+ * it, the number of datagrams dropped by the kernel (as reported by
+ * \c SO_RXQ_OVFL) is written to \a kernelDrops. The counter is peeked with
+ * \c recvmsg() before each datagram is read, and the datagram itself is read
+ * with \c QUdpSocket::readDatagram(), which re-arms the read notifier of the
+ * socket. Otherwise, this function behaves like \c DS::readSocket() and
+ * \a kernelDrops is left untouched.
+ *
+ * \note The drop counter reported by the kernel is cumulative
+ */
+QByteArray SocketTuning::readDatagrams (QUdpSocket* socket,
+                                        DS::SocketProfile profile,
+                                        quint32* kernelDrops) {
+#if defined Q_OS_LINUX && defined SO_RXQ_OVFL
+    if (!socket || profile != DS::kSocketProfileLowLatency)
+        return DS::readSocket (socket);
+
+    QByteArray data;
+    qintptr fd = socket->socketDescriptor();
+
+    while (socket->hasPendingDatagrams()) {
+        /* Peek the drop counter, without consuming the datagram */
+        if (fd != -1 && kernelDrops) {
+            char control [CMSG_SPACE (sizeof (quint32))];
+
+            struct msghdr msg;
+            memset (&msg, 0, sizeof (msg));
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof (control);
+
+            if (recvmsg (fd, &msg, MSG_PEEK | MSG_DONTWAIT) >= 0) {
+                struct cmsghdr* cmsg = CMSG_FIRSTHDR (&msg);
+                for (; cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+                    if (cmsg->cmsg_level == SOL_SOCKET
+                            && cmsg->cmsg_type == SO_RXQ_OVFL)
+                        memcpy (kernelDrops, CMSG_DATA (cmsg),
+                                sizeof (quint32));
+                }
+            }
+        }
+
+        data.resize (qMax (socket->pendingDatagramSize(), qint64 (0)));
+        if (socket->readDatagram (data.data(), data.size()) < 0) {
+            data.clear();
+            break;
+        }
+    }
+
+    return data;
+#else
+    Q_UNUSED (profile);
+    Q_UNUSED (kernelDrops);
+    return DS::readSocket (socket);
+#endif
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_SOCKET_TUNING_H
+#define _LIB_DS_SOCKET_TUNING_H
+
+#include <Core/DS_Common.h>
+
+/**
+ * \brief Applies the socket tuning profiles used by the DS modules
+ *
+ * The low-latency profile sizes the send and receive buffers of a socket,
+ * marks control traffic with DSCP/TOS and \c SO_PRIORITY, enables kernel
+ * busy-polling where supported and asks the kernel to report the number of
+ * datagrams dropped because the receive buffer of the socket was full
+ * (\c SO_RXQ_OVFL).
+ *
+ * The kernel drop counter allows us to know if packet loss happens on the air
+ * or inside our own socket buffers.
+ *
+ * \note Most of the options require a native socket descriptor, so the profile
+ *       must be applied after the socket has been bound.
+ * \note Options that are not supported by the operating system (or that
+ *       require additional privileges) are silently ignored.
+ */
+class SocketTuning {
+  public:
+    static void apply (QAbstractSocket* socket,
+                       DS::SocketProfile profile,
+                       bool controlTraffic);
+
+    static QByteArray readDatagrams (QUdpSocket* socket,
+                                     DS::SocketProfile profile,
+                                     quint32* kernelDrops);
+};
+
+#endif
@@ -7,19 +7,63 @@
  */
 
 #include "Sockets.h"
+#include "SocketTuning.h"
 
 #include <QHostInfo>
 #include <DriverStation.h>
+#include <Utilities/Tracer.h>
+#include <Utilities/StageTimers.h>
 #include <QNetworkInterface>
 
 /**
  * Sets the socket options for the given \a socket
  */
-void CONFIGURE_SOCKET (QAbstractSocket* socket) {
-    if (socket) {
-        socket->setSocketOption (QAbstractSocket::LowDelayOption, 1);
-        socket->setSocketOption (QAbstractSocket::MulticastLoopbackOption, 0);
+void CONFIGURE_SOCKET (QAbstractSocket* socket, DS::SocketProfile profile) {
+    SocketTuning::apply (socket, profile, true);
+}
+
+/**
+ * Binds the given UDP \a sender to an ephemeral port, so that the options of
+ * the socket \a profile can be applied before the first datagram is sent
+ */
+void PREPARE_SENDER (QUdpSocket* sender, DS::SocketProfile profile) {
+    if (sender && profile != DS::kSocketProfileDefault) {
+        if (sender->state() == QAbstractSocket::UnconnectedState)
+            sender->bind (0, DS_BIND_MODE);
+    }
+
+    CONFIGURE_SOCKET (sender, profile);
+}
+
+/**
+ * Logs the number of datagrams dropped by the kernel since the last read
+ */
+void REPORT_DROPS (const QString& target, quint32 previous, quint32 current) {
+    if (current > previous)
+        qWarning() << target << "socket buffer overflowed, kernel dropped"
+                   << current - previous << "datagrams";
+}
+
+/**
+ * Writes the pending frames of the given \a framer to the TCP \a stream.
+ * The stream is connected to the given \a address and \a port first if
+ * needed, the socket buffers the frames until the connection is established.
+ */
+void WRITE_STREAM (QTcpSocket* stream, StreamFramer* framer,
+                   const QHostAddress& address, int port) {
+    if (!stream || !framer->hasPendingFrames())
+        return;
+
+    if (stream->state() == QAbstractSocket::UnconnectedState) {
+        if (port == DS_DISABLED_PORT) {
+            framer->takePendingFrames();
+            return;
+        }
+
+        stream->connectToHost (address, port);
     }
+
+    stream->write (framer->takePendingFrames());
 }
 
 /**
@@ -61,6 +105,21 @@ Sockets::Sockets() {
     m_fmsOutputPort = DS_DISABLED_PORT;
     m_radioOutputPort = DS_DISABLED_PORT;
     m_robotOutputPort = DS_DISABLED_PORT;
+
+    /* Nothing to write to the TCP streams yet */
+    m_flushScheduled = false;
+
+    /* Use the OS defaults until told otherwise */
+    m_fmsKernelDrops = 0;
+    m_radioKernelDrops = 0;
+    m_robotKernelDrops = 0;
+    m_socketProfile = DS::kSocketProfileDefault;
+
+    /* The network is not impaired by default */
+    for (int i = 0; i < Transport::TARGET_COUNT; ++i) {
+        m_incoming [i] = Q_NULLPTR;
+        m_outgoing [i] = Q_NULLPTR;
+    }
 }
 
 /**
@@ -88,6 +147,74 @@ QHostAddress Sockets::robotAddress() const {
 
     return m_robotAddress;
 }
+
+/**
+ * Returns the tuning profile applied to the FMS, radio and robot sockets
+ */
+DS::SocketProfile Sockets::socketProfile() const {
+    return m_socketProfile;
+}
+
+/**
+ * Returns the transport used instead of the sockets, or \c NULL if the
+ * packets are sent through the network
+ */
+Transport* Sockets::transport() const {
+    return m_transport;
+}
+
+/**
+ * Returns the stage that impairs the packets received from the given
+ * \a target, or \c NULL if they are not impaired
+ */
+const Impairment* Sockets::incomingImpairment (int target) const {
+    if (target < 0 || target >= Transport::TARGET_COUNT)
+        return Q_NULLPTR;
+
+    return m_incoming [target];
+}
+
+/**
+ * Returns the stage that impairs the packets sent to the given \a target,
+ * or \c NULL if they are not impaired
+ */
+const Impairment* Sockets::outgoingImpairment (int target) const {
+    if (target < 0 || target >= Transport::TARGET_COUNT)
+        return Q_NULLPTR;
+
+    return m_outgoing [target];
+}
+
+/**
+ * Returns the number of FMS datagrams dropped by the kernel because the
+ * receive buffer of the socket was full.
+ *
+ * \note This value is only updated when the low-latency profile is active
+ */
+quint32 Sockets::fmsKernelDrops() const {
+    return m_fmsKernelDrops;
+}
+
+/**
+ * Returns the number of radio datagrams dropped by the kernel because the
+ * receive buffer of the socket was full.
+ *
+ * \note This value is only updated when the low-latency profile is active
+ */
+quint32 Sockets::radioKernelDrops() const {
+    return m_radioKernelDrops;
+}
+
+/**
+ * Returns the number of robot datagrams dropped by the kernel because the
+ * receive buffer of the socket was full.
+ *
+ * \note This value is only updated when the low-latency profile is active
+ */
+quint32 Sockets::robotKernelDrops() const {
+    return m_robotKernelDrops;
+}
+
 /**
  * If any of the IPs used during the communications is not known,
  * this function will ensure that the DS performs a lookup periodically
@@ -97,6 +224,8 @@ QHostAddress Sockets::robotAddress() const {
  * when the robot uses a mDNS address.
  */
 void Sockets::performLookups() {
+    Tracer::getInstance()->instant ("lookups", "Perform lookups");
+
     /* Assign the driver station pointer */
     if (!m_driverStation)
         m_driverStation = DriverStation::getInstance();
@@ -123,6 +252,105 @@ void Sockets::performLookups() {
     DS_Schedule (2000, this, SLOT (performLookups()));
 }
 
+/**
+ * Changes the \c DriverStation instance that is queried when performing the
+ * FMS, radio and robot lookups. If no instance is set, the global
+ * \c DriverStation will be used.
+ */
+void Sockets::setDriverStation (DriverStation* driverStation) {
+    m_driverStation = driverStation;
+}
+
+/**
+ * Changes the tuning \a profile of the FMS, radio and robot sockets and
+ * applies it to the sockets that already exist.
+ */
+void Sockets::setSocketProfile (DS::SocketProfile profile) {
+    if (m_socketProfile == profile)
+        return;
+
+    m_socketProfile = profile;
+
+    PREPARE_SENDER (m_udpFmsSender, profile);
+    PREPARE_SENDER (m_udpRadioSender, profile);
+    PREPARE_SENDER (m_udpRobotSender, profile);
+    CONFIGURE_SOCKET (m_tcpFmsSender, profile);
+    CONFIGURE_SOCKET (m_tcpRadioSender, profile);
+    CONFIGURE_SOCKET (m_tcpRobotSender, profile);
+    CONFIGURE_SOCKET (m_udpFmsReceiver, profile);
+    CONFIGURE_SOCKET (m_tcpFmsReceiver, profile);
+    CONFIGURE_SOCKET (m_udpRadioReceiver, profile);
+    CONFIGURE_SOCKET (m_tcpRadioReceiver, profile);
+    CONFIGURE_SOCKET (m_udpRobotReceiver, profile);
+    CONFIGURE_SOCKET (m_tcpRobotReceiver, profile);
+
+    qDebug() << "Socket profile set to" << profile;
+}
+
+/**
+ * Sends and receives the packets of every target through the given
+ * \a transport instead of the sockets. The transport is not owned by this
+ * class. If \a transport is \c NULL, the sockets are used again.
+ */
+void Sockets::setTransport (Transport* transport) {
+    if (m_transport == transport)
+        return;
+
+    if (m_transport)
+        disconnect (m_transport, SIGNAL (packetReceived (int, QByteArray)),
+                    this,          SLOT (readTransport (int, QByteArray)));
+
+    m_transport = transport;
+
+    if (m_transport)
+        connect (m_transport, SIGNAL (packetReceived (int, QByteArray)),
+                 this,          SLOT (readTransport (int, QByteArray)));
+}
+
+/**
+ * Stops impairing the packets of the given \a target. The packets that were
+ * being delayed are dropped.
+ */
+void Sockets::clearImpairment (int target) {
+    if (target < 0 || target >= Transport::TARGET_COUNT)
+        return;
+
+    delete m_incoming [target];
+    delete m_outgoing [target];
+    m_incoming [target] = Q_NULLPTR;
+    m_outgoing [target] = Q_NULLPTR;
+}
+
+/**
+ * Passes the packets sent to and received from the given \a target through
+ * an impairment stage with the given \a settings. Both directions are
+ * impaired independently, the incoming stage is seeded with the seed of the
+ * \a settings plus one.
+ *
+ * This function can be called at any time to change the settings, the
+ * packets that are already delayed keep their release time.
+ */
+void Sockets::setImpairment (int target, const Impairment::Settings& settings) {
+    if (target < 0 || target >= Transport::TARGET_COUNT)
+        return;
+
+    if (!m_outgoing [target]) {
+        m_outgoing [target] = new Impairment (target, this);
+        m_incoming [target] = new Impairment (target, this);
+
+        connect (m_outgoing [target], SIGNAL (packetReady (int, QByteArray)),
+                 this,                  SLOT (write (int, QByteArray)));
+        connect (m_incoming [target], SIGNAL (packetReady (int, QByteArray)),
+                 this,                  SLOT (deliver (int, QByteArray)));
+    }
+
+    Impairment::Settings incoming = settings;
+    incoming.seed = settings.seed + 1;
+
+    m_outgoing [target]->setSettings (settings);
+    m_incoming [target]->setSettings (incoming);
+}
+
 /**
  * Changes the port in which we receive data from the FMS
  */
@@ -131,12 +359,14 @@ void Sockets::setFMSInputPort (int port) {
         m_tcpFmsReceiver->abort();
         m_tcpFmsReceiver->bind (port,
                                 DS_BIND_MODE);
+        CONFIGURE_SOCKET (m_tcpFmsReceiver, m_socketProfile);
     }
 
     else if (m_udpFmsReceiver) {
         m_udpFmsReceiver->abort();
         m_udpFmsReceiver->bind (port,
                                 DS_BIND_MODE);
+        CONFIGURE_SOCKET (m_udpFmsReceiver, m_socketProfile);
     }
 }
 
@@ -155,12 +385,14 @@ void Sockets::setRadioInputPort (int port) {
         m_tcpRadioReceiver->abort();
         m_tcpRadioReceiver->bind (port,
                                   DS_BIND_MODE);
+        CONFIGURE_SOCKET (m_tcpRadioReceiver, m_socketProfile);
     }
 
     else if (m_udpRadioReceiver) {
         m_udpRadioReceiver->abort();
         m_udpRadioReceiver->bind (port,
                                   DS_BIND_MODE);
+        CONFIGURE_SOCKET (m_udpRadioReceiver, m_socketProfile);
     }
 }
 
@@ -172,12 +404,14 @@ void Sockets::setRobotInputPort (int port) {
         m_tcpRobotReceiver->abort();
         m_tcpRobotReceiver->bind (port,
                                   DS_BIND_MODE);
+        CONFIGURE_SOCKET (m_tcpRobotReceiver, m_socketProfile);
     }
 
     else if (m_udpRobotReceiver) {
         m_udpRobotReceiver->abort();
         m_udpRobotReceiver->bind (port,
                                   DS_BIND_MODE);
+        CONFIGURE_SOCKET (m_udpRobotReceiver, m_socketProfile);
     }
 }
 
@@ -202,11 +436,8 @@ void Sockets::sendToFMS (const QByteArray& data) {
     if (data.isEmpty())
         return;
 
-    if (m_tcpFmsSender)
-        m_tcpFmsSender->write (data);
-
-    else if (m_udpFmsSender)
-        m_udpFmsSender->writeDatagram (data, fmsAddress(), m_fmsOutputPort);
+    Tracer::getInstance()->instant ("sockets", "Send FMS data");
+    send (Transport::kFMS, data);
 }
 
 /**
@@ -216,11 +447,19 @@ void Sockets::sendToRobot (const QByteArray& data) {
     if (data.isEmpty())
         return;
 
-    if (m_tcpRobotSender)
-        m_tcpRobotSender->write (data);
+    Tracer::getInstance()->instant ("sockets", "Send robot data");
+    send (Transport::kRobot, data);
+}
 
-    else if (m_udpRobotSender)
-        m_udpRobotSender->writeDatagram (data, robotAddress(), m_robotOutputPort);
+/**
+ * Sends the given \a data to the robot right away. Unlike \c sendToRobot(),
+ * TCP frames are written immediately instead of at the end of the current
+ * event loop iteration.
+ */
+void Sockets::sendToRobotNow (const QByteArray& data) {
+    sendToRobot (data);
+    WRITE_STREAM (m_tcpRobotSender, &m_robotFramer, robotAddress(),
+                  m_robotOutputPort);
 }
 
 /**
@@ -230,11 +469,8 @@ void Sockets::sendToRadio (const QByteArray& data) {
     if (data.isEmpty())
         return;
 
-    if (m_tcpRadioSender)
-        m_tcpRadioSender->write (data);
-
-    else if (m_udpRadioSender)
-        m_udpRadioSender->writeDatagram (data, radioAddress(), m_radioOutputPort);
+    Tracer::getInstance()->instant ("sockets", "Send radio data");
+    send (Transport::kRadio, data);
 }
 
 /**
@@ -247,6 +483,9 @@ void Sockets::setFMSSocketType (DS::SocketType type) {
     delete m_udpFmsReceiver;
     delete m_tcpFmsReceiver;
 
+    /* Discard any incomplete or pending TCP frames */
+    m_fmsFramer.reset();
+
     /* Assign a null pointer to all sockets, so that we do not crash */
     m_udpFmsSender = Q_NULLPTR;
     m_tcpFmsSender = Q_NULLPTR;
@@ -258,8 +497,8 @@ void Sockets::setFMSSocketType (DS::SocketType type) {
         m_tcpFmsSender = new QTcpSocket (this);
         m_tcpFmsReceiver = new QTcpSocket (this);
 
-        CONFIGURE_SOCKET (m_tcpFmsSender);
-        CONFIGURE_SOCKET (m_tcpFmsReceiver);
+        CONFIGURE_SOCKET (m_tcpFmsSender, m_socketProfile);
+        CONFIGURE_SOCKET (m_tcpFmsReceiver, m_socketProfile);
 
         connect (m_tcpFmsReceiver, SIGNAL (readyRead()),
                  this,               SLOT (readFMSSocket()));
@@ -270,8 +509,8 @@ void Sockets::setFMSSocketType (DS::SocketType type) {
         m_udpFmsSender = new QUdpSocket (this);
         m_udpFmsReceiver = new QUdpSocket (this);
 
-        CONFIGURE_SOCKET (m_udpFmsSender);
-        CONFIGURE_SOCKET (m_udpFmsReceiver);
+        PREPARE_SENDER (m_udpFmsSender, m_socketProfile);
+        CONFIGURE_SOCKET (m_udpFmsReceiver, m_socketProfile);
 
         connect (m_udpFmsReceiver, SIGNAL (readyRead()),
                  this,               SLOT (readFMSSocket()));
@@ -288,6 +527,9 @@ void Sockets::setRadioSocketType (DS::SocketType type) {
     delete m_udpRadioReceiver;
     delete m_tcpRadioReceiver;
 
+    /* Discard any incomplete or pending TCP frames */
+    m_radioFramer.reset();
+
     /* Assign a null pointer to all sockets, so that we do not crash */
     m_udpRadioSender = Q_NULLPTR;
     m_tcpRadioSender = Q_NULLPTR;
@@ -299,8 +541,8 @@ void Sockets::setRadioSocketType (DS::SocketType type) {
         m_tcpRadioSender = new QTcpSocket (this);
         m_tcpRadioReceiver = new QTcpSocket (this);
 
-        CONFIGURE_SOCKET (m_tcpRadioSender);
-        CONFIGURE_SOCKET (m_tcpRadioReceiver);
+        CONFIGURE_SOCKET (m_tcpRadioSender, m_socketProfile);
+        CONFIGURE_SOCKET (m_tcpRadioReceiver, m_socketProfile);
 
         connect (m_tcpRadioReceiver, SIGNAL (readyRead()),
                  this,                 SLOT (readRadioSocket()));
@@ -311,8 +553,8 @@ void Sockets::setRadioSocketType (DS::SocketType type) {
         m_udpRadioSender = new QUdpSocket (this);
         m_udpRadioReceiver = new QUdpSocket (this);
 
-        CONFIGURE_SOCKET (m_udpRadioSender);
-        CONFIGURE_SOCKET (m_udpRadioReceiver);
+        PREPARE_SENDER (m_udpRadioSender, m_socketProfile);
+        CONFIGURE_SOCKET (m_udpRadioReceiver, m_socketProfile);
 
         connect (m_udpRadioReceiver, SIGNAL (readyRead()),
                  this,                 SLOT (readRadioSocket()));
@@ -329,7 +571,12 @@ void Sockets::setRobotSocketType (DS::SocketType type) {
     delete m_udpRobotReceiver;
     delete m_tcpRobotReceiver;
 
+    /* Discard any incomplete or pending TCP frames */
+    m_robotFramer.reset();
+
     /* Assign a null pointer to all sockets, so that we do not crash */
+    m_udpRobotSender = Q_NULLPTR;
+    m_tcpRobotSender = Q_NULLPTR;
     m_udpRobotReceiver = Q_NULLPTR;
     m_tcpRobotReceiver = Q_NULLPTR;
 
@@ -338,8 +585,8 @@ void Sockets::setRobotSocketType (DS::SocketType type) {
         m_tcpRobotSender = new QTcpSocket (this);
         m_tcpRobotReceiver = new QTcpSocket (this);
 
-        CONFIGURE_SOCKET (m_tcpRobotSender);
-        CONFIGURE_SOCKET (m_tcpRobotReceiver);
+        CONFIGURE_SOCKET (m_tcpRobotSender, m_socketProfile);
+        CONFIGURE_SOCKET (m_tcpRobotReceiver, m_socketProfile);
 
         connect (m_tcpRobotReceiver, SIGNAL (readyRead()),
                  this,                 SLOT (readRobotSocket()));
@@ -350,8 +597,8 @@ void Sockets::setRobotSocketType (DS::SocketType type) {
         m_udpRobotSender = new QUdpSocket (this);
         m_udpRobotReceiver = new QUdpSocket (this);
 
-        CONFIGURE_SOCKET (m_udpRobotSender);
-        CONFIGURE_SOCKET (m_udpRobotReceiver);
+        PREPARE_SENDER (m_udpRobotSender, m_socketProfile);
+        CONFIGURE_SOCKET (m_udpRobotReceiver, m_socketProfile);
 
         connect (m_udpRobotReceiver, SIGNAL (readyRead()),
                  this,                 SLOT (readRobotSocket()));
@@ -430,25 +677,48 @@ void Sockets::setRobotAddress (const QHostAddress& address) {
     }
 }
 
+/**
+ * Writes the TCP frames generated since the last flush with a single write
+ * operation per target
+ */
+void Sockets::flushStreams() {
+    m_flushScheduled = false;
+
+    WRITE_STREAM (m_tcpFmsSender, &m_fmsFramer, fmsAddress(),
+                  m_fmsOutputPort);
+    WRITE_STREAM (m_tcpRadioSender, &m_radioFramer, radioAddress(),
+                  m_radioOutputPort);
+    WRITE_STREAM (m_tcpRobotSender, &m_robotFramer, robotAddress(),
+                  m_robotOutputPort);
+}
+
 /**
  * Called when we receive data from the FMS
  */
 void Sockets::readFMSSocket() {
     QByteArray data;
     QHostAddress address;
+    Tracer::getInstance()->instant ("sockets", "Receive FMS data");
 
     if (m_tcpFmsReceiver) {
-        data = DS::readSocket (m_tcpFmsReceiver);
-        address = m_tcpFmsReceiver->peerAddress();
+        setFMSAddress (m_tcpFmsReceiver->peerAddress());
+        foreach (const QByteArray& frame, m_fmsFramer.read (m_tcpFmsReceiver))
+            receive (Transport::kFMS, frame);
+
+        return;
     }
 
     else if (m_udpFmsReceiver) {
-        data = DS::readSocket (m_udpFmsReceiver);
+        quint32 drops = m_fmsKernelDrops;
+        data = SocketTuning::readDatagrams (m_udpFmsReceiver,
+                                            m_socketProfile,
+                                            &m_fmsKernelDrops);
+        REPORT_DROPS ("FMS", drops, m_fmsKernelDrops);
         address = m_udpFmsReceiver->peerAddress();
     }
 
     setFMSAddress (address);
-    emit fmsPacketReceived (data);
+    receive (Transport::kFMS, data);
 }
 
 /**
@@ -457,19 +727,27 @@ void Sockets::readFMSSocket() {
 void Sockets::readRadioSocket() {
     QByteArray data;
     QHostAddress address;
+    Tracer::getInstance()->instant ("sockets", "Receive radio data");
 
     if (m_tcpRadioReceiver) {
-        data = DS::readSocket (m_tcpRadioReceiver);
-        address = m_tcpRadioReceiver->peerAddress();
+        setRadioAddress (m_tcpRadioReceiver->peerAddress());
+        foreach (const QByteArray& frame, m_radioFramer.read (m_tcpRadioReceiver))
+            receive (Transport::kRadio, frame);
+
+        return;
     }
 
     else if (m_udpRadioReceiver) {
-        data = DS::readSocket (m_udpRadioReceiver);
+        quint32 drops = m_radioKernelDrops;
+        data = SocketTuning::readDatagrams (m_udpRadioReceiver,
+                                            m_socketProfile,
+                                            &m_radioKernelDrops);
+        REPORT_DROPS ("Radio", drops, m_radioKernelDrops);
         address = m_udpRadioReceiver->peerAddress();
     }
 
     setRadioAddress (address);
-    emit radioPacketReceived (data);
+    receive (Transport::kRadio, data);
 }
 
 /**
@@ -478,25 +756,144 @@ void Sockets::readRadioSocket() {
 void Sockets::readRobotSocket() {
     QByteArray data;
     QHostAddress address;
+    Tracer::getInstance()->instant ("sockets", "Receive robot data");
 
     if (m_tcpRobotReceiver) {
-        data = DS::readSocket (m_tcpRobotReceiver);
-        address = m_tcpRobotReceiver->peerAddress();
+        QList<QByteArray> frames;
+        setRobotAddress (m_tcpRobotReceiver->peerAddress());
+
+        {
+            StageTimers::Scope timer (StageTimers::kReadSocket);
+            frames = m_robotFramer.read (m_tcpRobotReceiver);
+        }
+
+        foreach (const QByteArray& frame, frames)
+            receive (Transport::kRobot, frame);
+
+        return;
     }
 
     else if (m_udpRobotReceiver) {
-        data = DS::readSocket (m_udpRobotReceiver);
+        quint32 drops = m_robotKernelDrops;
+
+        {
+            StageTimers::Scope timer (StageTimers::kReadSocket);
+            data = SocketTuning::readDatagrams (m_udpRobotReceiver,
+                                                m_socketProfile,
+                                                &m_robotKernelDrops);
+        }
+
+        REPORT_DROPS ("Robot", drops, m_robotKernelDrops);
         address = m_udpRobotReceiver->peerAddress();
     }
 
     setRobotAddress (address);
-    emit robotPacketReceived (data);
+    receive (Transport::kRobot, data);
+}
+
+/**
+ * Called when the transport receives a packet for the given \a target
+ */
+void Sockets::readTransport (int target, const QByteArray& data) {
+    Tracer::getInstance()->instant ("sockets", "Receive transport data");
+    receive (target, data);
+}
+
+/**
+ * Writes the given \a data to the transport or to the sockets of the given
+ * \a target
+ */
+void Sockets::write (int target, const QByteArray& data) {
+    if (m_transport) {
+        m_transport->send (target, data);
+        return;
+    }
+
+    if (target == Transport::kFMS) {
+        if (m_tcpFmsSender) {
+            if (m_fmsFramer.enqueueFrame (data))
+                scheduleFlush();
+        }
+
+        else if (m_udpFmsSender)
+            m_udpFmsSender->writeDatagram (data, fmsAddress(), m_fmsOutputPort);
+    }
+
+    else if (target == Transport::kRadio) {
+        if (m_tcpRadioSender) {
+            if (m_radioFramer.enqueueFrame (data))
+                scheduleFlush();
+        }
+
+        else if (m_udpRadioSender)
+            m_udpRadioSender->writeDatagram (data, radioAddress(),
+                                             m_radioOutputPort);
+    }
+
+    else if (target == Transport::kRobot) {
+        if (m_tcpRobotSender) {
+            if (m_robotFramer.enqueueFrame (data))
+                scheduleFlush();
+        }
+
+        else if (m_udpRobotSender)
+            m_udpRobotSender->writeDatagram (data, robotAddress(),
+                                             m_robotOutputPort);
+    }
+}
+
+/**
+ * Delivers the given \a data, which was received from the given \a target,
+ * to the protocol
+ */
+void Sockets::deliver (int target, const QByteArray& data) {
+    if (target == Transport::kFMS)
+        emit fmsPacketReceived (data);
+    else if (target == Transport::kRadio)
+        emit radioPacketReceived (data);
+    else if (target == Transport::kRobot)
+        emit robotPacketReceived (data);
+}
+
+/**
+ * Sends the given \a data to the given \a target, through its impairment
+ * stage if the target is impaired
+ */
+void Sockets::send (int target, const QByteArray& data) {
+    if (m_outgoing [target])
+        m_outgoing [target]->process (data);
+    else
+        write (target, data);
+}
+
+/**
+ * Delivers the given \a data, which was received from the given \a target,
+ * through its impairment stage if the target is impaired
+ */
+void Sockets::receive (int target, const QByteArray& data) {
+    if (target >= 0 && target < Transport::TARGET_COUNT && m_incoming [target])
+        m_incoming [target]->process (data);
+    else
+        deliver (target, data);
+}
+
+/**
+ * Writes the pending TCP frames once control returns to the event loop, so
+ * that the packets generated in the same iteration are coalesced
+ */
+void Sockets::scheduleFlush() {
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod (this, "flushStreams", Qt::QueuedConnection);
+    }
 }
 
 /**
  * Assigns the found FMS IP
  */
 void Sockets::onFMSLookupFinished (const QHostInfo& info) {
+    Tracer::getInstance()->instant ("lookups", "FMS lookup finished");
+
     if (m_fmsAddress.isNull() && !info.addresses().isEmpty())
         setFMSAddress (info.addresses().first());
 }
@@ -505,6 +902,8 @@ void Sockets::onFMSLookupFinished (const QHostInfo& info) {
  * Assigns the found radio IP
  */
 void Sockets::onRadioLookupFinished (const QHostInfo& info) {
+    Tracer::getInstance()->instant ("lookups", "Radio lookup finished");
+
     if (m_radioAddress.isNull() && !info.addresses().isEmpty())
         setRadioAddress (info.addresses().first());
 }
@@ -513,6 +912,8 @@ void Sockets::onRadioLookupFinished (const QHostInfo& info) {
  * Assigns the found robot IP
  */
 void Sockets::onRobotLookupFinished (const QHostInfo& info) {
+    Tracer::getInstance()->instant ("lookups", "Robot lookup finished");
+
     if (m_robotAddress.isNull() && !info.addresses().isEmpty())
         setRobotAddress (info.addresses().first());
 }
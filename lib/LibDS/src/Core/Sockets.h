@@ -10,6 +10,9 @@
 #define _LIB_DS_SOCKETS_H
 
 #include <Core/DS_Base.h>
+#include <Core/Transport.h>
+#include <Core/Impairment.h>
+#include <Utilities/StreamFramer.h>
 
 class DriverStation;
 
@@ -25,6 +28,12 @@ class DriverStation;
  *
  * \note The packets can be sent either with UDP or TCP packets (as defined by
  *       the DS/protocol)
+ * \note TCP packets are prefixed with their length (see \c StreamFramer), so
+ *       that each packet is delivered individually to the protocol
+ * \note If a \c Transport is set, every packet goes through the transport
+ *       instead of the sockets
+ * \note The packets of each target can be passed through an \c Impairment
+ *       stage (in both directions) to emulate a bad network
  */
 class Sockets : public QObject {
     Q_OBJECT
@@ -41,8 +50,22 @@ class Sockets : public QObject {
     QHostAddress radioAddress() const;
     QHostAddress robotAddress() const;
 
+    DS::SocketProfile socketProfile() const;
+    Transport* transport() const;
+    const Impairment* incomingImpairment (int target) const;
+    const Impairment* outgoingImpairment (int target) const;
+
+    quint32 fmsKernelDrops() const;
+    quint32 radioKernelDrops() const;
+    quint32 robotKernelDrops() const;
+
   public slots:
     void performLookups();
+    void setDriverStation (DriverStation* driverStation);
+    void setSocketProfile (DS::SocketProfile profile);
+    void setTransport (Transport* transport);
+    void clearImpairment (int target);
+    void setImpairment (int target, const Impairment::Settings& settings);
     void setFMSInputPort (int port);
     void setFMSOutputPort (int port);
     void setRadioInputPort (int port);
@@ -51,6 +74,7 @@ class Sockets : public QObject {
     void setRobotOutputPort (int port);
     void sendToFMS (const QByteArray& data);
     void sendToRobot (const QByteArray& data);
+    void sendToRobotNow (const QByteArray& data);
     void sendToRadio (const QByteArray& data);
     void setFMSSocketType (DS::SocketType type);
     void setRadioSocketType (DS::SocketType type);
@@ -63,14 +87,24 @@ class Sockets : public QObject {
     void setRobotAddress (const QHostAddress& address);
 
   private slots:
+    void flushStreams();
     void readFMSSocket();
     void readRadioSocket();
     void readRobotSocket();
+    void readTransport (int target, const QByteArray& data);
+    void write (int target, const QByteArray& data);
+    void deliver (int target, const QByteArray& data);
     void onFMSLookupFinished (const QHostInfo& info);
     void onRadioLookupFinished (const QHostInfo& info);
     void onRobotLookupFinished (const QHostInfo& info);
 
   private:
+    void scheduleFlush();
+    void send (int target, const QByteArray& data);
+    void receive (int target, const QByteArray& data);
+
+  private:
+    bool m_flushScheduled;
     int m_robotIterator;
     int m_fmsOutputPort;
     int m_radioOutputPort;
@@ -80,11 +114,23 @@ class Sockets : public QObject {
     int m_radioLookupId;
     int m_robotLookupId;
 
+    quint32 m_fmsKernelDrops;
+    quint32 m_radioKernelDrops;
+    quint32 m_robotKernelDrops;
+    DS::SocketProfile m_socketProfile;
+
+    StreamFramer m_fmsFramer;
+    StreamFramer m_radioFramer;
+    StreamFramer m_robotFramer;
+
     QHostAddress m_fmsAddress;
     QHostAddress m_robotAddress;
     QHostAddress m_radioAddress;
 
     DriverStation* m_driverStation;
+    QPointer<Transport> m_transport;
+    Impairment* m_incoming [Transport::TARGET_COUNT];
+    Impairment* m_outgoing [Transport::TARGET_COUNT];
 
     QUdpSocket* m_udpFmsSender;
     QTcpSocket* m_tcpFmsSender;
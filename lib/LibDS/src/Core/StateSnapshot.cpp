@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "StateSnapshot.h"
+
+StateSnapshot::StateSnapshot() : m_version (0) {
+    memset (&m_state, 0, sizeof (m_state));
+}
+
+/**
+ * Returns the version of the last published state, or 0 if no state has
+ * been published yet
+ */
+quint64 StateSnapshot::version() const {
+    return m_version.load (std::memory_order_acquire);
+}
+
+/**
+ * Returns a copy of the last published state
+ */
+StateSnapshot::State StateSnapshot::read() const {
+    State state;
+    read (&state);
+    return state;
+}
+
+/**
+ * Copies the last published state to \a state
+ */
+void StateSnapshot::read (State* state) const {
+    if (state)
+        m_lock.read (m_state, state);
+}
+
+/**
+ * Copies the last published state to \a state only if it is newer than the
+ * version of the given \a state. Returns \c false if nothing was published
+ * since the given \a state was read.
+ */
+bool StateSnapshot::readIfNewer (State* state) const {
+    if (!state || version() <= state->version)
+        return false;
+
+    read (state);
+    return true;
+}
+
+/**
+ * Publishes the given \a state, replacing its version with the next one.
+ * Returns the version assigned to the state.
+ */
+quint64 StateSnapshot::publish (const State& state) {
+    m_lock.lockForWrite();
+    quint64 version = m_version.load (std::memory_order_relaxed) + 1;
+    m_state = state;
+    m_state.version = version;
+    m_version.store (version, std::memory_order_release);
+    m_lock.unlockForWrite();
+
+    return version;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_STATE_SNAPSHOT_H
+#define _LIB_DS_STATE_SNAPSHOT_H
+
+#include <Core/DS_Common.h>
+#include <Utilities/SeqLock.h>
+
+/**
+ * \brief Publishes a coherent copy of the DS state to readers in any thread
+ *
+ * The state of the DS is spread among the \c DS_Config, the \c DriverStation
+ * and the protocol counters, and can only be read from the DS thread, one
+ * value at a time. After every packet transaction, the DS gathers all those
+ * values in a single \c State and publishes it here.
+ *
+ * Readers (e.g. the logger, exporters or a network thread) copy the whole
+ * state through a \c SeqLock, so they never block the DS and never observe
+ * a state that is half-way updated. Each published state has a version that
+ * is larger than the version of the previous one, which allows readers to
+ * skip the copy if nothing was published since their last read.
+ */
+class StateSnapshot {
+  public:
+    explicit StateSnapshot();
+
+    struct State {
+        quint64 version;                   /**< Increases with every update */
+        qint64 timestamp;                  /**< Time of the update (usecs) */
+        qint64 roundTrip;                  /**< Last round-trip time (usecs) */
+        qreal voltage;                     /**< Robot voltage */
+        int team;                          /**< Team number */
+        int cpuUsage;                      /**< Robot CPU usage */
+        int ramUsage;                      /**< Robot RAM usage */
+        int diskUsage;                     /**< Robot disk usage */
+        int packetLoss;                    /**< Robot packet loss */
+        int sentRobotPackets;              /**< Robot packets sent */
+        int receivedRobotPackets;          /**< Robot packets received */
+        int urgentRobotPackets;            /**< Urgent robot packets sent */
+        bool simulated;                    /**< Robot is a simulation */
+        DS::Alliance alliance;             /**< Alliance of the station */
+        DS::Position position;             /**< Position of the station */
+        DS::ControlMode controlMode;       /**< Robot control mode */
+        DS::EnableStatus enableStatus;     /**< Robot enable status */
+        DS::CodeStatus robotCodeStatus;    /**< Robot code status */
+        DS::CommStatus fmsCommStatus;      /**< FMS communication status */
+        DS::CommStatus radioCommStatus;    /**< Radio communication status */
+        DS::CommStatus robotCommStatus;    /**< Robot communication status */
+        DS::VoltageStatus voltageStatus;   /**< Normal or brownout */
+        DS::OperationStatus operationStatus; /**< Normal or emergency stop */
+    };
+
+    quint64 version() const;
+
+    State read() const;
+    void read (State* state) const;
+    bool readIfNewer (State* state) const;
+
+    quint64 publish (const State& state);
+
+  private:
+    State m_state;
+    mutable SeqLock m_lock;
+    std::atomic<quint64> m_version;
+};
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_STATIC_PROTOCOL_H
+#define _LIB_DS_STATIC_PROTOCOL_H
+
+/*
+ * When the LibDS is built with a single protocol (LIBDS_PROTOCOL=year in the
+ * qmake command line), the \c DriverStation uses the \c StaticProtocol class
+ * instead of the abstract \c Protocol. Since the class is final, the compiler
+ * resolves the calls made by the DS (e.g. robotFrequency() or
+ * maxAxisCount()) at compile time, which allows them to be inlined.
+ */
+#if defined LIB_DS_STATIC_PROTOCOL
+
+#if LIB_DS_STATIC_PROTOCOL == 2014
+#include <Protocols/FRC_2014.h>
+typedef FRC_2014 StaticProtocolBase;
+#elif LIB_DS_STATIC_PROTOCOL == 2015
+#include <Protocols/FRC_2015.h>
+typedef FRC_2015 StaticProtocolBase;
+#elif LIB_DS_STATIC_PROTOCOL == 2016
+#include <Protocols/FRC_2016.h>
+typedef FRC_2016 StaticProtocolBase;
+#else
+#error "Unsupported LIB_DS_STATIC_PROTOCOL value"
+#endif
+
+/**
+ * \brief The only protocol of a single-protocol build of the LibDS
+ */
+class StaticProtocol final : public StaticProtocolBase {
+  public:
+    /**
+     * Returns the \c DriverStation::ProtocolType of the protocol
+     */
+    static DriverStation::ProtocolType type() {
+#if LIB_DS_STATIC_PROTOCOL == 2014
+        return DriverStation::kFRC2014;
+#elif LIB_DS_STATIC_PROTOCOL == 2015
+        return DriverStation::kFRC2015;
+#else
+        return DriverStation::kFRC2016;
+#endif
+    }
+};
+
+#endif
+
+#endif
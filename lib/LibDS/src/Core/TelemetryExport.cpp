@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "TelemetryExport.h"
+
+#include <new>
+#include <QDebug>
+
+#if defined Q_OS_WIN
+#include <QSharedMemory>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* Readers give up after this many inconsistent copies */
+const int MAX_READ_ATTEMPTS = 1000;
+
+/* The layout of the block does not depend on the compiler */
+static_assert (sizeof (TelemetryExport::Joystick) == 44,
+               "Unexpected size of TelemetryExport::Joystick");
+static_assert (sizeof (TelemetryExport::Values) == 312,
+               "Unexpected size of TelemetryExport::Values");
+
+#if !defined Q_OS_WIN
+
+/**
+ * Returns the name of the POSIX shared memory object of the given \a key
+ */
+static QByteArray SHM_NAME (const QString& key) {
+    return "/" + key.toUtf8();
+}
+
+#endif
+
+TelemetryExport::TelemetryExport() {
+    m_owner = false;
+    m_updates = 0;
+    m_block = Q_NULLPTR;
+
+#if defined Q_OS_WIN
+    m_memory = Q_NULLPTR;
+#endif
+}
+
+/**
+ * Detaches from the shared memory block
+ */
+TelemetryExport::~TelemetryExport() {
+    close();
+}
+
+/**
+ * Returns the key of the shared memory block, or an empty string if we are
+ * not attached to any block
+ */
+QString TelemetryExport::key() const {
+    return isAttached() ? m_key : "";
+}
+
+/**
+ * Returns \c true if we created the shared memory block and can publish
+ * values to it
+ */
+bool TelemetryExport::isOwner() const {
+    return isAttached() && m_owner;
+}
+
+/**
+ * Returns \c true if we are attached to a shared memory block
+ */
+bool TelemetryExport::isAttached() const {
+    return m_block != Q_NULLPTR;
+}
+
+/**
+ * Creates the shared memory block identified by the given \a key, so that
+ * values can be published to it. If a block with the same key was left
+ * behind by a crashed process, it is released and created again.
+ *
+ * Returns \c false if the block cannot be created
+ */
+bool TelemetryExport::create (const QString& key) {
+    close();
+
+#if defined Q_OS_WIN
+    m_memory = new QSharedMemory;
+    m_memory->setNativeKey (key);
+    if (!m_memory->create (sizeof (Block))) {
+        if (m_memory->error() == QSharedMemory::AlreadyExists) {
+            if (m_memory->attach())
+                m_memory->detach();
+
+            m_memory->create (sizeof (Block));
+        }
+    }
+
+    if (m_memory->isAttached())
+        m_block = static_cast<Block*> (m_memory->data());
+    else {
+        qWarning() << "Cannot export telemetry to" << key
+                   << m_memory->errorString();
+    }
+#else
+    QByteArray name = SHM_NAME (key);
+    int fd = shm_open (name.constData(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd == -1 && errno == EEXIST) {
+        shm_unlink (name.constData());
+        fd = shm_open (name.constData(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    }
+
+    if (fd != -1) {
+        if (ftruncate (fd, sizeof (Block)) == 0) {
+            void* data = mmap (Q_NULLPTR, sizeof (Block),
+                               PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED)
+                m_block = static_cast<Block*> (data);
+        }
+
+        ::close (fd);
+        if (!m_block)
+            shm_unlink (name.constData());
+    }
+
+    if (!m_block) {
+        qWarning() << "Cannot export telemetry to" << key
+                   << strerror (errno);
+    }
+#endif
+
+    if (!m_block) {
+        close();
+        return false;
+    }
+
+    /* Initialize the block */
+    memset (m_block, 0, sizeof (Block));
+    new (&m_block->lock) SeqLock();
+    m_block->magic = MAGIC;
+    m_block->version = VERSION;
+    m_block->size = sizeof (Block);
+
+    m_key = key;
+    m_owner = true;
+    m_updates = 0;
+
+    qDebug() << "Exporting telemetry to" << key;
+    return true;
+}
+
+/**
+ * Attaches to the shared memory block identified by the given \a key in
+ * read-only mode.
+ *
+ * Returns \c false if the block does not exist or if it was created by an
+ * incompatible version of the LibDS
+ */
+bool TelemetryExport::attach (const QString& key) {
+    close();
+
+    qint64 size = 0;
+
+#if defined Q_OS_WIN
+    m_memory = new QSharedMemory;
+    m_memory->setNativeKey (key);
+    if (m_memory->attach (QSharedMemory::ReadOnly)) {
+        size = m_memory->size();
+        m_block = static_cast<Block*> (m_memory->data());
+    }
+#else
+    int fd = shm_open (SHM_NAME (key).constData(), O_RDONLY, 0);
+    if (fd != -1) {
+        struct stat info;
+        if (fstat (fd, &info) == 0 && info.st_size >= (off_t) sizeof (Block)) {
+            void* data = mmap (Q_NULLPTR, sizeof (Block), PROT_READ,
+                               MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED) {
+                size = info.st_size;
+                m_block = static_cast<Block*> (data);
+            }
+        }
+
+        ::close (fd);
+    }
+#endif
+
+    if (!m_block) {
+        close();
+        return false;
+    }
+
+    if (size < (qint64) sizeof (Block)
+            || m_block->magic != MAGIC
+            || m_block->version != VERSION
+            || m_block->size != sizeof (Block)) {
+        qWarning() << "Incompatible telemetry block in" << key;
+        close();
+        return false;
+    }
+
+    m_key = key;
+    return true;
+}
+
+/**
+ * Detaches from the shared memory block. If we created the block, its name
+ * is removed, the readers that are still attached keep their mapping until
+ * they detach.
+ */
+void TelemetryExport::close() {
+#if defined Q_OS_WIN
+    if (m_memory) {
+        m_memory->detach();
+        delete m_memory;
+        m_memory = Q_NULLPTR;
+    }
+#else
+    if (m_block) {
+        munmap (m_block, sizeof (Block));
+        if (m_owner)
+            shm_unlink (SHM_NAME (m_key).constData());
+    }
+#endif
+
+    m_key.clear();
+    m_owner = false;
+    m_block = Q_NULLPTR;
+}
+
+/**
+ * Copies the given \a values to the shared memory block and increments the
+ * number of updates. Does nothing if we did not create the block.
+ */
+void TelemetryExport::publish (const Values& values) {
+    if (!isOwner())
+        return;
+
+    m_block->lock.lockForWrite();
+    memcpy (&m_block->values, &values, sizeof (Values));
+    m_block->values.updates = ++m_updates;
+    m_block->lock.unlockForWrite();
+}
+
+/**
+ * Copies the last published values into \a values.
+ *
+ * Returns \c false if we are not attached to a block or if a consistent
+ * copy could not be obtained (e.g. the publisher died during a write)
+ */
+bool TelemetryExport::read (Values* values) const {
+    if (!isAttached() || !values)
+        return false;
+
+    for (int i = 0; i < MAX_READ_ATTEMPTS; ++i) {
+        unsigned sequence;
+        if (!m_block->lock.tryReadBegin (&sequence))
+            continue;
+
+        memcpy (values, &m_block->values, sizeof (Values));
+        if (!m_block->lock.readRetry (sequence))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Copies the joysticks of the given \a snapshot to the exported \a values.
+ * The values that do not fit in the exported layout are dropped.
+ */
+void TelemetryExport::copyJoysticks (const JoystickStore::Snapshot& snapshot,
+                                     Values* values) {
+    int count = qBound (0, snapshot.count, MAX_JOYSTICKS);
+
+    values->joystickCount = count;
+    memset (values->joysticks, 0, sizeof (values->joysticks));
+
+    for (int i = 0; i < count; ++i) {
+        const JoystickStore::State& state = snapshot.joysticks [i];
+        Joystick* joystick = &values->joysticks [i];
+
+        joystick->numAxes = qMin ((int) state.numAxes, MAX_AXES);
+        joystick->numPOVs = qMin ((int) state.numPOVs, MAX_POVS);
+        joystick->numButtons = state.numButtons;
+        joystick->buttons = state.buttons;
+
+        for (int axis = 0; axis < joystick->numAxes; ++axis)
+            joystick->axes [axis] = state.axes [axis];
+
+        for (int pov = 0; pov < joystick->numPOVs; ++pov)
+            joystick->povs [pov] = state.povs [pov];
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_TELEMETRY_EXPORT_H
+#define _LIB_DS_TELEMETRY_EXPORT_H
+
+#include <Core/JoystickStore.h>
+#include <Utilities/SeqLock.h>
+
+class QSharedMemory;
+
+/**
+ * \brief Publishes the state of the DS in a shared memory block
+ *
+ * The DS creates the block and refreshes it after sending every robot packet.
+ * Other processes running in the same computer (e.g. a dashboard) attach to
+ * the block with the same key and read the values directly from the shared
+ * memory, without sockets, serialization or locks.
+ *
+ * The block has a fixed layout: a header (magic number, layout version and
+ * size of the block), a \c SeqLock and the \c Values. Readers must check the
+ * header and copy the values with the sequence lock, which is what \c read()
+ * does. A reader never blocks the DS, and gives up if the DS is interrupted
+ * in the middle of a write.
+ *
+ * The key is used as the name of the block, so that it can be opened by
+ * programs that do not use Qt:
+ *   - On Unix, the block is the POSIX shared memory object \c /KEY (see
+ *     \c shm_open(), it lives in \c /dev/shm/KEY on Linux)
+ *   - On Windows, the block is the file mapping named \c KEY
+ *
+ * \note The key must not contain slashes
+ */
+class TelemetryExport {
+  public:
+    explicit TelemetryExport();
+    ~TelemetryExport();
+
+    static const quint32 MAGIC = 0x5453444c; /* "LDST" */
+    static const quint32 VERSION = 2;
+
+    static const int MAX_JOYSTICKS = 6;
+    static const int MAX_AXES = 12;
+    static const int MAX_POVS = 12;
+
+    /**
+     * Values of a joystick, in the format in which they are sent to the
+     * robot. Unused axes and POVs are zero.
+     */
+    struct Joystick {
+        DS_SByte axes [MAX_AXES]; /**< Axis values, from -128 to 127 */
+        DS_UByte numAxes;         /**< Number of axes */
+        DS_UByte numButtons;      /**< Number of buttons */
+        DS_UByte numPOVs;         /**< Number of POVs */
+        DS_UByte reserved;        /**< Unused, always zero */
+        quint32 buttons;          /**< Button states, bit N is button N */
+        qint16 povs [MAX_POVS];   /**< POV angles, -1 if not pressed */
+    };
+
+    /**
+     * Values published by the DS. Enumerated values are stored with the
+     * numeric value of the equivalent \c DriverStation enum.
+     */
+    struct Values {
+        quint64 updates;          /**< Number of updates published */
+        qint64 timestamp;         /**< Time of the update (msecs since epoch) */
+        qint64 roundTrip;         /**< Last robot round-trip time (usecs) */
+        qint32 millivolts;        /**< Robot voltage */
+        DS_UByte fmsCommStatus;   /**< FMS communication status */
+        DS_UByte radioCommStatus; /**< Radio communication status */
+        DS_UByte robotCommStatus; /**< Robot communication status */
+        DS_UByte robotCodeStatus; /**< Robot code status */
+        DS_UByte controlMode;     /**< Robot control mode */
+        DS_UByte enableStatus;    /**< Robot enable status */
+        DS_UByte operationStatus; /**< Normal or emergency stop */
+        DS_UByte voltageStatus;   /**< Normal or brownout */
+        DS_UByte alliance;        /**< Alliance of the team station */
+        DS_UByte position;        /**< Position of the team station */
+        DS_UByte cpuUsage;        /**< Robot CPU usage */
+        DS_UByte ramUsage;        /**< Robot RAM usage */
+        DS_UByte diskUsage;       /**< Robot disk usage */
+        DS_UByte packetLoss;      /**< Robot packet loss */
+        DS_UByte reserved [2];    /**< Unused, always zero */
+        quint32 joystickCount;    /**< Number of joysticks sent to the robot */
+        Joystick joysticks [MAX_JOYSTICKS]; /**< Joysticks sent to the robot */
+    };
+
+    /**
+     * Layout of the shared memory block
+     */
+    struct Block {
+        quint32 magic;   /**< Always \c MAGIC */
+        quint32 version; /**< Always \c VERSION */
+        quint32 size;    /**< Size of the block in bytes */
+        quint32 padding; /**< Unused, always zero */
+        SeqLock lock;    /**< Protects the values */
+        Values values;   /**< Last published values */
+    };
+
+    QString key() const;
+    bool isOwner() const;
+    bool isAttached() const;
+
+    bool create (const QString& key);
+    bool attach (const QString& key);
+    void close();
+
+    void publish (const Values& values);
+    bool read (Values* values) const;
+
+    static void copyJoysticks (const JoystickStore::Snapshot& snapshot,
+                               Values* values);
+
+  private:
+    bool m_owner;
+    quint64 m_updates;
+
+    QString m_key;
+    Block* m_block;
+
+#if defined Q_OS_WIN
+    QSharedMemory* m_memory;
+#endif
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Transport.h"
+
+#include <QMetaObject>
+
+/* Protects the peers of every loopback transport */
+static QMutex PEER_LOCK;
+
+Transport::Transport (QObject* parent) : QObject (parent) {}
+
+Transport::~Transport() {}
+
+LoopbackTransport::LoopbackTransport (QObject* parent) : Transport (parent) {
+    m_peer = Q_NULLPTR;
+    m_deliveryScheduled = false;
+}
+
+/**
+ * Disconnects the transport from its peer. A peer that is sending a packet
+ * to us is waited for.
+ */
+LoopbackTransport::~LoopbackTransport() {
+    QMutexLocker lock (&PEER_LOCK);
+    unlink();
+}
+
+/**
+ * Connects the \a first and \a second transports to each other, replacing
+ * their previous peers
+ */
+void LoopbackTransport::connectPair (LoopbackTransport* first,
+                                     LoopbackTransport* second) {
+    if (!first || !second || first == second)
+        return;
+
+    QMutexLocker lock (&PEER_LOCK);
+    first->unlink();
+    second->unlink();
+
+    first->m_peer = second;
+    second->m_peer = first;
+}
+
+/**
+ * Returns the transport that receives the packets sent by this transport
+ */
+LoopbackTransport* LoopbackTransport::peer() const {
+    QMutexLocker lock (&PEER_LOCK);
+    return m_peer;
+}
+
+/**
+ * Returns the number of received packets that have not been delivered yet
+ */
+int LoopbackTransport::pendingPackets() const {
+    QMutexLocker lock (&m_mutex);
+    return m_inbox.count();
+}
+
+/**
+ * Queues the given \a data in the inbox of the peer, the packet is dropped if
+ * the transport is not connected
+ */
+void LoopbackTransport::send (int target, const QByteArray& data) {
+    if (data.isEmpty())
+        return;
+
+    QMutexLocker lock (&PEER_LOCK);
+    if (m_peer)
+        m_peer->enqueue (target, data);
+}
+
+/**
+ * Emits \c packetReceived() for every packet in the inbox, in the order in
+ * which they were sent. Returns the number of delivered packets.
+ */
+int LoopbackTransport::deliverPending() {
+    QList<QPair<int, QByteArray>> packets;
+
+    {
+        QMutexLocker lock (&m_mutex);
+        packets.swap (m_inbox);
+        m_deliveryScheduled = false;
+    }
+
+    for (int i = 0; i < packets.count(); ++i)
+        emit packetReceived (packets.at (i).first, packets.at (i).second);
+
+    return packets.count();
+}
+
+/**
+ * Disconnects the transport from its peer (and the peer from us)
+ *
+ * \note Must be called with the peer lock held
+ */
+void LoopbackTransport::unlink() {
+    if (m_peer && m_peer->m_peer == this)
+        m_peer->m_peer = Q_NULLPTR;
+
+    m_peer = Q_NULLPTR;
+}
+
+/**
+ * Adds a packet to the inbox and schedules its delivery in the thread of
+ * the transport
+ */
+void LoopbackTransport::enqueue (int target, const QByteArray& data) {
+    QMutexLocker lock (&m_mutex);
+    m_inbox.append (qMakePair (target, data));
+
+    if (!m_deliveryScheduled) {
+        m_deliveryScheduled = true;
+        QMetaObject::invokeMethod (this, "deliverPending",
+                                   Qt::QueuedConnection);
+    }
+}
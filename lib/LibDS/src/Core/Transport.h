@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_TRANSPORT_H
+#define _LIB_DS_TRANSPORT_H
+
+#include <QList>
+#include <QPair>
+#include <QMutex>
+#include <QObject>
+#include <QByteArray>
+
+/**
+ * \brief Carries the packets of the \c Sockets without the network stack
+ *
+ * By default, the \c Sockets send and receive every packet through the UDP
+ * and TCP sockets of the operating system. If a transport is set with
+ * \c Sockets::setTransport(), the packets of every target are handed to the
+ * transport instead, and the packets that the transport receives are
+ * delivered to the protocol as if they came from the sockets.
+ *
+ * Packets are not framed or modified in any way, each call to \c send()
+ * corresponds to a single \c packetReceived() signal on the other end.
+ */
+class Transport : public QObject {
+    Q_OBJECT
+
+  signals:
+    void packetReceived (int target, const QByteArray& data);
+
+  public:
+    enum Target {
+        kFMS   = 0,
+        kRadio = 1,
+        kRobot = 2,
+    };
+
+    static const int TARGET_COUNT = 3;
+
+    explicit Transport (QObject* parent = Q_NULLPTR);
+    virtual ~Transport();
+
+    virtual void send (int target, const QByteArray& data) = 0;
+};
+
+/**
+ * \brief Exchanges packets with another transport of the same process
+ *
+ * Two loopback transports are connected with \c connectPair(), after which
+ * the packets sent by one of them are received by the other one (with the
+ * same target). This allows a DS and a simulated robot, FMS or radio to talk
+ * to each other without sockets, ports or kernel involvement, so any number
+ * of tests and benchmarks can run in parallel.
+ *
+ * Packets are queued in the inbox of the receiving transport and delivered
+ * in order when control returns to its event loop, or when
+ * \c deliverPending() is called. The data of the packets is shared, not
+ * copied (see \c QByteArray implicit sharing).
+ *
+ * \note The peers may live in different threads, packets are always delivered
+ *       in the thread of the receiving transport. The links between the
+ *       peers are protected by a lock that is shared by every loopback
+ *       transport, so a transport can be destroyed while its peer is sending.
+ */
+class LoopbackTransport : public Transport {
+    Q_OBJECT
+
+  public:
+    explicit LoopbackTransport (QObject* parent = Q_NULLPTR);
+    ~LoopbackTransport();
+
+    static void connectPair (LoopbackTransport* first,
+                             LoopbackTransport* second);
+
+    LoopbackTransport* peer() const;
+    int pendingPackets() const;
+
+    void send (int target, const QByteArray& data);
+
+  public slots:
+    int deliverPending();
+
+  private:
+    void enqueue (int target, const QByteArray& data);
+    void unlink();
+
+  private:
+    bool m_deliveryScheduled;
+    mutable QMutex m_mutex;
+    LoopbackTransport* m_peer;
+    QList<QPair<int, QByteArray>> m_inbox;
+};
+
+#endif
@@ -8,29 +8,120 @@
 
 #include "Watchdog.h"
 
+#include <Utilities/Clock.h>
+#include <Utilities/Tracer.h>
+
 Watchdog::Watchdog() {
-    connect (&m_timer, SIGNAL (timeout()), this, SIGNAL (expired()));
+    m_now = -1;
+    m_deadline = -1;
+    m_checkTime = -1;
+    m_expirationTime = 0;
+    m_externalClock = false;
+}
+
+/**
+ * Returns \c true if the watchdog is driven by \c tick() instead of the clock
+ */
+bool Watchdog::externalClock() const {
+    return m_externalClock;
 }
 
 /**
  * Returns the expiration time of the watchdog in milliseconds
  */
 int Watchdog::expirationTime() const {
-    return m_timer.interval();
+    return m_expirationTime;
 }
 
 /**
  * Resets the watchdog and prevents it from expiring
  */
 void Watchdog::reset() {
-    m_timer.stop();
-    m_timer.start (expirationTime());
+    if (m_externalClock) {
+        m_deadline = m_now >= 0 ? m_now + expirationTime() : -1;
+        return;
+    }
+
+    m_deadline = Clock::getInstance()->elapsed() + expirationTime();
+    scheduleCheck();
+}
+
+/**
+ * Lets an externally clocked watchdog know that the current time is \a msecs
+ * (as given by a monotonic clock). The watchdog expires (and is reset) if its
+ * deadline has been reached.
+ */
+void Watchdog::tick (qint64 msecs) {
+    if (!m_externalClock)
+        return;
+
+    m_now = msecs;
+
+    /* This is the first tick, start counting from here */
+    if (m_deadline < 0)
+        m_deadline = msecs + expirationTime();
+
+    else if (msecs >= m_deadline) {
+        m_deadline = msecs + expirationTime();
+        onTimeout();
+    }
+}
+
+/**
+ * If \a enabled is \c true, the watchdog stops using the clock and is driven
+ * by calls to \c tick() instead
+ */
+void Watchdog::setExternalClock (bool enabled) {
+    m_externalClock = enabled;
+    reset();
 }
 
 /**
  * Changes the expiration time and resets the watchdog
  */
 void Watchdog::setExpirationTime (int msecs) {
-    m_timer.setInterval (msecs);
+    m_expirationTime = qMax (msecs, 0);
     reset();
 }
+
+/**
+ * Called when a scheduled check is due. The watchdog expires (and is reset)
+ * if its deadline has been reached, otherwise, the check is scheduled again
+ * for the current deadline.
+ */
+void Watchdog::checkDeadline() {
+    m_checkTime = -1;
+    if (m_externalClock || m_deadline < 0)
+        return;
+
+    qint64 now = Clock::getInstance()->elapsed();
+    if (now >= m_deadline) {
+        m_deadline = now + expirationTime();
+        onTimeout();
+    }
+
+    scheduleCheck();
+}
+
+/**
+ * Schedules a check at the deadline of the watchdog, unless a check is
+ * already scheduled at (or before) that time
+ */
+void Watchdog::scheduleCheck() {
+    if (m_checkTime >= 0 && m_checkTime <= m_deadline)
+        return;
+
+    qint64 now = Clock::getInstance()->elapsed();
+    m_checkTime = m_deadline;
+    Clock::getInstance()->schedule (static_cast<int> (qMax (m_deadline - now,
+                                                            qint64 (0))),
+                                    this, SLOT (checkDeadline()));
+}
+
+/**
+ * Called when the watchdog expires, notifies the rest of the LibDS
+ */
+void Watchdog::onTimeout() {
+    Tracer::getInstance()->instant ("watchdog", "Watchdog expired");
+    emit expired();
+}
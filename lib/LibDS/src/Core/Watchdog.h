@@ -9,13 +9,13 @@
 #ifndef _LIB_DS_WATCHDOG_H
 #define _LIB_DS_WATCHDOG_H
 
-#include <QTimer>
+#include <QObject>
 
 /**
  * \brief Implements a simple watchdog used to reset comms. when needed.
  *
  * The \c Watchdog class implements a simple software watchdog with the help of
- * the \c QTimer object.
+ * the LibDS \c Clock.
  *
  * During normal operation, the program periodically resets the watchdog timer
  * to prevent it from expiring. If, due to an error, the program fails to reset
@@ -24,6 +24,14 @@
  * The expiration signal is then received by the current protocol, which in
  * turn will reset itself and try to re-establish communications with the robot
  * controller and the FMS.
+ *
+ * Resetting the watchdog only moves its deadline, so feeding it with every
+ * received packet does not restart any timer. A single check is scheduled at
+ * a time, and it is rescheduled for the new deadline if the watchdog was fed
+ * in the meantime.
+ *
+ * Watchdogs of externally clocked engines do not schedule any check, instead,
+ * their deadline is checked every time that \c tick() is called.
  */
 class Watchdog : public QObject {
     Q_OBJECT
@@ -33,14 +41,28 @@ class Watchdog : public QObject {
 
   public:
     explicit Watchdog();
+    bool externalClock() const;
     int expirationTime() const;
 
   public slots:
     void reset();
+    void tick (qint64 msecs);
+    void setExternalClock (bool enabled);
     void setExpirationTime (int msecs);
 
+  private slots:
+    void onTimeout();
+    void checkDeadline();
+
+  private:
+    void scheduleCheck();
+
   private:
-    QTimer m_timer;
+    qint64 m_now;
+    qint64 m_deadline;
+    qint64 m_checkTime;
+    int m_expirationTime;
+    bool m_externalClock;
 };
 
 #endif
@@ -17,28 +17,50 @@
 //------------------------------------------------------------------------------
 
 #include "Core/Logger.h"
+#include "Core/ControlServer.h"
+#include "Core/MetricsServer.h"
+#include "Core/TelemetryExport.h"
 #include "Core/Sockets.h"
 #include "Core/Protocol.h"
 #include "Core/Watchdog.h"
 #include "Core/DS_Config.h"
 #include "Core/NetConsole.h"
+#include "Utilities/Tracer.h"
+#include "Utilities/StageTimers.h"
 
 //------------------------------------------------------------------------------
 // Import protocols
 //------------------------------------------------------------------------------
 
+#if defined LIB_DS_STATIC_PROTOCOL
+#include "Core/StaticProtocol.h"
+#else
 #include "Protocols/FRC_2014.h"
 #include "Protocols/FRC_2015.h"
 #include "Protocols/FRC_2016.h"
+#endif
 
 //------------------------------------------------------------------------------
 // Import other Qt Dependencies
 //------------------------------------------------------------------------------
 
 #include <QDir>
-#include <QUrl>
-#include <QFileDialog>
-#include <QDesktopServices>
+
+/* Number of redundant copies sent after an urgent robot packet */
+const int URGENT_BURST_COUNT = 3;
+
+/* Time between the redundant copies of an urgent robot packet (msecs) */
+const int URGENT_BURST_INTERVAL = 5;
+
+/* Time between the input latency reports written to the log (nanoseconds) */
+const qint64 INPUT_LATENCY_LOG_INTERVAL = Q_INT64_C (10000000000);
+
+/* Microseconds between each loop monitor summary written to the log */
+const qint64 LOOP_MONITOR_LOG_INTERVAL = Q_INT64_C (10000000);
+
+/* State changes that are re-published as DS signals */
+const quint32 CONFIG_EVENTS = EventBus::ALL_EVENTS
+                              & ~EventBus::mask (EventBus::kPacketLoss);
 
 /**
  * Formats the input message so that it looks nice on a console display widget
@@ -48,32 +70,74 @@ static QString CONSOLE_MESSAGE (const QString& input) {
 }
 
 /**
- * Ensures that the \a input real respects the given range (\a max, \a min)
+ * Returns the given \a voltage formatted with two decimal places
+ */
+static QString VOLTAGE_STRING (qreal voltage) {
+    return QString ("%1 V").arg (voltage, 0, 'f', 2);
+}
+
+/**
+ * Returns the given elapsed time (in \a msecs) formatted as mm:ss.d
  */
-static qreal RANGE (qreal input, qreal max, qreal min) {
-    if (input > max)
-        return max;
+static QString ELAPSED_TIME_STRING (int msecs) {
+    int secs = (msecs / 1000);
+    int mins = (secs / 60) % 60;
 
-    if (input < min)
-        return min;
+    secs = secs % 60;
+    msecs = msecs % 1000;
 
-    return input;
+    return QString ("%1:%2.%3")
+           .arg (mins, 2, 10, QLatin1Char ('0'))
+           .arg (secs, 2, 10, QLatin1Char ('0'))
+           .arg (msecs / 100);
 }
 
-DriverStation::DriverStation() {
+DriverStation::DriverStation (DS_Config* config) {
     qDebug() << "Initializing DriverStation...";
 
+    /* Use the global config if we were not given one */
+    m_config = config;
+    if (!m_config)
+        m_config = DS_Config::getInstance();
+    else
+        m_config->setParent (this);
+
+    m_config->setDriverStation (this);
+
     /* Initialize the protocol, but do not allow DS to send packets */
     m_init = false;
     m_running = false;
+    m_detached = false;
     m_protocol = Q_NULLPTR;
 
     /* Initialzie misc. variables */
     m_packetLoss = 0;
+    m_urgentBurst = 0;
+    m_urgentRobotPackets = 0;
     m_fmsInterval = 1000;
     m_radioInterval = 1000;
     m_robotInterval = 1000;
 
+    /* Robot packets are encoded when they are sent by default */
+    m_robotPacketReady = false;
+    m_robotPacketLeadTime = 0;
+
+    /* Deadlines used when the DS is driven by an external clock */
+    m_nextFMSPacket = 0;
+    m_nextRadioPacket = 0;
+    m_nextRobotPacket = 0;
+    m_nextLossUpdate = 0;
+    m_nextElapsedTimeUpdate = 0;
+    m_nextInputLatencyLog = 0;
+    m_nextUrgentBurst = 0;
+    m_lastTick = 0;
+
+    /* Initialize the loop monitor (packet periods are set by the protocol) */
+    m_loopMonitorLogging = false;
+    m_nextLoopMonitorLog = 0;
+    m_loopMonitor.setPeriod (LoopMonitor::kPacketLoss, 250);
+    m_loopMonitor.setPeriod (LoopMonitor::kElapsedTime, 100);
+
     /* Initialize custom addresses */
     m_customFMSAddress = "";
     m_customRadioAddress = "";
@@ -86,6 +150,28 @@ DriverStation::DriverStation() {
     m_radioWatchdog = new Watchdog;
     m_robotWatchdog = new Watchdog;
 
+    /* The metrics server is created when the application asks for it */
+    m_metricsServer = Q_NULLPTR;
+    m_telemetry = Q_NULLPTR;
+    m_controlServer = Q_NULLPTR;
+    for (int i = 0; i < ROUND_TRIP_SLOTS; ++i) {
+        m_roundTripSequence [i] = -1;
+        m_roundTripSendTime [i] = 0;
+    }
+
+    /* Let the modules die with us (e.g. when a fleet engine is removed) */
+    m_sockets->setParent (this);
+    m_console->setParent (this);
+    m_fmsWatchdog->setParent (this);
+    m_radioWatchdog->setParent (this);
+    m_robotWatchdog->setParent (this);
+    m_sockets->setDriverStation (this);
+
+    /* Externally clocked watchdogs are checked by processTick() */
+    m_fmsWatchdog->setExternalClock (config()->externalClock());
+    m_radioWatchdog->setExternalClock (config()->externalClock());
+    m_robotWatchdog->setExternalClock (config()->externalClock());
+
     /* React when the sockets receive data from FMS, radio or robot */
     connect (m_sockets, SIGNAL (fmsPacketReceived   (QByteArray)),
              this,        SLOT (readFMSPacket       (QByteArray)));
@@ -97,61 +183,16 @@ DriverStation::DriverStation() {
     /* Begin the lookup process when the app initializes the DS */
     connect (this, SIGNAL (initialized()), m_sockets, SLOT (performLookups()));
 
-    /* Sync DS signals with DS_Config signals */
-    connect (config(), SIGNAL (allianceChanged (Alliance)),
-             this,     SIGNAL (allianceChanged (Alliance)));
-    connect (config(), SIGNAL (codeStatusChanged (CodeStatus)),
-             this,     SIGNAL (codeStatusChanged (CodeStatus)));
-    connect (config(), SIGNAL (controlModeChanged (ControlMode)),
-             this,     SIGNAL (controlModeChanged (ControlMode)));
-    connect (config(), SIGNAL (cpuUsageChanged (int)),
-             this,     SIGNAL (cpuUsageChanged (int)));
-    connect (config(), SIGNAL (diskUsageChanged (int)),
-             this,     SIGNAL (diskUsageChanged (int)));
-    connect (config(), SIGNAL (elapsedTimeChanged (int)),
-             this,     SIGNAL (elapsedTimeChanged (int)));
-    connect (config(), SIGNAL (elapsedTimeChanged (QString)),
-             this,     SIGNAL (elapsedTimeChanged (QString)));
-    connect (config(), SIGNAL (enabledChanged (EnableStatus)),
-             this,     SIGNAL (enabledChanged (EnableStatus)));
-    connect (config(), SIGNAL (fmsCommStatusChanged (CommStatus)),
-             this,     SIGNAL (fmsCommStatusChanged (CommStatus)));
-    connect (config(), SIGNAL (libVersionChanged (QString)),
-             this,     SIGNAL (libVersionChanged (QString)));
-    connect (config(), SIGNAL (operationStatusChanged (OperationStatus)),
-             this,     SIGNAL (operationStatusChanged (OperationStatus)));
-    connect (config(), SIGNAL (pcmVersionChanged (QString)),
-             this,     SIGNAL (pcmVersionChanged (QString)));
-    connect (config(), SIGNAL (pdpVersionChanged (QString)),
-             this,     SIGNAL (pdpVersionChanged (QString)));
-    connect (config(), SIGNAL (positionChanged (Position)),
-             this,     SIGNAL (positionChanged (Position)));
-    connect (config(), SIGNAL (radioAddressChanged (QString)),
-             this,     SIGNAL (radioAddressChanged (QString)));
-    connect (config(), SIGNAL (radioCommStatusChanged (CommStatus)),
-             this,     SIGNAL (radioCommStatusChanged (CommStatus)));
-    connect (config(), SIGNAL (ramUsageChanged (int)),
-             this,     SIGNAL (ramUsageChanged (int)));
-    connect (config(), SIGNAL (robotAddressChanged (QString)),
-             this,     SIGNAL (robotAddressChanged (QString)));
-    connect (config(), SIGNAL (robotCommStatusChanged (CommStatus)),
-             this,     SIGNAL (robotCommStatusChanged (CommStatus)));
-    connect (config(), SIGNAL (simulatedChanged (bool)),
-             this,     SIGNAL (simulatedChanged (bool)));
-    connect (config(), SIGNAL (statusChanged (QString)),
-             this,     SIGNAL (statusChanged (QString)));
-    connect (config(), SIGNAL (teamChanged (int)),
-             this,     SIGNAL (teamChanged (int)));
-    connect (config(), SIGNAL (voltageChanged (qreal)),
-             this,     SIGNAL (voltageChanged (qreal)));
-    connect (config(), SIGNAL (voltageChanged (QString)),
-             this,     SIGNAL (voltageChanged (QString)));
-    connect (config(), SIGNAL (voltageStatusChanged (VoltageStatus)),
-             this,     SIGNAL (voltageStatusChanged (VoltageStatus)));
-
-    /* Update the robot, radio & FMS IPs when the team number is changed */
-    connect (config(), SIGNAL (teamChanged (int)),
-             this,     SLOT   (updateAddresses (int)));
+    /* Receive the state changes of the DS_Config (directly, since it lives
+     * in our thread) and re-publish them as DS signals */
+    m_configEvents = config()->events()->subscribe (CONFIG_EVENTS, this,
+                                                    "processConfigEvents()");
+
+    /* Used to notify the robot immediately about disables, e-stops & mode
+     * changes */
+    m_lastControlMode = config()->controlMode();
+    m_lastEnableStatus = config()->enableStatus();
+    m_lastOperationStatus = config()->operationStatus();
 
     /* Set default watchdog expiration times */
     m_fmsWatchdog->setExpirationTime (1000);
@@ -177,8 +218,14 @@ DriverStation::DriverStation() {
 }
 
 DriverStation::~DriverStation() {
+    config()->events()->unsubscribe (m_configEvents);
+
     stop();
     config()->logger()->closeLogs();
+
+    delete m_protocol;
+    delete m_telemetry;
+    qDeleteAll (m_joysticks);
 }
 
 /**
@@ -312,6 +359,13 @@ QString DriverStation::logsPath() const {
     return config()->logger()->logsPath();
 }
 
+/**
+ * Returns the file extension (without the dot) of the application log files
+ */
+QString DriverStation::logsExtension() const {
+    return config()->logger()->extension();
+}
+
 /**
  * Returns the current JSON document as a variant list
  */
@@ -452,6 +506,273 @@ int DriverStation::maxJoystickCount() const {
     return 0;
 }
 
+/**
+ * Returns the number of out-of-band robot packets (including the redundant
+ * copies) that were sent because of safety-critical state changes
+ */
+int DriverStation::urgentRobotPackets() const {
+    return m_urgentRobotPackets;
+}
+
+/**
+ * Returns the number of milliseconds before its send deadline that each robot
+ * packet is encoded. A value of 0 means that robot packets are encoded when
+ * they are sent.
+ */
+int DriverStation::robotPacketLeadTime() const {
+    return m_robotPacketLeadTime;
+}
+
+/**
+ * Returns the number of FMS datagrams that were dropped by the operating
+ * system because our socket buffer was full.
+ *
+ * Comparing this value with the packet loss allows us to know if the packets
+ * are lost on the air or inside the computer.
+ *
+ * \note This value is only updated when the low-latency profile is active
+ */
+int DriverStation::fmsKernelDrops() const {
+    return static_cast<int> (m_sockets->fmsKernelDrops());
+}
+
+/**
+ * Returns the number of radio datagrams that were dropped by the operating
+ * system because our socket buffer was full.
+ *
+ * \note This value is only updated when the low-latency profile is active
+ */
+int DriverStation::radioKernelDrops() const {
+    return static_cast<int> (m_sockets->radioKernelDrops());
+}
+
+/**
+ * Returns the number of robot datagrams that were dropped by the operating
+ * system because our socket buffer was full.
+ *
+ * \note This value is only updated when the low-latency profile is active
+ */
+int DriverStation::robotKernelDrops() const {
+    return static_cast<int> (m_sockets->robotKernelDrops());
+}
+
+/**
+ * Returns the number of NetConsole messages that were dropped by the operating
+ * system because our socket buffer was full.
+ *
+ * \note This value is only updated when the low-latency profile is active
+ */
+int DriverStation::netConsoleKernelDrops() const {
+    return static_cast<int> (m_console->kernelDrops());
+}
+
+/**
+ * Returns the tuning profile applied to the robot, FMS, radio and NetConsole
+ * sockets.
+ */
+DS::SocketProfile DriverStation::socketProfile() const {
+    return m_sockets->socketProfile();
+}
+
+/**
+ * Returns \c true if the DS measures the time between each joystick change
+ * and the first robot packet that carries it
+ */
+bool DriverStation::inputLatencyEnabled() const {
+    return m_joystickStore.timestampsEnabled();
+}
+
+/**
+ * Returns a single-line summary of the input-to-wire latency (in
+ * microseconds) of the given \a joystick
+ */
+QString DriverStation::inputLatencySummary (int joystick) const {
+    const Histogram* histogram = inputLatencyHistogram (joystick);
+    if (histogram)
+        return histogram->summary();
+
+    return "";
+}
+
+/**
+ * Returns the given \a percentile of the input-to-wire latency (in
+ * microseconds) of the given \a joystick
+ */
+int DriverStation::inputLatency (int joystick, qreal percentile) const {
+    const Histogram* histogram = inputLatencyHistogram (joystick);
+    if (histogram)
+        return static_cast<int> (histogram->percentile (percentile));
+
+    return 0;
+}
+
+/**
+ * Returns the input-to-wire latency histogram of the given \a joystick, or
+ * a null pointer if the joystick ID is invalid
+ */
+const Histogram* DriverStation::inputLatencyHistogram (int joystick) const {
+    if (joystick >= 0 && joystick < JoystickStore::MAX_JOYSTICKS)
+        return &m_inputLatency [joystick];
+
+    return Q_NULLPTR;
+}
+
+/**
+ * Returns \c true if the statistics of the periodic DS loops are written to
+ * the log every 10 seconds
+ */
+bool DriverStation::loopMonitorLogging() const {
+    return m_loopMonitorLogging;
+}
+
+/**
+ * Returns a single-line summary of the measured period and worst-case
+ * lateness of the given \a loop (see \c LoopMonitor::Loop)
+ */
+QString DriverStation::loopSummary (int loop) const {
+    return m_loopMonitor.summary (loop);
+}
+
+/**
+ * Returns the worst-case lateness (in microseconds) of the given \a loop
+ * (see \c LoopMonitor::Loop) since the statistics were last cleared
+ */
+int DriverStation::loopLateness (int loop) const {
+    return static_cast<int> (m_loopMonitor.maxLateness (loop));
+}
+
+/**
+ * Returns the run count, total time, mean and longest run of each stage of
+ * the packet loop (generating and sending robot packets, reading sockets and
+ * robot packets, DS_Config updates and signal fan-out), one stage per line.
+ *
+ * \note The counters are shared by every DS in the process
+ */
+QString DriverStation::stageTimings() const {
+    return StageTimers::getInstance()->dump();
+}
+
+/**
+ * Returns the health counters of the DS (packets, watchdog expirations,
+ * round-trip time, packet loss, etc.), which can be read from any thread
+ */
+const Metrics* DriverStation::metrics() const {
+    return &m_metrics;
+}
+
+/**
+ * Serves the metrics of the DS in the Prometheus text format over HTTP, on
+ * the given TCP \a port of the loopback interface.
+ *
+ * Returns \c false if the port cannot be used
+ */
+bool DriverStation::serveMetrics (int port) {
+    if (!m_metricsServer) {
+        m_metricsServer = new MetricsServer (this);
+        m_metricsServer->addSource (&m_metrics);
+    }
+
+    return m_metricsServer->listen (port);
+}
+
+/**
+ * Serves the metrics of the DS in the Prometheus text format over HTTP, on
+ * the local (Unix domain) socket with the given \a name.
+ *
+ * Returns \c false if the socket cannot be created
+ */
+bool DriverStation::serveMetricsLocally (const QString& name) {
+    if (!m_metricsServer) {
+        m_metricsServer = new MetricsServer (this);
+        m_metricsServer->addSource (&m_metrics);
+    }
+
+    return m_metricsServer->listenLocal (name);
+}
+
+/**
+ * Returns \c true if the DS is publishing its state in a shared memory block
+ */
+bool DriverStation::telemetryExported() const {
+    return m_telemetry && m_telemetry->isOwner();
+}
+
+/**
+ * Publishes the state of the DS (refreshed with every robot packet) in the
+ * shared memory block identified by the given \a key, so that other local
+ * processes can read it with \c TelemetryExport::attach().
+ *
+ * Returns \c false if the block cannot be created
+ */
+bool DriverStation::exportTelemetry (const QString& key) {
+    if (!m_telemetry)
+        m_telemetry = new TelemetryExport;
+
+    if (!m_telemetry->create (key))
+        return false;
+
+    publishState();
+    publishTelemetry();
+    return true;
+}
+
+/**
+ * Accepts the commands of the local control protocol (see \c ControlDecoder)
+ * on the local (Unix domain) socket with the given \a name, which allows
+ * other local processes to operate the DS and to inject joystick input.
+ *
+ * Returns \c false if the socket cannot be created
+ */
+bool DriverStation::serveControl (const QString& name) {
+    if (!m_controlServer)
+        m_controlServer = new ControlServer (this, this);
+
+    return m_controlServer->listen (name);
+}
+
+/**
+ * Returns a coherent copy of the state of the DS that was published after the
+ * last robot packet was sent or received.
+ *
+ * \note Unlike the individual getters, this function can be called from any
+ *       thread
+ */
+StateSnapshot::State DriverStation::state() const {
+    return m_state.read();
+}
+
+/**
+ * Returns the object that holds the published state of the DS, which other
+ * threads can keep to read the state without calling the \c DriverStation
+ */
+const StateSnapshot* DriverStation::stateSnapshot() const {
+    return &m_state;
+}
+
+/**
+ * Returns \c true if the DS activity is being recorded in the trace timeline
+ */
+bool DriverStation::tracingEnabled() const {
+    return Tracer::isEnabled();
+}
+
+/**
+ * Writes the recorded trace timeline to the given \a file as Chrome
+ * trace-event JSON, which can be opened with \c chrome://tracing or the
+ * Perfetto UI. Returns \c false if the file cannot be written.
+ */
+bool DriverStation::saveTrace (const QString& file) const {
+    return Tracer::getInstance()->save (file);
+}
+
+/**
+ * Returns the monitor that measures the drift and jitter of the periodic
+ * DS loops
+ */
+LoopMonitor* DriverStation::loopMonitor() {
+    return &m_loopMonitor;
+}
+
 /**
  * Returns the number of axes registered with the given joystick.
  * \note This will only return the value supported by the protocol, to get
@@ -541,6 +862,44 @@ DS_Joysticks* DriverStation::joysticks() {
     return &m_joysticks;
 }
 
+/**
+ * Returns the store that holds the values of the registered joysticks.
+ * The store can be updated from any thread.
+ */
+JoystickStore* DriverStation::joystickStore() {
+    return &m_joystickStore;
+}
+
+/**
+ * Sends and receives the FMS, radio and robot packets through the given
+ * \a transport (e.g. a \c LoopbackTransport connected to a simulated robot)
+ * instead of the network. If \a transport is \c NULL, the network is used.
+ */
+void DriverStation::setTransport (Transport* transport) {
+    m_sockets->setTransport (transport);
+}
+
+/**
+ * Stops emulating a bad network link with the given \a target (e.g.
+ * \c Metrics::kRobot)
+ */
+void DriverStation::clearImpairment (int target) {
+    m_sockets->clearImpairment (target);
+}
+
+/**
+ * Emulates a bad network link with the given \a target (e.g.
+ * \c Metrics::kRobot) by dropping, delaying, reordering or duplicating its
+ * packets as described by the given \a settings. See \c Impairment for
+ * more information.
+ *
+ * \note This has no effect on detached engines, which do not use sockets
+ */
+void DriverStation::setImpairment (int target,
+                                   const Impairment::Settings& settings) {
+    m_sockets->setImpairment (target, settings);
+}
+
 /**
  * Returns the current alliance (red or blue) of the robot.
  */
@@ -756,7 +1115,12 @@ QStringList DriverStation::protocols() const {
     list.append (tr ("FRC 2016"));
     list.append (tr ("FRC 2015"));
     list.append (tr ("FRC 2014"));
+
+#if defined LIB_DS_STATIC_PROTOCOL
+    return QStringList (list.at (StaticProtocol::type()));
+#else
     return list;
+#endif
 }
 
 /**
@@ -777,7 +1141,8 @@ QStringList DriverStation::teamStations() const {
 
 /**
  * Registers a new joystick with the given number of \a axes, \a buttons &
- * \a POVs hats.
+ * \a POVs hats. The new joystick is appended to the list, so its ID is
+ * \c joystickCount() - 1 once this function returns.
  *
  * \note If joystick registration fails, this function will return \c false.
  */
@@ -817,25 +1182,22 @@ bool DriverStation::registerJoystick (int axes,
         joystick->numPOVs = qMin (povs, maxPOVCount());
         joystick->numButtons = qMin (buttons, maxButtonCount());
 
-        /* Initialize joystick values */
-        joystick->povs = new int [joystick->numPOVs];
-        joystick->axes = new qreal [joystick->numAxes];
-        joystick->buttons = new bool  [joystick->numButtons];
-
-        /* Neutralize joystick values */
-        for (int i = 0; i < joystick->numAxes; i++)
-            joystick->axes [i] = 0;
-        for (int i = 0; i < joystick->numPOVs; i++)
-            joystick->povs [i] = -1;
-        for (int i = 0; i < joystick->numButtons; i++)
-            joystick->buttons [i] = false;
+        /* Allocate the (neutral) joystick values */
+        if (!joystickStore()->addJoystick (joystick->numAxes,
+                                           joystick->numButtons,
+                                           joystick->numPOVs)) {
+            delete joystick;
+            qCritical() << "Joystick store is full!";
+            qCritical() << "Abort joystick registration";
+            return false;
+        }
 
         /* That joystick, Scotty, status report! */
         qDebug() << "Joystick registered!";
         qDebug() << "Registered joystick values:"
                  << joystick->numAxes    << "axes"
                  << joystick->numButtons << "buttons"
-                 << joystick->numButtons << "POVs";
+                 << joystick->numPOVs    << "POVs";
 
         joysticks()->append (joystick);
     }
@@ -858,36 +1220,31 @@ void DriverStation::init() {
     if (!m_init) {
         m_init = true;
 
-        config()->logger()->registerInitialEvents();
+        /* Detached engines do not write log files */
+        if (!m_detached)
+            config()->logger()->registerInitialEvents();
 
         resetFMS();
         resetRadio();
         resetRobot();
-        sendFMSPacket();
-        sendRadioPacket();
-        sendRobotPacket();
-        updatePacketLoss();
 
-        DS_Schedule (250, this, SLOT (finishInit()));
+        /* Externally clocked engines are driven by processTick() */
+        if (!config()->externalClock()) {
+            sendFMSPacket();
+            sendRadioPacket();
+            sendRobotPacket();
+            updatePacketLoss();
+            updateElapsedTime();
+            DS_Schedule (250, this, SLOT (finishInit()));
+        }
+
+        else
+            finishInit();
 
         qDebug() << "DS engine started!";
     }
 }
 
-/**
- * Shows an open file dialog and lets the user select a DS log file to load...
- */
-void DriverStation::browseLogs() {
-    QString filter = "*." + config()->logger()->extension();
-    QString file = QFileDialog::getOpenFileName (Q_NULLPTR,
-                                                 tr ("Select a log file..."),
-                                                 logsPath(),
-                                                 filter);
-
-    if (!file.isEmpty())
-        openLog (file);
-}
-
 /**
  * Reboots the robot controller (if a protocol is loaded)
  */
@@ -905,13 +1262,6 @@ void DriverStation::enableRobot() {
     setEnabled (kEnabled);
 }
 
-/**
- * Opens the application logs in an explorer window
- */
-void DriverStation::openLogsPath() {
-    QDesktopServices::openUrl (QUrl::fromLocalFile (logsPath()));
-}
-
 /**
  * Disables the robot directly
  */
@@ -925,7 +1275,10 @@ void DriverStation::disableRobot() {
 void DriverStation::resetJoysticks() {
     qDebug() << "Clearing all joysticks";
 
-    joysticks()->clear();
+    for (int id = joystickCount() - 1; id >= 0; --id)
+        takeJoystick (id);
+
+    joystickStore()->reset();
 
     if (!isConnectedToFMS())
         setEnabled (false);
@@ -994,8 +1347,23 @@ void DriverStation::triggerEmergencyStop() {
  *       takes place for axes and POVs.
  */
 void DriverStation::reconfigureJoysticks() {
-    DS_Joysticks list = m_joysticks;
-    resetJoysticks();
+    /* The joysticks that the new protocol cannot hold are removed */
+    for (int id = joystickCount() - 1; id >= maxJoystickCount(); --id)
+        takeJoystick (id);
+
+    /* The others keep their IDs, so they are re-registered silently */
+    QList<Joystick> list;
+    foreach (Joystick* joystick, m_joysticks)
+        list.append (*joystick);
+
+    qDeleteAll (*joysticks());
+    joysticks()->clear();
+    joystickStore()->reset();
+
+    if (!isConnectedToFMS())
+        setEnabled (false);
+
+    emit joystickCountChanged (joystickCount());
 
     qDebug() << "Re-generating joystick list based on protocol preferences";
     qDebug() << protocol()->name() << "supports"
@@ -1004,10 +1372,10 @@ void DriverStation::reconfigureJoysticks() {
              << maxButtonCount()   << "buttons and"
              << maxPOVCount()      << "POVs";
 
-    foreach (Joystick* joystick, list) {
-        registerJoystick (joystick->realNumAxes,
-                          joystick->realNumButtons,
-                          joystick->realNumPOVs);
+    foreach (const Joystick& joystick, list) {
+        registerJoystick (joystick.realNumAxes,
+                          joystick.realNumButtons,
+                          joystick.realNumPOVs);
     }
 }
 
@@ -1015,8 +1383,8 @@ void DriverStation::reconfigureJoysticks() {
  * Removes the joystick at the given \a id
  */
 void DriverStation::removeJoystick (int id) {
-    if (joystickCount() > id) {
-        joysticks()->removeAt (id);
+    if (id >= 0 && joystickCount() > id) {
+        takeJoystick (id);
 
         if (!isConnectedToFMS())
             setEnabled (false);
@@ -1085,8 +1453,16 @@ void DriverStation::openLog (const QString& file) {
  *
  * This function is meant to be used in co-junction of the list outputted
  * by the \c protocols() function.
+ *
+ * \note Single-protocol builds always load their built-in protocol
  */
 void DriverStation::setProtocolType (int protocol) {
+#if defined LIB_DS_STATIC_PROTOCOL
+    if ((ProtocolType) protocol != StaticProtocol::type())
+        qWarning() << "Only protocol" << StaticProtocol::type() << "is built in";
+
+    setProtocol (new StaticProtocol);
+#else
     if ((ProtocolType) protocol == kFRC2016)
         setProtocol (new FRC_2016);
 
@@ -1095,6 +1471,17 @@ void DriverStation::setProtocolType (int protocol) {
 
     if ((ProtocolType) protocol == kFRC2014)
         setProtocol (new FRC_2014);
+#endif
+}
+
+/**
+ * Changes the tuning profile of the robot, FMS, radio and NetConsole sockets.
+ *
+ * This function is meant to be used in co-junction with a combobox or a
+ * check box in the UI.
+ */
+void DriverStation::setSocketProfile (int profile) {
+    setSocketProfile ((SocketProfile) profile);
 }
 
 /**
@@ -1121,8 +1508,22 @@ void DriverStation::setPosition (Position position) {
  *       operations will be resumed automatically.
  * \note All joysticks will be reconfigured based on the standards set by the
  *       new \a protocol.
+ * \note Single-protocol builds reject (and delete) any protocol that is not
+ *       a \c StaticProtocol.
  */
 void DriverStation::setProtocol (Protocol* protocol) {
+    Tracer::Span span ("protocol", "Protocol switch");
+
+#if defined LIB_DS_STATIC_PROTOCOL
+    /* Single-protocol builds can only use the built-in protocol */
+    if (protocol && !dynamic_cast<StaticProtocol*> (protocol)) {
+        qWarning() << "Rejected protocol" << protocol->name()
+                   << "in a single-protocol build";
+        delete protocol;
+        return;
+    }
+#endif
+
     /* Decommission the current protocol */
     if (m_protocol && protocol) {
         qDebug() << "Protocol" << m_protocol->name() << "decommissioned";
@@ -1130,7 +1531,7 @@ void DriverStation::setProtocol (Protocol* protocol) {
         emit newMessage (CONSOLE_MESSAGE (tr ("DS: %1 terminated")
                                           .arg (m_protocol->name())));
 
-        free (m_protocol);
+        delete m_protocol;
     }
 
     /* Re-assign the protocol, stop sending data */
@@ -1141,22 +1542,28 @@ void DriverStation::setProtocol (Protocol* protocol) {
     if (m_protocol) {
         qDebug() << "Configuring new protocol...";
 
-        /* Update radio, FMS and robot socket types */
-        m_sockets->setFMSSocketType   (m_protocol->fmsSocketType());
-        m_sockets->setRadioSocketType (m_protocol->radioSocketType());
-        m_sockets->setRobotSocketType (m_protocol->robotSocketType());
-
-        /* Update radio, FMS and robot ports */
-        m_sockets->setFMSInputPort    (m_protocol->fmsInputPort());
-        m_sockets->setFMSOutputPort   (m_protocol->fmsOutputPort());
-        m_sockets->setRadioInputPort  (m_protocol->radioInputPort());
-        m_sockets->setRobotInputPort  (m_protocol->robotInputPort());
-        m_sockets->setRadioOutputPort (m_protocol->radioOutputPort());
-        m_sockets->setRobotOutputPort (m_protocol->robotOutputPort());
-
-        /* Update NetConsole ports */
-        m_console->setInputPort (m_protocol->netconsoleInputPort());
-        m_console->setOutputPort (m_protocol->netconsoleOutputPort());
+        /* Let the protocol access our config and joysticks */
+        m_protocol->attach (this, config());
+
+        /* Detached engines do not open any socket */
+        if (!m_detached) {
+            /* Update radio, FMS and robot socket types */
+            m_sockets->setFMSSocketType   (m_protocol->fmsSocketType());
+            m_sockets->setRadioSocketType (m_protocol->radioSocketType());
+            m_sockets->setRobotSocketType (m_protocol->robotSocketType());
+
+            /* Update radio, FMS and robot ports */
+            m_sockets->setFMSInputPort    (m_protocol->fmsInputPort());
+            m_sockets->setFMSOutputPort   (m_protocol->fmsOutputPort());
+            m_sockets->setRadioInputPort  (m_protocol->radioInputPort());
+            m_sockets->setRobotInputPort  (m_protocol->robotInputPort());
+            m_sockets->setRadioOutputPort (m_protocol->radioOutputPort());
+            m_sockets->setRobotOutputPort (m_protocol->robotOutputPort());
+
+            /* Update NetConsole ports */
+            m_console->setInputPort (m_protocol->netconsoleInputPort());
+            m_console->setOutputPort (m_protocol->netconsoleOutputPort());
+        }
 
         /* Update packet sender intervals */
         m_fmsInterval = 1000 / m_protocol->fmsFrequency();
@@ -1173,6 +1580,11 @@ void DriverStation::setProtocol (Protocol* protocol) {
         m_radioInterval -= static_cast<qreal> (m_radioInterval) * 0.1;
         m_robotInterval -= static_cast<qreal> (m_robotInterval) * 0.1;
 
+        /* Let the loop monitor know the new periods */
+        m_loopMonitor.setPeriod (LoopMonitor::kFMSPackets, m_fmsInterval);
+        m_loopMonitor.setPeriod (LoopMonitor::kRadioPackets, m_radioInterval);
+        m_loopMonitor.setPeriod (LoopMonitor::kRobotPackets, m_robotInterval);
+
         /* Update joystick config. to match protocol requirements */
         reconfigureJoysticks();
 
@@ -1203,18 +1615,30 @@ void DriverStation::setControlMode (ControlMode mode) {
     config()->updateControlMode (mode);
 }
 
+/**
+ * Changes the tuning \a profile of the robot, FMS, radio and NetConsole
+ * sockets.
+ *
+ * The low-latency profile sizes the socket buffers, marks control traffic
+ * with DSCP EF and \c SO_PRIORITY, enables busy-polling and enables the
+ * kernel drop counters (see \c robotKernelDrops()) where supported.
+ */
+void DriverStation::setSocketProfile (SocketProfile profile) {
+    m_sockets->setSocketProfile (profile);
+    m_console->setSocketProfile (profile);
+}
+
 /**
  * Updates the \a angle of the given \a pov of the joystick with the
  * specified \a id
  *
  * \note If the given joystick is invalid, this function will silently ignore
  *       your request
+ * \note This function is thread-safe, it can be called directly by input
+ *       sources that run outside of the DS thread
  */
 void DriverStation::updatePOV (int id, int pov, int angle) {
-    if (joysticks()->count() > abs (id)) {
-        if (joysticks()->at (id)->numPOVs > pov)
-            joysticks()->at (id)->povs [abs (pov)] = angle;
-    }
+    joystickStore()->setPOV (id, pov, angle);
 }
 
 /**
@@ -1233,12 +1657,11 @@ void DriverStation::setEnabled (EnableStatus status) {
  *
  * \note If the given joystick is invalid, this function will silently ignore
  *       your request
+ * \note This function is thread-safe, it can be called directly by input
+ *       sources that run outside of the DS thread
  */
 void DriverStation::updateAxis (int id, int axis, qreal value) {
-    if (joysticks()->count() > abs (id)) {
-        if (joysticks()->at (id)->numAxes > axis)
-            joysticks()->at (id)->axes [abs (axis)] = RANGE (value, 1, -1);
-    }
+    joystickStore()->setAxis (id, axis, value);
 }
 
 /**
@@ -1247,12 +1670,11 @@ void DriverStation::updateAxis (int id, int axis, qreal value) {
  *
  * \note If the given joystick is invalid, this function will silently ignore
  *       your request
+ * \note This function is thread-safe, it can be called directly by input
+ *       sources that run outside of the DS thread
  */
 void DriverStation::updateButton (int id, int button, bool state) {
-    if (joysticks()->count() > abs (id)) {
-        if (joysticks()->at (id)->numButtons > button)
-            joysticks()->at (id)->buttons [abs (button)] = state;
-    }
+    joystickStore()->setButton (id, button, state);
 }
 
 /**
@@ -1303,11 +1725,210 @@ void DriverStation::setOperationStatus (OperationStatus status) {
     config()->updateOperationStatus (status);
 }
 
+/**
+ * Sends the FMS, radio and robot packets and updates the packet loss and
+ * elapsed time once their deadlines are reached at the given \a msecs time.
+ *
+ * This function is used when several DS engines are driven by a single
+ * timer (see \c Fleet), instead of having each engine schedule its own
+ * operations. It does nothing if the DS does not use an external clock or if
+ * the DS has not been initialized yet.
+ */
+void DriverStation::processTick (qint64 msecs) {
+    if (!m_init || !config()->externalClock())
+        return;
+
+    m_lastTick = msecs;
+    m_fmsWatchdog->tick (msecs);
+    m_radioWatchdog->tick (msecs);
+    m_robotWatchdog->tick (msecs);
+
+    if (m_urgentBurst > 0 && msecs >= m_nextUrgentBurst)
+        sendUrgentBurst();
+
+    int lead = effectiveRobotPacketLeadTime();
+    if (lead > 0 && msecs >= m_nextRobotPacket - lead)
+        prepareRobotPacket();
+
+    if (msecs >= m_nextRobotPacket) {
+        m_nextRobotPacket = msecs + m_robotInterval;
+        sendRobotPacket();
+    }
+
+    if (msecs >= m_nextFMSPacket) {
+        m_nextFMSPacket = msecs + m_fmsInterval;
+        sendFMSPacket();
+    }
+
+    if (msecs >= m_nextRadioPacket) {
+        m_nextRadioPacket = msecs + m_radioInterval;
+        sendRadioPacket();
+    }
+
+    if (msecs >= m_nextLossUpdate) {
+        m_nextLossUpdate = msecs + 250;
+        updatePacketLoss();
+    }
+
+    if (msecs >= m_nextElapsedTimeUpdate) {
+        m_nextElapsedTimeUpdate = msecs + 100;
+        updateElapsedTime();
+    }
+}
+
+/**
+ * Clears the input-to-wire latency histograms of every joystick
+ */
+void DriverStation::resetInputLatency() {
+    for (int i = 0; i < JoystickStore::MAX_JOYSTICKS; ++i)
+        m_inputLatency [i].reset();
+}
+
+/**
+ * Writes the timing counters of the packet loop stages to the log
+ */
+void DriverStation::dumpStageTimings() {
+    foreach (const QString& line, stageTimings().split ("\n"))
+        qDebug() << qPrintable (line);
+}
+
+/**
+ * Stops serving the metrics of the DS
+ */
+void DriverStation::stopMetricsServer() {
+    if (m_metricsServer)
+        m_metricsServer->close();
+}
+
+/**
+ * Stops publishing the state of the DS in shared memory
+ */
+void DriverStation::stopTelemetryExport() {
+    if (m_telemetry)
+        m_telemetry->close();
+}
+
+/**
+ * Stops accepting commands from local processes
+ */
+void DriverStation::stopControlServer() {
+    if (m_controlServer)
+        m_controlServer->close();
+}
+
+/**
+ * Discards the events recorded in the trace timeline
+ */
+void DriverStation::clearTrace() {
+    Tracer::getInstance()->clear();
+}
+
+/**
+ * Starts or stops recording the DS activity (packets, watchdogs, protocol
+ * switches, lookups, log saves and the packet loop stages) in the trace
+ * timeline. See \c saveTrace() to export the timeline.
+ */
+void DriverStation::setTracingEnabled (bool enabled) {
+    Tracer::getInstance()->setEnabled (enabled);
+    qDebug() << "Tracing enabled:" << enabled;
+}
+
+/**
+ * Clears the timing counters of the packet loop stages
+ */
+void DriverStation::resetStageTimings() {
+    StageTimers::getInstance()->reset();
+}
+
+/**
+ * Clears the statistics of the periodic DS loops
+ */
+void DriverStation::resetLoopMonitor() {
+    m_loopMonitor.reset();
+}
+
+/**
+ * Sends a robot packet with the current state right away and follows it with
+ * a short burst of redundant copies, so that the robot learns about the new
+ * state even if one of the packets is lost.
+ *
+ * The urgent packets do not modify the packet counters or the schedule of the
+ * periodic robot packets.
+ *
+ * If the next periodic packet was already generated ahead of its deadline,
+ * the urgent packets reuse its sequence number instead of overtaking it, so
+ * that the robot never receives the sequence numbers out of order.
+ */
+void DriverStation::sendUrgentRobotPacket() {
+    if (!protocol() || !running())
+        return;
+
+    Tracer::getInstance()->instant ("packets", "Urgent robot packet");
+
+    QByteArray data = protocol()->generateUrgentRobotPacket (m_robotPacketReady);
+    transmit (Metrics::kRobot, data, true);
+
+    ++m_urgentRobotPackets;
+
+    if (m_urgentBurst == 0)
+        scheduleUrgentBurst();
+
+    m_urgentBurst = URGENT_BURST_COUNT;
+}
+
+/**
+ * Enables or disables the input-to-wire latency instrumentation.
+ *
+ * When enabled, every joystick change is timestamped with a monotonic clock
+ * and the time until the first robot packet that carries the change is sent
+ * is recorded in a histogram for each joystick. A summary of the histograms
+ * is written to the log every 10 seconds.
+ */
+void DriverStation::setInputLatencyEnabled (bool enabled) {
+    if (enabled != inputLatencyEnabled()) {
+        resetInputLatency();
+        m_joystickStore.setTimestampsEnabled (enabled);
+        m_nextInputLatencyLog = JoystickStore::timestamp()
+                                + INPUT_LATENCY_LOG_INTERVAL;
+
+        qDebug() << "Input latency instrumentation enabled:" << enabled;
+    }
+}
+
+/**
+ * Makes the DS generate each robot packet \a msecs milliseconds before its
+ * send deadline. When the deadline is reached, only the latest robot state
+ * and joystick values are patched into the packet before sending it, so that
+ * the time spent encoding the packet does not delay the send.
+ *
+ * A value of 0 (the default) disables the pipelining and robot packets are
+ * generated when they are sent.
+ *
+ * \note The lead time is limited to one millisecond less than the robot
+ *       packet interval of the current protocol, and it is ignored by the
+ *       protocols that cannot patch their robot packets (e.g. FRC 2014)
+ */
+void DriverStation::setRobotPacketLeadTime (int msecs) {
+    m_robotPacketLeadTime = qMax (msecs, 0);
+    qDebug() << "Robot packet lead time set to" << m_robotPacketLeadTime;
+}
+
+/**
+ * Enables or disables writing the statistics of the periodic DS loops (FMS,
+ * radio and robot packets, packet loss and elapsed time) to the log every
+ * 10 seconds
+ */
+void DriverStation::setLoopMonitorLogging (bool enabled) {
+    m_loopMonitorLogging = enabled;
+    m_nextLoopMonitorLog = LoopMonitor::timestamp() + LOOP_MONITOR_LOG_INTERVAL;
+}
+
 /**
  * Inhibits the DS to send and receive packets
  */
 void DriverStation::stop() {
     m_running = false;
+    m_robotPacketReady = false;
     qDebug() << "DS networking operations stopped";
 }
 
@@ -1323,6 +1944,9 @@ void DriverStation::start() {
  * Called when the FMS watchdog expires
  */
 void DriverStation::resetFMS() {
+    if (sender() == m_fmsWatchdog)
+        m_metrics.watchdogExpired (Metrics::kFMS);
+
     if (protocol())
         protocol()->onFMSWatchdogExpired();
 
@@ -1333,6 +1957,9 @@ void DriverStation::resetFMS() {
  * Called when the radio watchdog expires
  */
 void DriverStation::resetRadio() {
+    if (sender() == m_radioWatchdog)
+        m_metrics.watchdogExpired (Metrics::kRadio);
+
     if (protocol())
         protocol()->onRadioWatchdogExpired();
 
@@ -1343,6 +1970,9 @@ void DriverStation::resetRadio() {
  * Called when the robot watchdog expires
  */
 void DriverStation::resetRobot() {
+    if (sender() == m_robotWatchdog)
+        m_metrics.watchdogExpired (Metrics::kRobot);
+
     if (protocol()) {
         protocol()->resetLossCounter();
         protocol()->onRobotWatchdogExpired();
@@ -1372,10 +2002,26 @@ void DriverStation::finishInit() {
  * the FMS
  */
 void DriverStation::sendFMSPacket() {
-    if (protocol() && running() && isConnectedToFMS())
-        m_sockets->sendToFMS (protocol()->generateFMSPacket());
+    markLoop (LoopMonitor::kFMSPackets);
+
+    if (protocol() && running() && isConnectedToFMS()) {
+        Tracer::Span span ("packets", "Send FMS packet");
+        transmit (Metrics::kFMS, protocol()->generateFMSPacket());
+    }
 
-    DS_Schedule (m_fmsInterval, this, SLOT (sendFMSPacket()));
+    if (!config()->externalClock())
+        DS_Schedule (m_fmsInterval, this, SLOT (sendFMSPacket()));
+}
+
+/**
+ * Updates the elapsed time of the robot every 100 milliseconds
+ */
+void DriverStation::updateElapsedTime() {
+    markLoop (LoopMonitor::kElapsedTime);
+    config()->updateElapsedTime();
+
+    if (!config()->externalClock())
+        DS_Schedule (100, this, SLOT (updateElapsedTime()));
 }
 
 /**
@@ -1392,26 +2038,314 @@ void DriverStation::updateAddresses() {
  * Generates and sends a new radio packet
  */
 void DriverStation::sendRadioPacket() {
-    if (protocol() && running())
-        m_sockets->sendToRadio (protocol()->generateRadioPacket());
+    markLoop (LoopMonitor::kRadioPackets);
 
-    DS_Schedule (m_radioInterval, this, SLOT (sendRadioPacket()));
+    if (protocol() && running()) {
+        Tracer::Span span ("packets", "Send radio packet");
+        transmit (Metrics::kRadio, protocol()->generateRadioPacket());
+    }
+
+    if (!config()->externalClock())
+        DS_Schedule (m_radioInterval, this, SLOT (sendRadioPacket()));
 }
 
 /**
- * Generates and sends a new robot packet
+ * Sends a new robot packet.
+ *
+ * If the packet was already generated by \c prepareRobotPacket(), only the
+ * latest robot state and joystick values are patched into it before sending
+ * it. Otherwise, the packet is generated here.
  */
 void DriverStation::sendRobotPacket() {
-    if (protocol() && running())
-        m_sockets->sendToRobot (protocol()->generateRobotPacket());
+    markLoop (LoopMonitor::kRobotPackets);
+
+    if (protocol() && running()) {
+        Tracer::Span span ("packets", "Send robot packet");
+
+        {
+            StageTimers::Scope timer (StageTimers::kGenerateRobotPacket);
+            if (m_robotPacketReady)
+                protocol()->patchRobotPacket (&m_robotPacket);
+            else
+                m_robotPacket = protocol()->generateRobotPacket();
+        }
+
+        {
+            StageTimers::Scope timer (StageTimers::kSendToRobot);
+            transmit (Metrics::kRobot, m_robotPacket);
+        }
+
+        robotPacketSent();
+    }
+
+    if (!config()->externalClock()) {
+        int lead = effectiveRobotPacketLeadTime();
+        if (lead > 0)
+            DS_Schedule (m_robotInterval - lead, this, SLOT (prepareRobotPacket()));
 
-    DS_Schedule (m_robotInterval, this, SLOT (sendRobotPacket()));
+        DS_Schedule (m_robotInterval, this, SLOT (sendRobotPacket()));
+    }
+}
+
+/**
+ * Generates the next robot packet ahead of its send deadline, so that
+ * \c sendRobotPacket() only needs to patch it and hand it to the socket
+ */
+void DriverStation::prepareRobotPacket() {
+    if (protocol() && running() && !m_robotPacketReady) {
+        m_robotPacket = protocol()->generateRobotPacket();
+        m_robotPacketReady = true;
+    }
+}
+
+/**
+ * Records the periodic robot packet that was just sent (for the round-trip
+ * time and input latency measurements) and publishes the new DS state
+ */
+void DriverStation::robotPacketSent() {
+    /* Remember when the packet was sent to measure its round-trip time */
+    int sequence = protocol()->sentRobotPackets() & 0xffff;
+    int slot = sequence % ROUND_TRIP_SLOTS;
+    m_roundTripSequence [slot] = sequence;
+    m_roundTripSendTime [slot] = LoopMonitor::timestamp();
+
+    m_robotPacketReady = false;
+
+    if (inputLatencyEnabled() && protocol()->joysticksEncoded())
+        recordInputLatency();
+
+    publishState();
+
+    if (telemetryExported())
+        publishTelemetry();
+}
+
+/**
+ * Gathers the current state of the DS and publishes it as a new version of
+ * the state snapshot
+ */
+void DriverStation::publishState() {
+    StateSnapshot::State state;
+    memset (&state, 0, sizeof (state));
+
+    state.timestamp = LoopMonitor::timestamp();
+    state.roundTrip = m_metrics.lastRoundTrip();
+    state.voltage = currentBatteryVoltage();
+    state.team = team();
+    state.cpuUsage = cpuUsage();
+    state.ramUsage = ramUsage();
+    state.diskUsage = diskUsage();
+    state.packetLoss = packetLoss();
+    state.urgentRobotPackets = urgentRobotPackets();
+    state.simulated = isSimulated();
+    state.alliance = alliance();
+    state.position = position();
+    state.controlMode = controlMode();
+    state.enableStatus = enableStatus();
+    state.robotCodeStatus = robotCodeStatus();
+    state.fmsCommStatus = fmsCommStatus();
+    state.radioCommStatus = radioCommStatus();
+    state.robotCommStatus = robotCommStatus();
+    state.voltageStatus = voltageStatus();
+    state.operationStatus = operationStatus();
+
+    if (protocol()) {
+        state.sentRobotPackets = protocol()->sentRobotPackets();
+        state.receivedRobotPackets = protocol()->receivedRobotPackets();
+    }
+
+    m_state.publish (state);
+}
+
+/**
+ * Copies the last published state of the DS and the joystick values that
+ * were sent to the robot to the shared memory block
+ */
+void DriverStation::publishTelemetry() {
+    if (!telemetryExported())
+        return;
+
+    StateSnapshot::State state = m_state.read();
+
+    TelemetryExport::Values values;
+    memset (&values, 0, sizeof (values));
+
+    values.timestamp = QDateTime::currentMSecsSinceEpoch();
+    values.roundTrip = state.roundTrip;
+    values.millivolts = qRound (state.voltage * 1000);
+    values.fmsCommStatus = state.fmsCommStatus;
+    values.radioCommStatus = state.radioCommStatus;
+    values.robotCommStatus = state.robotCommStatus;
+    values.robotCodeStatus = state.robotCodeStatus;
+    values.controlMode = state.controlMode;
+    values.enableStatus = state.enableStatus;
+    values.operationStatus = state.operationStatus;
+    values.voltageStatus = state.voltageStatus;
+    values.alliance = state.alliance;
+    values.position = state.position;
+    values.cpuUsage = state.cpuUsage;
+    values.ramUsage = state.ramUsage;
+    values.diskUsage = state.diskUsage;
+    values.packetLoss = state.packetLoss;
+
+    if (protocol() && protocol()->joysticksEncoded())
+        TelemetryExport::copyJoysticks (protocol()->joystickSnapshot(), &values);
+    else
+        TelemetryExport::copyJoysticks (m_joystickStore.snapshot(), &values);
+
+    m_telemetry->publish (values);
+}
+
+/**
+ * Sends the next redundant copy of an urgent robot packet
+ */
+void DriverStation::sendUrgentBurst() {
+    if (m_urgentBurst <= 0 || !protocol() || !running()) {
+        m_urgentBurst = 0;
+        return;
+    }
+
+    /* Reuse the number of the periodic packet generated ahead of time */
+    QByteArray data =
+        protocol()->generateUrgentRobotPacket (m_robotPacketReady);
+    transmit (Metrics::kRobot, data, true);
+    ++m_urgentRobotPackets;
+    --m_urgentBurst;
+
+    if (m_urgentBurst > 0)
+        scheduleUrgentBurst();
+}
+
+/**
+ * Emits the signals that correspond to the state changes published by the
+ * \c DS_Config. Every change is emitted once, and the general status and
+ * the safety state are checked once for every batch of changes.
+ */
+void DriverStation::processConfigEvents() {
+    bool updateStatus = false;
+    bool updateSafety = false;
+
+    EventBus::Event event;
+    while (m_configEvents && m_configEvents->next (&event)) {
+        switch (event.type) {
+        case EventBus::kTeam:
+            emit teamChanged (event.value);
+            updateAddresses();
+            break;
+        case EventBus::kCpuUsage:
+            emit cpuUsageChanged (event.value);
+            break;
+        case EventBus::kRamUsage:
+            emit ramUsageChanged (event.value);
+            break;
+        case EventBus::kDiskUsage:
+            emit diskUsageChanged (event.value);
+            break;
+        case EventBus::kVoltage:
+            emit voltageChanged (event.real);
+            emit voltageChanged (VOLTAGE_STRING (event.real));
+            break;
+        case EventBus::kSimulated:
+            emit simulatedChanged (event.value != 0);
+            break;
+        case EventBus::kAlliance:
+            emit allianceChanged ((Alliance) event.value);
+            break;
+        case EventBus::kPosition:
+            emit positionChanged ((Position) event.value);
+            break;
+        case EventBus::kCodeStatus:
+            emit codeStatusChanged ((CodeStatus) event.value);
+            updateStatus = true;
+            break;
+        case EventBus::kControlMode:
+            emit controlModeChanged ((ControlMode) event.value);
+            updateStatus = true;
+            updateSafety = true;
+            break;
+        case EventBus::kEnableStatus:
+            emit enabledChanged ((EnableStatus) event.value);
+            updateStatus = true;
+            updateSafety = true;
+            break;
+        case EventBus::kFMSCommStatus:
+            emit fmsCommStatusChanged ((CommStatus) event.value);
+            updateStatus = true;
+            break;
+        case EventBus::kRadioCommStatus:
+            emit radioCommStatusChanged ((CommStatus) event.value);
+            break;
+        case EventBus::kRobotCommStatus:
+            emit robotCommStatusChanged ((CommStatus) event.value);
+            updateStatus = true;
+            break;
+        case EventBus::kVoltageStatus:
+            emit voltageStatusChanged ((VoltageStatus) event.value);
+            updateStatus = true;
+            break;
+        case EventBus::kOperationStatus:
+            emit operationStatusChanged ((OperationStatus) event.value);
+            updateStatus = true;
+            updateSafety = true;
+            break;
+        case EventBus::kElapsedTime:
+            emit elapsedTimeChanged (event.value);
+            emit elapsedTimeChanged (ELAPSED_TIME_STRING (event.value));
+            break;
+        case EventBus::kLibVersion:
+            emit libVersionChanged (config()->libVersion());
+            break;
+        case EventBus::kPcmVersion:
+            emit pcmVersionChanged (config()->pcmVersion());
+            break;
+        case EventBus::kPdpVersion:
+            emit pdpVersionChanged (config()->pdpVersion());
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (updateSafety)
+        checkSafetyState();
+
+    if (updateStatus)
+        emit statusChanged (generalStatus());
+}
+
+/**
+ * Sends an urgent robot packet when the robot is disabled, emergency stopped
+ * or when its control mode is changed (regardless if the change was done by
+ * the user, the FMS or the robot)
+ */
+void DriverStation::checkSafetyState() {
+    bool urgent = false;
+
+    if (config()->enableStatus() != m_lastEnableStatus) {
+        m_lastEnableStatus = config()->enableStatus();
+        urgent |= (m_lastEnableStatus == kDisabled);
+    }
+
+    if (config()->operationStatus() != m_lastOperationStatus) {
+        m_lastOperationStatus = config()->operationStatus();
+        urgent |= (m_lastOperationStatus == kEmergencyStop);
+    }
+
+    if (config()->controlMode() != m_lastControlMode) {
+        m_lastControlMode = config()->controlMode();
+        urgent = true;
+    }
+
+    if (urgent)
+        sendUrgentRobotPacket();
 }
 
 /**
  * Calculates the current packet loss as a percent
  */
 void DriverStation::updatePacketLoss() {
+    markLoop (LoopMonitor::kPacketLoss);
+
     qreal loss = 0;
     qreal sentPackets = 0;
     qreal recvPackets = 0;
@@ -1428,12 +2362,29 @@ void DriverStation::updatePacketLoss() {
     else if (!isConnectedToRobot())
         loss = 100;
 
-    /* Update packet loss */
-    m_packetLoss = static_cast<int> (loss);
-    config()->logger()->registerPacketLoss (m_packetLoss);
+    /* Update packet loss (urgent packets may be answered, but are not counted) */
+    m_packetLoss = static_cast<int> (qBound (qreal (0), loss, qreal (100)));
+    config()->events()->publish (EventBus::kPacketLoss, m_packetLoss);
+
+    /* Sample the gauges of the metrics */
+    m_metrics.setPacketLoss (m_packetLoss);
+    m_metrics.setVoltage (config()->voltage());
+    m_metrics.setCpuUsage (config()->cpuUsage());
+    m_metrics.setLogEvents (config()->logger()->eventCount());
+
+    /* Write the loop statistics to the log */
+    if (m_loopMonitorLogging) {
+        qint64 now = LoopMonitor::timestamp();
+        if (now >= m_nextLoopMonitorLog) {
+            m_nextLoopMonitorLog = now + LOOP_MONITOR_LOG_INTERVAL;
+            for (int i = 0; i < LoopMonitor::LOOP_COUNT; ++i)
+                qDebug() << qPrintable (m_loopMonitor.summary (i));
+        }
+    }
 
     /* Schedule next loss calculation */
-    DS_Schedule (250, this, SLOT (updatePacketLoss()));
+    if (!config()->externalClock())
+        DS_Schedule (250, this, SLOT (updatePacketLoss()));
 }
 
 /**
@@ -1463,6 +2414,8 @@ void DriverStation::updateLogs (const QString& file) {
  */
 void DriverStation::readFMSPacket (const QByteArray& data) {
     if (protocol() && running()) {
+        Tracer::Span span ("packets", "Read FMS packet");
+        m_metrics.packetReceived (Metrics::kFMS);
         if (protocol()->readFMSPacket (data))
             m_fmsWatchdog->reset();
     }
@@ -1474,6 +2427,8 @@ void DriverStation::readFMSPacket (const QByteArray& data) {
  */
 void DriverStation::readRadioPacket (const QByteArray& data) {
     if (protocol() && running()) {
+        Tracer::Span span ("packets", "Read radio packet");
+        m_metrics.packetReceived (Metrics::kRadio);
         if (protocol()->readRadioPacket (data))
             m_radioWatchdog->reset();
     }
@@ -1485,8 +2440,14 @@ void DriverStation::readRadioPacket (const QByteArray& data) {
  */
 void DriverStation::readRobotPacket (const QByteArray& data) {
     if (protocol() && running()) {
+        StageTimers::Scope timer (StageTimers::kReadRobotPacket);
+        m_metrics.packetReceived (Metrics::kRobot);
+        recordRoundTrip (data);
+
         if (protocol()->readRobotPacket (data))
             m_robotWatchdog->reset();
+
+        publishState();
     }
 }
 
@@ -1501,15 +2462,150 @@ void DriverStation::readRobotPacket (const QByteArray& data) {
  * fired when necessary.
  */
 DS_Config* DriverStation::config() const {
-    return DS_Config::getInstance();
+    return m_config;
 }
 
 /**
  * Returns a pointer to the current loaded protocol.
  * \warning Always check if the pointer is not \c NULL before using it!
+ *
+ * \note In single-protocol builds, the pointer has the (final) type of the
+ *       built-in protocol, so that the compiler can inline its functions
+ */
+DriverStation::HostProtocol* DriverStation::protocol() const {
+    return static_cast<HostProtocol*> (m_protocol);
+}
+
+/**
+ * Returns the robot packet lead time, limited to the robot packet interval.
+ * The lead time is 0 if the protocol cannot patch its robot packets, since
+ * the packets would be encoded twice.
  */
-Protocol* DriverStation::protocol() const {
-    return m_protocol;
+int DriverStation::effectiveRobotPacketLeadTime() const {
+    if (!protocol() || !protocol()->supportsRobotPacketPatching())
+        return 0;
+
+    return qBound (0, m_robotPacketLeadTime, m_robotInterval - 1);
+}
+
+/**
+ * Records the latency of the joystick changes carried by the robot packet
+ * that was just sent and periodically writes the histograms to the log
+ */
+void DriverStation::recordInputLatency() {
+    qint64 now = JoystickStore::timestamp();
+    const JoystickStore::Snapshot& sent = protocol()->joystickSnapshot();
+
+    for (int i = 0; i < sent.count; ++i) {
+        if (sent.joysticks [i].changeTime != 0) {
+            qint64 latency = now - sent.joysticks [i].changeTime;
+            m_inputLatency [i].record (latency / 1000);
+        }
+    }
+
+    joystickStore()->markSent (sent);
+
+    if (now >= m_nextInputLatencyLog) {
+        m_nextInputLatencyLog = now + INPUT_LATENCY_LOG_INTERVAL;
+
+        for (int i = 0; i < sent.count; ++i) {
+            if (m_inputLatency [i].count() > 0)
+                qDebug() << "Joystick" << i << "input latency:"
+                         << qPrintable (m_inputLatency [i].summary());
+        }
+    }
+}
+
+/**
+ * Measures the round-trip time of the robot packet echoed by the given robot
+ * packet \a data, if the protocol supports it
+ */
+void DriverStation::recordRoundTrip (const QByteArray& data) {
+    int sequence = protocol()->robotPacketEcho (data);
+    if (sequence < 0)
+        return;
+
+    int slot = sequence % ROUND_TRIP_SLOTS;
+    if (m_roundTripSequence [slot] == sequence) {
+        m_roundTripSequence [slot] = -1;
+        m_metrics.recordRoundTrip (LoopMonitor::timestamp()
+                                   - m_roundTripSendTime [slot]);
+    }
+}
+
+/**
+ * Sends the next redundant copy of an urgent robot packet after a short
+ * delay, which is measured by the external clock if the DS uses one
+ */
+void DriverStation::scheduleUrgentBurst() {
+    if (config()->externalClock())
+        m_nextUrgentBurst = m_lastTick + URGENT_BURST_INTERVAL;
+    else
+        DS_Schedule (URGENT_BURST_INTERVAL, this, SLOT (sendUrgentBurst()));
+}
+
+/**
+ * Registers that the given \a loop has just fired. The loops of an
+ * externally clocked DS are timed with the time of the current tick.
+ */
+void DriverStation::markLoop (int loop) {
+    if (config()->externalClock())
+        m_loopMonitor.mark (loop, m_lastTick * 1000);
+    else
+        m_loopMonitor.mark (loop);
+}
+
+/**
+ * Removes the joystick with the given \a id from the list and the store.
+ *
+ * The \c joystickAboutToBeRemoved() and \c joystickRemoved() signals are
+ * emitted around the removal, which allows input backends that write to the
+ * store from other threads to stop their writes and to move down the IDs of
+ * the joysticks that follow the removed one.
+ */
+void DriverStation::takeJoystick (int id) {
+    emit joystickAboutToBeRemoved (id);
+
+    delete joysticks()->takeAt (id);
+    joystickStore()->removeJoystick (id);
+
+    emit joystickRemoved (id);
+}
+
+/**
+ * Stops using the sockets of the DS. The packets generated by a detached DS
+ * are queued in the outbox (which is drained by its \c Engine) and the
+ * received packets are fed by the \c Engine.
+ *
+ * \note This must be called before loading a protocol
+ */
+void DriverStation::detach() {
+    m_detached = true;
+    disconnect (this, SIGNAL (initialized()), m_sockets, SLOT (performLookups()));
+}
+
+/**
+ * Sends the given \a data to the given \a target (see \c Metrics::Target).
+ * If \a now is \c true, TCP frames are written immediately.
+ */
+void DriverStation::transmit (int target, const QByteArray& data, bool now) {
+    m_metrics.packetSent (target);
+
+    if (m_detached) {
+        if (!data.isEmpty())
+            m_outbox.append (qMakePair (target, data));
+
+        return;
+    }
+
+    if (target == Metrics::kFMS)
+        m_sockets->sendToFMS (data);
+    else if (target == Metrics::kRadio)
+        m_sockets->sendToRadio (data);
+    else if (now)
+        m_sockets->sendToRobotNow (data);
+    else
+        m_sockets->sendToRobot (data);
 }
 
 /*
@@ -10,12 +10,24 @@
 #define _LIB_DS_DRIVERSTATION_H
 
 #include <Core/DS_Base.h>
+#include <Core/Metrics.h>
+#include <Core/LoopMonitor.h>
+#include <Core/EventBus.h>
+#include <Core/Impairment.h>
+#include <Core/JoystickStore.h>
+#include <Core/StateSnapshot.h>
+#include <Utilities/Histogram.h>
 
 class Sockets;
 class Watchdog;
 class Protocol;
 class DS_Config;
+class StaticProtocol;
 class NetConsole;
+class ControlServer;
+class MetricsServer;
+class TelemetryExport;
+class Transport;
 
 /**
  * \brief Exposes the functionality of the LibDS to the application
@@ -30,6 +42,8 @@ class NetConsole;
  */
 class DriverStation : public DS_Base {
     Q_OBJECT
+    friend class Engine;
+    friend class FleetScheduler;
     Q_ENUMS (ProtocolType)
     Q_ENUMS (TeamStation)
 
@@ -38,7 +52,9 @@ class DriverStation : public DS_Base {
     void initialized();
     void logFileChanged();
     void protocolChanged();
+    void joystickRemoved (int id);
     void joystickCountChanged (int count);
+    void joystickAboutToBeRemoved (int id);
     void newMessage (const QString& message);
 
   public:
@@ -77,6 +93,7 @@ class DriverStation : public DS_Base {
     Q_INVOKABLE bool isRobotCodeRunning() const;
 
     Q_INVOKABLE QString logsPath() const;
+    Q_INVOKABLE QString logsExtension() const;
     Q_INVOKABLE QVariant logVariant() const;
     Q_INVOKABLE QStringList availableLogs() const;
     Q_INVOKABLE QJsonDocument logDocument() const;
@@ -95,6 +112,42 @@ class DriverStation : public DS_Base {
     Q_INVOKABLE int maxButtonCount() const;
     Q_INVOKABLE int maxJoystickCount() const;
 
+    Q_INVOKABLE int urgentRobotPackets() const;
+    Q_INVOKABLE int robotPacketLeadTime() const;
+
+    Q_INVOKABLE int fmsKernelDrops() const;
+    Q_INVOKABLE int radioKernelDrops() const;
+    Q_INVOKABLE int robotKernelDrops() const;
+    Q_INVOKABLE int netConsoleKernelDrops() const;
+    Q_INVOKABLE SocketProfile socketProfile() const;
+
+    Q_INVOKABLE bool inputLatencyEnabled() const;
+    Q_INVOKABLE QString inputLatencySummary (int joystick) const;
+    Q_INVOKABLE int inputLatency (int joystick, qreal percentile = 50) const;
+    const Histogram* inputLatencyHistogram (int joystick) const;
+
+    Q_INVOKABLE bool loopMonitorLogging() const;
+    Q_INVOKABLE QString loopSummary (int loop) const;
+    Q_INVOKABLE int loopLateness (int loop) const;
+    LoopMonitor* loopMonitor();
+
+    Q_INVOKABLE QString stageTimings() const;
+
+    const Metrics* metrics() const;
+    Q_INVOKABLE bool serveMetrics (int port);
+    Q_INVOKABLE bool serveMetricsLocally (const QString& name);
+
+    StateSnapshot::State state() const;
+    const StateSnapshot* stateSnapshot() const;
+
+    Q_INVOKABLE bool telemetryExported() const;
+    Q_INVOKABLE bool exportTelemetry (const QString& key);
+
+    Q_INVOKABLE bool serveControl (const QString& name);
+
+    Q_INVOKABLE bool tracingEnabled() const;
+    Q_INVOKABLE bool saveTrace (const QString& file) const;
+
     Q_INVOKABLE int getNumAxes (int joystick);
     Q_INVOKABLE int getNumPOVs (int joystick);
     Q_INVOKABLE int getNumButtons (int joystick);
@@ -104,6 +157,10 @@ class DriverStation : public DS_Base {
 
     Q_INVOKABLE int joystickCount();
     Q_INVOKABLE DS_Joysticks* joysticks();
+    JoystickStore* joystickStore();
+    void setTransport (Transport* transport);
+    void clearImpairment (int target);
+    void setImpairment (int target, const Impairment::Settings& settings);
 
     Q_INVOKABLE Alliance alliance() const;
     Q_INVOKABLE Position position() const;
@@ -134,10 +191,8 @@ class DriverStation : public DS_Base {
 
   public slots:
     void init();
-    void browseLogs();
     void rebootRobot();
     void enableRobot();
-    void openLogsPath();
     void disableRobot();
     void resetJoysticks();
     void setTeam (int team);
@@ -152,10 +207,12 @@ class DriverStation : public DS_Base {
     void setTeamStation (int station);
     void openLog (const QString& file);
     void setProtocolType (int protocol);
+    void setSocketProfile (int profile);
     void setAlliance (Alliance alliance);
     void setPosition (Position position);
     void setProtocol (Protocol* protocol);
     void setControlMode (ControlMode mode);
+    void setSocketProfile (SocketProfile profile);
     void updatePOV (int id, int pov, int angle);
     void setEnabled (EnableStatus statusChanged);
     void updateAxis (int id, int axis, qreal value);
@@ -164,6 +221,20 @@ class DriverStation : public DS_Base {
     void setCustomRadioAddress (const QString& address);
     void setCustomRobotAddress (const QString& address);
     void setOperationStatus (OperationStatus statusChanged);
+    void processTick (qint64 msecs);
+    void resetInputLatency();
+    void sendUrgentRobotPacket();
+    void setInputLatencyEnabled (bool enabled);
+    void setRobotPacketLeadTime (int msecs);
+    void resetLoopMonitor();
+    void clearTrace();
+    void stopMetricsServer();
+    void stopTelemetryExport();
+    void stopControlServer();
+    void dumpStageTimings();
+    void setTracingEnabled (bool enabled);
+    void resetStageTimings();
+    void setLoopMonitorLogging (bool enabled);
 
   private slots:
     void stop();
@@ -175,8 +246,13 @@ class DriverStation : public DS_Base {
     void sendFMSPacket();
     void updateAddresses();
     void sendRadioPacket();
+    void updateElapsedTime();
     void sendRobotPacket();
     void updatePacketLoss();
+    void prepareRobotPacket();
+    void sendUrgentBurst();
+    void checkSafetyState();
+    void processConfigEvents();
     void updateAddresses (int unused);
     void updateLogs (const QString& file);
     void readFMSPacket (const QByteArray& data);
@@ -184,27 +260,51 @@ class DriverStation : public DS_Base {
     void readRobotPacket (const QByteArray& data);
 
   protected:
-    explicit DriverStation();
+    explicit DriverStation (DS_Config* config = Q_NULLPTR);
     ~DriverStation();
 
+  private:
+    void markLoop (int loop);
+    void takeJoystick (int id);
+
   private:
     bool m_init;
     bool m_running;
+    bool m_detached;
+    bool m_robotPacketReady;
+    bool m_loopMonitorLogging;
 
     int m_packetLoss;
+    int m_urgentBurst;
+    int m_urgentRobotPackets;
     int m_fmsInterval;
     int m_radioInterval;
     int m_robotInterval;
+    int m_robotPacketLeadTime;
+
+    qint64 m_nextFMSPacket;
+    qint64 m_nextRadioPacket;
+    qint64 m_nextRobotPacket;
+    qint64 m_nextLossUpdate;
+    qint64 m_nextElapsedTimeUpdate;
+    qint64 m_nextInputLatencyLog;
+    qint64 m_nextLoopMonitorLog;
+    qint64 m_nextUrgentBurst;
+    qint64 m_lastTick;
 
     QString m_logDocumentPath;
+    QByteArray m_robotPacket;
+    QList<QPair<int, QByteArray>> m_outbox;
 
     DS_Joysticks m_joysticks;
+    JoystickStore m_joystickStore;
     QString m_customFMSAddress;
     QJsonDocument m_logDocument;
     QString m_customRadioAddress;
     QString m_customRobotAddress;
 
     Sockets* m_sockets;
+    DS_Config* m_config;
     Protocol* m_protocol;
     NetConsole* m_console;
 
@@ -212,8 +312,41 @@ class DriverStation : public DS_Base {
     Watchdog* m_radioWatchdog;
     Watchdog* m_robotWatchdog;
 
+    Metrics m_metrics;
+    StateSnapshot m_state;
+    EventBus::Subscription m_configEvents;
+    MetricsServer* m_metricsServer;
+    TelemetryExport* m_telemetry;
+    ControlServer* m_controlServer;
+
+    static const int ROUND_TRIP_SLOTS = 64;
+    int m_roundTripSequence [ROUND_TRIP_SLOTS];
+    qint64 m_roundTripSendTime [ROUND_TRIP_SLOTS];
+
+    ControlMode m_lastControlMode;
+    EnableStatus m_lastEnableStatus;
+    OperationStatus m_lastOperationStatus;
+
+    LoopMonitor m_loopMonitor;
+    Histogram m_inputLatency [JoystickStore::MAX_JOYSTICKS];
+
+#if defined LIB_DS_STATIC_PROTOCOL
+    typedef StaticProtocol HostProtocol;
+#else
+    typedef Protocol HostProtocol;
+#endif
+
     DS_Config* config() const;
-    Protocol* protocol() const;
+    HostProtocol* protocol() const;
+    int effectiveRobotPacketLeadTime() const;
+    void recordInputLatency();
+    void recordRoundTrip (const QByteArray& data);
+    void robotPacketSent();
+    void publishState();
+    void publishTelemetry();
+    void scheduleUrgentBurst();
+    void detach();
+    void transmit (int target, const QByteArray& data, bool now = false);
 };
 
 #endif
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Engine.h"
+
+#include <QThread>
+
+/**
+ * Creates a detached DS engine that lives (and logs) in the calling thread
+ */
+Engine::Engine (QObject* parent) : QObject (parent) {
+    DS_Config* config = new DS_Config ("Engine", QThread::currentThread(), true);
+
+    m_driverStation = new DriverStation (config);
+    m_driverStation->detach();
+
+    m_state = currentState();
+}
+
+/**
+ * Deletes the DS of the engine
+ */
+Engine::~Engine() {
+    delete m_driverStation;
+}
+
+/**
+ * Returns the \c DriverStation of the engine, which is used to change the
+ * team number, protocol, robot state, joysticks, etc.
+ *
+ * \note The slots of the \c DriverStation that depend on the sockets of the
+ *       DS (e.g. the socket profile or the metrics server) have no effect
+ */
+DriverStation* Engine::driverStation() const {
+    return m_driverStation;
+}
+
+/**
+ * Returns the number of generated packets that are waiting to be sent
+ */
+int Engine::pendingPackets() const {
+    return m_driverStation->m_outbox.count();
+}
+
+/**
+ * Removes the oldest generated packet from the queue, and writes its data and
+ * \a target to the given pointers.
+ *
+ * Returns \c false if there are no packets left to send.
+ */
+bool Engine::takePacket (int* target, QByteArray* data) {
+    if (m_driverStation->m_outbox.isEmpty())
+        return false;
+
+    QPair<int, QByteArray> packet = m_driverStation->m_outbox.takeFirst();
+    if (target)
+        *target = packet.first;
+    if (data)
+        *data = packet.second;
+
+    return true;
+}
+
+/**
+ * Runs every DS operation that is due at the given \a msecs time (as given
+ * by a monotonic clock). This includes generating the FMS, radio and robot
+ * packets, checking the watchdogs and updating the packet loss.
+ *
+ * Returns the state changes (see \c Change) since the last step, which
+ * includes the changes caused by the packets fed with \c receive().
+ */
+int Engine::step (qint64 msecs) {
+    m_driverStation->init();
+    m_driverStation->processTick (msecs);
+
+    State state = currentState();
+    int changes = 0;
+
+    if (state.fmsComms != m_state.fmsComms)
+        changes |= kFMSCommsChanged;
+    if (state.radioComms != m_state.radioComms)
+        changes |= kRadioCommsChanged;
+    if (state.robotComms != m_state.robotComms)
+        changes |= kRobotCommsChanged;
+    if (state.codeStatus != m_state.codeStatus)
+        changes |= kCodeStatusChanged;
+    if (state.enableStatus != m_state.enableStatus)
+        changes |= kEnabledChanged;
+    if (state.controlMode != m_state.controlMode)
+        changes |= kControlModeChanged;
+    if (state.operationStatus != m_state.operationStatus)
+        changes |= kOperationStatusChanged;
+    if (state.voltageStatus != m_state.voltageStatus)
+        changes |= kVoltageStatusChanged;
+    if (state.alliance != m_state.alliance)
+        changes |= kAllianceChanged;
+    if (state.position != m_state.position)
+        changes |= kPositionChanged;
+    if (!qFuzzyCompare (1 + state.voltage, 1 + m_state.voltage))
+        changes |= kVoltageChanged;
+
+    m_state = state;
+    return changes;
+}
+
+/**
+ * Lets the DS interpret the given \a data, which was received from the given
+ * \a target
+ */
+void Engine::receive (int target, const QByteArray& data) {
+    if (target == kFMS)
+        m_driverStation->readFMSPacket (data);
+    else if (target == kRadio)
+        m_driverStation->readRadioPacket (data);
+    else if (target == kRobot)
+        m_driverStation->readRobotPacket (data);
+}
+
+/**
+ * Returns the values of the DS state that are reported by \c step()
+ */
+Engine::State Engine::currentState() const {
+    State state;
+    state.fmsComms = m_driverStation->fmsCommStatus();
+    state.radioComms = m_driverStation->radioCommStatus();
+    state.robotComms = m_driverStation->robotCommStatus();
+    state.codeStatus = m_driverStation->robotCodeStatus();
+    state.enableStatus = m_driverStation->enableStatus();
+    state.controlMode = m_driverStation->controlMode();
+    state.operationStatus = m_driverStation->operationStatus();
+    state.voltageStatus = m_driverStation->voltageStatus();
+    state.alliance = m_driverStation->alliance();
+    state.position = m_driverStation->position();
+    state.voltage = m_driverStation->currentBatteryVoltage();
+    return state;
+}
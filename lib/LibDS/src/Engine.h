@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_ENGINE_H
+#define _LIB_DS_ENGINE_H
+
+#include <DriverStation.h>
+
+/**
+ * \brief Runs a DS engine from the control loop of the application
+ *
+ * The engine is a \c DriverStation that does not own any timer, socket or
+ * thread. Instead, the application periodically hands the current time of
+ * its monotonic clock to \c step(), feeds the datagrams that it receives from
+ * the FMS, radio and robot with \c receive() and sends the packets returned
+ * by \c takePacket() by its own means:
+ *
+ * \code
+ * Engine engine;
+ * engine.driverStation()->setTeam (3794);
+ * engine.driverStation()->setProtocolType (DriverStation::kFRC2016);
+ *
+ * forever {
+ *     while (socket.hasPendingDatagrams())
+ *         engine.receive (Engine::kRobot, readDatagram (&socket));
+ *
+ *     int changes = engine.step (monotonicMsecs());
+ *
+ *     int target;
+ *     QByteArray packet;
+ *     while (engine.takePacket (&target, &packet))
+ *         socket.writeDatagram (packet, address (target), port (target));
+ * }
+ * \endcode
+ *
+ * The engine does not need a Qt event loop, since every operation of the DS
+ * is executed from the calls to \c step() and \c receive().
+ */
+class Engine : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit Engine (QObject* parent = Q_NULLPTR);
+    ~Engine();
+
+    enum Target {
+        kFMS   = Metrics::kFMS,
+        kRadio = Metrics::kRadio,
+        kRobot = Metrics::kRobot,
+    };
+
+    enum Change {
+        kFMSCommsChanged        = 1 << 0,
+        kRadioCommsChanged      = 1 << 1,
+        kRobotCommsChanged      = 1 << 2,
+        kCodeStatusChanged      = 1 << 3,
+        kEnabledChanged         = 1 << 4,
+        kControlModeChanged     = 1 << 5,
+        kOperationStatusChanged = 1 << 6,
+        kVoltageStatusChanged   = 1 << 7,
+        kVoltageChanged         = 1 << 8,
+        kAllianceChanged        = 1 << 9,
+        kPositionChanged        = 1 << 10,
+    };
+
+    DriverStation* driverStation() const;
+
+    int pendingPackets() const;
+    bool takePacket (int* target, QByteArray* data);
+
+    int step (qint64 msecs);
+    void receive (int target, const QByteArray& data);
+
+  private:
+    struct State {
+        int fmsComms;
+        int radioComms;
+        int robotComms;
+        int codeStatus;
+        int enableStatus;
+        int controlMode;
+        int operationStatus;
+        int voltageStatus;
+        int alliance;
+        int position;
+        qreal voltage;
+    };
+
+    State currentState() const;
+
+  private:
+    State m_state;
+    DriverStation* m_driverStation;
+};
+
+#endif
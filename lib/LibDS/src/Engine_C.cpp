@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include <string.h>
+
+#include "Engine.h"
+#include "Engine_C.h"
+
+/**
+ * Holds the engine and the packet that did not fit in the buffer given to
+ * the last call of \c ds_engine_poll()
+ */
+struct ds_engine {
+    Engine engine;
+    int pendingTarget;
+    bool hasPending;
+    QByteArray pending;
+};
+
+/**
+ * Creates a new engine with the given \a protocol and \a team number
+ */
+ds_engine* ds_engine_create (int protocol, int team) {
+    ds_engine* engine = new ds_engine;
+    engine->hasPending = false;
+    engine->pendingTarget = DS_TARGET_ROBOT;
+
+    DriverStation* ds = engine->engine.driverStation();
+    ds->setTeam (team);
+    ds->setProtocolType (protocol);
+
+    return engine;
+}
+
+/**
+ * Destroys the given \a engine
+ */
+void ds_engine_destroy (ds_engine* engine) {
+    delete engine;
+}
+
+/**
+ * Runs the operations that are due at the given \a msecs time (of a
+ * monotonic clock) and returns the \c DS_CHANGED_* flags of the state values
+ * that changed since the last step
+ */
+int ds_engine_step (ds_engine* engine, int64_t msecs) {
+    return engine ? engine->engine.step (msecs) : 0;
+}
+
+/**
+ * Feeds a datagram received from the given \a target to the engine
+ */
+void ds_engine_receive (ds_engine* engine, int target,
+                        const uint8_t* data, size_t length) {
+    if (engine && data)
+        engine->engine.receive (target,
+                                QByteArray::fromRawData (
+                                    reinterpret_cast<const char*> (data),
+                                    static_cast<int> (length)));
+}
+
+/**
+ * Copies the next packet to send into the given \a buffer and writes its
+ * destination to \a target.
+ *
+ * Returns the length of the packet, 0 if there are no packets to send, or
+ * the negated length of the packet if it does not fit in the \a capacity of
+ * the buffer (in which case the packet is kept for the next call).
+ */
+int ds_engine_poll (ds_engine* engine, int* target,
+                    uint8_t* buffer, size_t capacity) {
+    if (!engine)
+        return 0;
+
+    if (!engine->hasPending) {
+        if (!engine->engine.takePacket (&engine->pendingTarget,
+                                        &engine->pending))
+            return 0;
+
+        engine->hasPending = true;
+    }
+
+    int length = engine->pending.size();
+    if (!buffer || static_cast<size_t> (length) > capacity)
+        return -length;
+
+    memcpy (buffer, engine->pending.constData(), length);
+    if (target)
+        *target = engine->pendingTarget;
+
+    engine->hasPending = false;
+    return length;
+}
+
+/**
+ * Changes the team number of the \a engine
+ */
+void ds_engine_set_team (ds_engine* engine, int team) {
+    if (engine)
+        engine->engine.driverStation()->setTeam (team);
+}
+
+/**
+ * Enables or disables the robot
+ */
+void ds_engine_set_enabled (ds_engine* engine, int enabled) {
+    if (engine)
+        engine->engine.driverStation()->setEnabled (enabled != 0);
+}
+
+/**
+ * Changes the control \a mode of the robot (see \c DS_MODE_*)
+ */
+void ds_engine_set_control_mode (ds_engine* engine, int mode) {
+    if (engine)
+        engine->engine.driverStation()->setControlMode ((DS::ControlMode) mode);
+}
+
+/**
+ * Changes the team \a station (see \c DriverStation::TeamStation)
+ */
+void ds_engine_set_team_station (ds_engine* engine, int station) {
+    if (engine)
+        engine->engine.driverStation()->setTeamStation (station);
+}
+
+/**
+ * Emergency stops the robot
+ */
+void ds_engine_emergency_stop (ds_engine* engine) {
+    if (engine)
+        engine->engine.driverStation()->triggerEmergencyStop();
+}
+
+/**
+ * Registers a new joystick and returns its index, or -1 on failure
+ */
+int ds_engine_add_joystick (ds_engine* engine, int axes, int buttons, int povs) {
+    if (!engine)
+        return -1;
+
+    DriverStation* ds = engine->engine.driverStation();
+    if (!ds->registerJoystick (axes, buttons, povs))
+        return -1;
+
+    return ds->joystickCount() - 1;
+}
+
+/**
+ * Changes the \a value of the given \a axis of the given \a joystick
+ */
+void ds_engine_set_axis (ds_engine* engine, int joystick, int axis,
+                         double value) {
+    if (engine)
+        engine->engine.driverStation()->updateAxis (joystick, axis, value);
+}
+
+/**
+ * Changes the state of the given \a button of the given \a joystick
+ */
+void ds_engine_set_button (ds_engine* engine, int joystick, int button,
+                           int pressed) {
+    if (engine)
+        engine->engine.driverStation()->updateButton (joystick, button,
+                                                      pressed != 0);
+}
+
+/**
+ * Changes the \a angle of the given \a pov of the given \a joystick
+ */
+void ds_engine_set_pov (ds_engine* engine, int joystick, int pov, int angle) {
+    if (engine)
+        engine->engine.driverStation()->updatePOV (joystick, pov, angle);
+}
+
+/**
+ * Returns 1 if the engine is communicating with the robot
+ */
+int ds_engine_robot_connected (const ds_engine* engine) {
+    return engine && engine->engine.driverStation()->isConnectedToRobot();
+}
+
+/**
+ * Returns 1 if the robot code is running
+ */
+int ds_engine_robot_code (const ds_engine* engine) {
+    return engine && engine->engine.driverStation()->isRobotCodeRunning();
+}
+
+/**
+ * Returns 1 if the robot is enabled
+ */
+int ds_engine_enabled (const ds_engine* engine) {
+    return engine && engine->engine.driverStation()->isEnabled();
+}
+
+/**
+ * Returns 1 if the robot is emergency stopped
+ */
+int ds_engine_emergency_stopped (const ds_engine* engine) {
+    return engine && engine->engine.driverStation()->isEmergencyStopped();
+}
+
+/**
+ * Returns the voltage of the robot battery
+ */
+double ds_engine_voltage (const ds_engine* engine) {
+    return engine ? engine->engine.driverStation()->currentBatteryVoltage() : 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_ENGINE_C_H
+#define _LIB_DS_ENGINE_C_H
+
+/*
+ * C interface of the tick-driven DS engine (see the \c Engine class).
+ *
+ * The engine does not own any timer, socket or thread. The application calls
+ * ds_engine_step() from its own control loop, feeds the received datagrams
+ * with ds_engine_receive() and sends the packets returned by
+ * ds_engine_poll(). Packets are copied into buffers owned by the caller.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ds_engine ds_engine;
+
+/* Packet targets */
+#define DS_TARGET_FMS   0
+#define DS_TARGET_RADIO 1
+#define DS_TARGET_ROBOT 2
+
+/* Protocols */
+#define DS_PROTOCOL_2016 0
+#define DS_PROTOCOL_2015 1
+#define DS_PROTOCOL_2014 2
+
+/* Control modes */
+#define DS_MODE_TEST          0
+#define DS_MODE_AUTONOMOUS    1
+#define DS_MODE_TELEOPERATED  2
+
+/* State change flags returned by ds_engine_step() */
+#define DS_CHANGED_FMS_COMMS        (1 << 0)
+#define DS_CHANGED_RADIO_COMMS      (1 << 1)
+#define DS_CHANGED_ROBOT_COMMS      (1 << 2)
+#define DS_CHANGED_CODE_STATUS      (1 << 3)
+#define DS_CHANGED_ENABLED          (1 << 4)
+#define DS_CHANGED_CONTROL_MODE     (1 << 5)
+#define DS_CHANGED_OPERATION_STATUS (1 << 6)
+#define DS_CHANGED_VOLTAGE_STATUS   (1 << 7)
+#define DS_CHANGED_VOLTAGE          (1 << 8)
+#define DS_CHANGED_ALLIANCE         (1 << 9)
+#define DS_CHANGED_POSITION         (1 << 10)
+
+ds_engine* ds_engine_create (int protocol, int team);
+void ds_engine_destroy (ds_engine* engine);
+
+int ds_engine_step (ds_engine* engine, int64_t msecs);
+void ds_engine_receive (ds_engine* engine, int target,
+                        const uint8_t* data, size_t length);
+int ds_engine_poll (ds_engine* engine, int* target,
+                    uint8_t* buffer, size_t capacity);
+
+void ds_engine_set_team (ds_engine* engine, int team);
+void ds_engine_set_enabled (ds_engine* engine, int enabled);
+void ds_engine_set_control_mode (ds_engine* engine, int mode);
+void ds_engine_set_team_station (ds_engine* engine, int station);
+void ds_engine_emergency_stop (ds_engine* engine);
+
+int ds_engine_add_joystick (ds_engine* engine, int axes, int buttons, int povs);
+void ds_engine_set_axis (ds_engine* engine, int joystick, int axis, double value);
+void ds_engine_set_button (ds_engine* engine, int joystick, int button, int pressed);
+void ds_engine_set_pov (ds_engine* engine, int joystick, int pov, int angle);
+
+int ds_engine_robot_connected (const ds_engine* engine);
+int ds_engine_robot_code (const ds_engine* engine);
+int ds_engine_enabled (const ds_engine* engine);
+int ds_engine_emergency_stopped (const ds_engine* engine);
+double ds_engine_voltage (const ds_engine* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
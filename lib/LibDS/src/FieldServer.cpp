@@ -0,0 +1,523 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "FieldServer.h"
+
+#include <QDateTime>
+#include <Core/DS_Common.h>
+
+/* Size of the packets sent to the driver stations */
+const int FMS_PACKET_SIZE = 22;
+
+/* Minimum size of the packets sent by the driver stations */
+const int DS_PACKET_SIZE = 8;
+
+/* Time without DS packets after which a station is considered disconnected */
+const int STATION_TIMEOUT = 2000;
+
+/* A tick sent more than this late (in nanoseconds) is counted as late */
+const qint64 LATE_TICK_THRESHOLD = 1000000;
+
+/**
+ * Control flags sent to the driver stations
+ */
+enum FMS_Control {
+    cTest          = 0x01,
+    cAutonomous    = 0x02,
+    cEnabled       = 0x04,
+    cTeleoperated  = 0x00,
+    cEmergencyStop = 0x80,
+};
+
+/**
+ * Tournament level reported to the driver stations
+ */
+enum FMS_Level {
+    cLevelPractice = 0x01,
+};
+
+FieldServer::FieldServer (QObject* parent) : QObject (parent), m_timer (this) {
+    m_frequency = 2;
+    m_matchNumber = 1;
+    m_remainingTime = 0;
+    m_outputPort = 1120;
+    m_matchPhase = kPreMatch;
+
+    m_phaseDurations [kPreMatch] = 0;
+    m_phaseDurations [kAutonomous] = 15;
+    m_phaseDurations [kPause] = 1;
+    m_phaseDurations [kTeleoperated] = 135;
+    m_phaseDurations [kPostMatch] = 0;
+
+    m_period = 1000000000 / m_frequency;
+    m_spinTime = 1000000;
+    m_deadline = 0;
+    m_matchStart = 0;
+
+    for (int i = 0; i < STATION_COUNT; ++i) {
+        m_stations [i].team = 0;
+        m_stations [i].bypassed = false;
+        m_stations [i].estopped = false;
+        m_stations [i].address = QHostAddress();
+    }
+
+    resetStatistics();
+
+    m_timer.setSingleShot (true);
+    m_timer.setTimerType (Qt::PreciseTimer);
+
+    connect (&m_timer,  SIGNAL (timeout()),   this, SLOT (onTimeout()));
+    connect (&m_socket, SIGNAL (readyRead()), this, SLOT (readPackets()));
+}
+
+/**
+ * Returns the number of packets sent to each station per second
+ */
+int FieldServer::frequency() const {
+    return m_frequency;
+}
+
+/**
+ * Returns the match number reported to the driver stations
+ */
+int FieldServer::matchNumber() const {
+    return m_matchNumber;
+}
+
+/**
+ * Returns the remaining time (in seconds) of the current match phase
+ */
+int FieldServer::remainingTime() const {
+    return m_remainingTime;
+}
+
+/**
+ * Returns the current phase of the match
+ */
+FieldServer::MatchPhase FieldServer::matchPhase() const {
+    return m_matchPhase;
+}
+
+/**
+ * Returns the configuration and statistics of the given \a station (0 to 5,
+ * being 0 Red 1 and 5 Blue 3)
+ */
+FieldServer::StationStatus FieldServer::stationStatus (int station) const {
+    return m_stations [qBound (0, station, STATION_COUNT - 1)];
+}
+
+/**
+ * Returns the average delay (in microseconds) between the scheduled time of
+ * each tick and the time in which the packets were actually sent
+ */
+qreal FieldServer::meanSkew() const {
+    if (m_ticks > 0)
+        return (m_totalSkew / m_ticks) / 1000;
+
+    return 0;
+}
+
+/**
+ * Returns the maximum scheduling skew (in microseconds)
+ */
+qint64 FieldServer::maxSkew() const {
+    return m_maxSkew / 1000;
+}
+
+/**
+ * Returns the number of ticks that were sent more than a millisecond late
+ */
+quint64 FieldServer::lateTicks() const {
+    return m_lateTicks;
+}
+
+/**
+ * Stops sending packets to the driver stations
+ */
+void FieldServer::stop() {
+    m_timer.stop();
+    m_socket.close();
+}
+
+/**
+ * Begins listening for DS packets at the given \a inputPort and sending FMS
+ * packets to the driver stations at the given \a outputPort.
+ *
+ * Returns \c false if the input port cannot be bound.
+ */
+bool FieldServer::start (quint16 inputPort, quint16 outputPort) {
+    stop();
+
+    m_outputPort = outputPort;
+    if (!m_socket.bind (QHostAddress::AnyIPv4, inputPort, DS_BIND_MODE)) {
+        qWarning() << "Field server cannot bind to port" << inputPort;
+        return false;
+    }
+
+    m_clock.start();
+    m_deadline = m_clock.nsecsElapsed();
+    scheduleNext();
+
+    qDebug() << "Field server started at" << m_frequency << "Hz";
+    return true;
+}
+
+/**
+ * Starts the match timeline, beginning with the autonomous period
+ */
+void FieldServer::startMatch() {
+    m_matchStart = m_clock.elapsed();
+    m_matchPhase = kAutonomous;
+    m_remainingTime = m_phaseDurations [kAutonomous];
+
+    emit matchPhaseChanged (m_matchPhase);
+    emit remainingTimeChanged (m_remainingTime);
+
+    qDebug() << "Match" << m_matchNumber << "started";
+}
+
+/**
+ * Disables all the robots and ends the current match
+ */
+void FieldServer::abortMatch() {
+    if (m_matchPhase != kPreMatch && m_matchPhase != kPostMatch) {
+        m_matchPhase = kPostMatch;
+        m_remainingTime = 0;
+
+        emit matchPhaseChanged (m_matchPhase);
+        emit remainingTimeChanged (m_remainingTime);
+
+        qDebug() << "Match" << m_matchNumber << "aborted";
+    }
+}
+
+/**
+ * Clears the scheduling statistics and the statistics of every station
+ */
+void FieldServer::resetStatistics() {
+    m_ticks = 0;
+    m_lateTicks = 0;
+    m_maxSkew = 0;
+    m_totalSkew = 0;
+
+    for (int i = 0; i < STATION_COUNT; ++i) {
+        m_stations [i].connected = false;
+        m_stations [i].control = 0;
+        m_stations [i].voltage = 0;
+        m_stations [i].sent = 0;
+        m_stations [i].received = 0;
+        m_stations [i].lost = 0;
+        m_stations [i].lastSequence = -1;
+        m_stations [i].lastArrival = -1;
+        m_stations [i].maxInterArrival = 0;
+        m_stations [i].meanInterArrival = 0;
+    }
+}
+
+/**
+ * Changes the number of packets sent to each station per second
+ */
+void FieldServer::setFrequency (int hz) {
+    m_frequency = qBound (1, hz, 50);
+    m_period = 1000000000 / m_frequency;
+}
+
+/**
+ * Changes the time (in microseconds) that the timer waits actively before
+ * each deadline. Larger values reduce the skew at the cost of CPU time, a
+ * value of \c 0 disables active waiting.
+ */
+void FieldServer::setSpinTime (int usecs) {
+    m_spinTime = static_cast<qint64> (qMax (usecs, 0)) * 1000;
+}
+
+/**
+ * Changes the match number reported to the driver stations
+ */
+void FieldServer::setMatchNumber (int match) {
+    m_matchNumber = match;
+}
+
+/**
+ * Changes the duration (in \a seconds) of the given match \a phase.
+ * \note The pre-match and post-match phases last until the next match
+ */
+void FieldServer::setPhaseDuration (MatchPhase phase, int seconds) {
+    if (phase == kAutonomous || phase == kPause || phase == kTeleoperated)
+        m_phaseDurations [phase] = qMax (seconds, 0);
+}
+
+/**
+ * If \a bypassed is set to \c true, the robot of the given \a station will
+ * not be enabled during the match
+ */
+void FieldServer::setBypassed (int station, bool bypassed) {
+    if (station >= 0 && station < STATION_COUNT)
+        m_stations [station].bypassed = bypassed;
+}
+
+/**
+ * Changes the emergency stop state of the given \a station
+ */
+void FieldServer::setEmergencyStop (int station, bool estop) {
+    if (station >= 0 && station < STATION_COUNT)
+        m_stations [station].estopped = estop;
+}
+
+/**
+ * Assigns the given \a team and DS \a address to the given \a station.
+ * If the address is null, it will be learned from the first packet sent by
+ * the DS of the team, however, no packets are sent to the station until then.
+ */
+void FieldServer::setStation (int station,
+                              int team,
+                              const QHostAddress& address) {
+    if (station >= 0 && station < STATION_COUNT) {
+        m_stations [station].team = team;
+        m_stations [station].address = address;
+    }
+}
+
+/**
+ * Waits for the exact deadline, records the scheduling skew and sends the
+ * packets of the current tick
+ */
+void FieldServer::onTimeout() {
+    while (m_clock.nsecsElapsed() < m_deadline);
+
+    qint64 skew = m_clock.nsecsElapsed() - m_deadline;
+
+    ++m_ticks;
+    m_totalSkew += skew;
+    m_maxSkew = qMax (m_maxSkew, skew);
+
+    if (skew > LATE_TICK_THRESHOLD)
+        ++m_lateTicks;
+
+    updateTimeline();
+    sendPackets();
+    scheduleNext();
+}
+
+/**
+ * Reads the status packets sent by the driver stations and updates the
+ * statistics of each station
+ */
+void FieldServer::readPackets() {
+    while (m_socket.hasPendingDatagrams()) {
+        QByteArray data;
+        QHostAddress address;
+
+        data.resize (qMax (m_socket.pendingDatagramSize(), qint64 (0)));
+        m_socket.readDatagram (data.data(), data.size(), &address);
+
+        if (data.size() < DS_PACKET_SIZE)
+            continue;
+
+        /* Find the station of the DS */
+        int team = ((DS_UByte) data.at (4) << 8) | (DS_UByte) data.at (5);
+        int id = findStation (team, address);
+        if (id < 0)
+            continue;
+
+        StationStatus& station = m_stations [id];
+        qint64 now = m_clock.elapsed();
+
+        /* Learn the address of the DS */
+        if (station.address.isNull())
+            station.address = address;
+
+        /* Count the packets that were lost */
+        int sequence = ((DS_UByte) data.at (0) << 8) | (DS_UByte) data.at (1);
+        if (station.lastSequence >= 0) {
+            int diff = (sequence - station.lastSequence) & 0xFFFF;
+            if (diff > 1 && diff < 0x8000)
+                station.lost += diff - 1;
+        }
+
+        /* Update inter-arrival times */
+        if (station.lastArrival >= 0) {
+            qint64 interval = now - station.lastArrival;
+            station.maxInterArrival = qMax (station.maxInterArrival, interval);
+            station.meanInterArrival += (interval - station.meanInterArrival)
+                                        / station.received;
+        }
+
+        /* Update station status */
+        ++station.received;
+        station.connected = true;
+        station.lastArrival = now;
+        station.lastSequence = sequence;
+        station.control = data.at (3);
+        station.voltage = (DS_UByte) data.at (6)
+                          + static_cast<qreal> ((DS_UByte) data.at (7)) / 100;
+
+        emit stationStatusChanged (id);
+    }
+}
+
+/**
+ * Schedules the next tick on an absolute deadline, so that the timer error
+ * does not accumulate over time
+ */
+void FieldServer::scheduleNext() {
+    qint64 now = m_clock.nsecsElapsed();
+    m_deadline += m_period;
+
+    /* We fell behind, do not try to catch up with a burst of packets */
+    if (m_deadline < now)
+        m_deadline = now;
+
+    qint64 wait = (m_deadline - now - m_spinTime) / 1000000;
+    m_timer.start (static_cast<int> (qMax (wait, qint64 (0))));
+}
+
+/**
+ * Sends a packet to each station with a known address and marks the stations
+ * that stopped talking to us as disconnected
+ */
+void FieldServer::sendPackets() {
+    qint64 now = m_clock.elapsed();
+
+    for (int i = 0; i < STATION_COUNT; ++i) {
+        StationStatus& station = m_stations [i];
+
+        if (station.connected && now - station.lastArrival > STATION_TIMEOUT) {
+            station.connected = false;
+            emit stationStatusChanged (i);
+        }
+
+        if (station.address.isNull())
+            continue;
+
+        QByteArray data = generatePacket (i);
+        if (m_socket.writeDatagram (data, station.address, m_outputPort) > 0)
+            ++station.sent;
+    }
+}
+
+/**
+ * Updates the match phase and remaining time based on the time elapsed since
+ * the match was started
+ */
+void FieldServer::updateTimeline() {
+    if (m_matchPhase == kPreMatch || m_matchPhase == kPostMatch)
+        return;
+
+    qint64 elapsed = m_clock.elapsed() - m_matchStart;
+    qint64 autoEnd = m_phaseDurations [kAutonomous] * 1000;
+    qint64 pauseEnd = autoEnd + m_phaseDurations [kPause] * 1000;
+    qint64 teleopEnd = pauseEnd + m_phaseDurations [kTeleoperated] * 1000;
+
+    /* Get current phase and the time in which it ends */
+    qint64 phaseEnd = 0;
+    MatchPhase phase = kPostMatch;
+    if (elapsed < autoEnd) {
+        phase = kAutonomous;
+        phaseEnd = autoEnd;
+    }
+
+    else if (elapsed < pauseEnd) {
+        phase = kPause;
+        phaseEnd = pauseEnd;
+    }
+
+    else if (elapsed < teleopEnd) {
+        phase = kTeleoperated;
+        phaseEnd = teleopEnd;
+    }
+
+    /* Update remaining time (rounded up) */
+    int remaining = 0;
+    if (phase != kPostMatch)
+        remaining = static_cast<int> ((phaseEnd - elapsed + 999) / 1000);
+
+    if (m_matchPhase != phase) {
+        m_matchPhase = phase;
+        emit matchPhaseChanged (phase);
+        qDebug() << "Match phase set to" << phase;
+    }
+
+    if (m_remainingTime != remaining) {
+        m_remainingTime = remaining;
+        emit remainingTimeChanged (remaining);
+    }
+}
+
+/**
+ * Returns the index of the station assigned to the given \a team. If no
+ * station is assigned to the team, the station with the given \a address is
+ * returned instead (or \c -1 if none matches).
+ */
+int FieldServer::findStation (int team, const QHostAddress& address) const {
+    for (int i = 0; i < STATION_COUNT; ++i) {
+        if (m_stations [i].team == team && team > 0)
+            return i;
+    }
+
+    for (int i = 0; i < STATION_COUNT; ++i) {
+        if (!address.isNull() && m_stations [i].address == address)
+            return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Generates the FMS packet sent to the given \a station, which contains the
+ * control flags, team station, match information, date and remaining time
+ */
+QByteArray FieldServer::generatePacket (int station) {
+    QByteArray data;
+    const StationStatus& status = m_stations [station];
+
+    /* Get the control mode */
+    DS_UByte control = cTeleoperated;
+    if (m_matchPhase == kPreMatch || m_matchPhase == kAutonomous)
+        control = cAutonomous;
+
+    /* Enable the robot during the match */
+    bool matchRunning = (m_matchPhase == kAutonomous
+                         || m_matchPhase == kTeleoperated);
+    if (matchRunning && !status.bypassed && !status.estopped)
+        control |= cEnabled;
+
+    /* Stop the robot */
+    if (status.estopped)
+        control |= cEmergencyStop;
+
+    /* Get date and time */
+    QDateTime dt = QDateTime::currentDateTime();
+    quint32 usecs = dt.time().msec() * 1000;
+
+    data.append ((status.sent & 0xff00) >> 8);
+    data.append ((status.sent & 0xff));
+    data.append (static_cast<char> (0x00));
+    data.append (control);
+    data.append (static_cast<char> (0x00));
+    data.append (station);
+    data.append (cLevelPractice);
+    data.append ((m_matchNumber & 0xff00) >> 8);
+    data.append ((m_matchNumber & 0xff));
+    data.append (0x01);
+    data.append ((usecs & 0xff000000) >> 24);
+    data.append ((usecs & 0xff0000) >> 16);
+    data.append ((usecs & 0xff00) >> 8);
+    data.append ((usecs & 0xff));
+    data.append (dt.time().second());
+    data.append (dt.time().minute());
+    data.append (dt.time().hour());
+    data.append (dt.date().day());
+    data.append (dt.date().month() - 1);
+    data.append (dt.date().year() - 1900);
+    data.append ((m_remainingTime & 0xff00) >> 8);
+    data.append ((m_remainingTime & 0xff));
+
+    Q_ASSERT (data.size() == FMS_PACKET_SIZE);
+    return data;
+}
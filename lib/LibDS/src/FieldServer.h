@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_FIELD_SERVER_H
+#define _LIB_DS_FIELD_SERVER_H
+
+#include <QTimer>
+#include <QUdpSocket>
+#include <QElapsedTimer>
+#include <QHostAddress>
+
+/**
+ * \brief Acts as the FMS (Field Management System) for six driver stations
+ *
+ * The field server speaks the FMS side of the FRC 2015/2016 protocol: it
+ * sends the control and team station bytes to each driver station and
+ * reads the status packets that each DS sends back to the FMS.
+ *
+ * A match timeline (pre-match, autonomous, pause, teleoperated and
+ * post-match) is run from the same event loop that sends the packets. The
+ * packets are sent on absolute deadlines, the timer wakes up slightly before
+ * each deadline and waits for the exact time, keeping the scheduling skew
+ * under a millisecond. The skew and the per-station loss and inter-arrival
+ * times are aggregated so that they can be reported to the user.
+ *
+ * \note The driver stations must use the address of the field server as
+ *       their custom FMS address
+ */
+class FieldServer : public QObject {
+    Q_OBJECT
+    Q_ENUMS (MatchPhase)
+
+  public:
+    enum MatchPhase {
+        kPreMatch = 0,
+        kAutonomous = 1,
+        kPause = 2,
+        kTeleoperated = 3,
+        kPostMatch = 4,
+    };
+
+    struct StationStatus {
+        int team;
+        bool bypassed;
+        bool estopped;
+        bool connected;
+        QHostAddress address;
+
+        quint8 control;
+        qreal voltage;
+
+        quint64 sent;
+        quint64 received;
+        quint64 lost;
+
+        int lastSequence;
+        qint64 lastArrival;
+        qint64 maxInterArrival;
+        qreal meanInterArrival;
+    };
+
+  signals:
+    void remainingTimeChanged (int seconds);
+    void stationStatusChanged (int station);
+    void matchPhaseChanged (FieldServer::MatchPhase phase);
+
+  public:
+    explicit FieldServer (QObject* parent = Q_NULLPTR);
+
+    static const int STATION_COUNT = 6;
+
+    int frequency() const;
+    int matchNumber() const;
+    int remainingTime() const;
+    MatchPhase matchPhase() const;
+    StationStatus stationStatus (int station) const;
+
+    qreal meanSkew() const;
+    qint64 maxSkew() const;
+    quint64 lateTicks() const;
+
+  public slots:
+    void stop();
+    bool start (quint16 inputPort = 1160, quint16 outputPort = 1120);
+
+    void startMatch();
+    void abortMatch();
+    void resetStatistics();
+    void setFrequency (int hz);
+    void setSpinTime (int usecs);
+    void setMatchNumber (int match);
+    void setPhaseDuration (MatchPhase phase, int seconds);
+    void setBypassed (int station, bool bypassed);
+    void setEmergencyStop (int station, bool estop);
+    void setStation (int station, int team, const QHostAddress& address);
+
+  private slots:
+    void onTimeout();
+    void readPackets();
+
+  private:
+    void scheduleNext();
+    void sendPackets();
+    void updateTimeline();
+    int findStation (int team, const QHostAddress& address) const;
+    QByteArray generatePacket (int station);
+
+  private:
+    int m_frequency;
+    int m_matchNumber;
+    int m_remainingTime;
+    int m_phaseDurations [kPostMatch + 1];
+    quint16 m_outputPort;
+    MatchPhase m_matchPhase;
+
+    qint64 m_period;
+    qint64 m_spinTime;
+    qint64 m_deadline;
+    qint64 m_matchStart;
+
+    quint64 m_ticks;
+    quint64 m_lateTicks;
+    qint64 m_maxSkew;
+    qreal m_totalSkew;
+
+    QTimer m_timer;
+    QUdpSocket m_socket;
+    QElapsedTimer m_clock;
+    StationStatus m_stations [STATION_COUNT];
+};
+
+Q_DECLARE_METATYPE (FieldServer::MatchPhase)
+
+#endif
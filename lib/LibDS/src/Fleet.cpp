@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Fleet.h"
+
+#include <Core/FleetScheduler.h>
+
+/* Default interval of the shared tick (in milliseconds) */
+const int DEFAULT_TICK_INTERVAL = 2;
+
+Fleet::Fleet (QObject* parent) : QObject (parent) {
+    qRegisterMetaType<QThread*> ("QThread*");
+    qRegisterMetaType<DriverStation*> ("DriverStation*");
+
+    /* Start the shared threads */
+    m_loggerThread.start (QThread::LowPriority);
+    m_networkThread.start (QThread::TimeCriticalPriority);
+
+    /* Move the scheduler to the network thread */
+    m_scheduler = new FleetScheduler;
+    m_scheduler->moveToThread (&m_networkThread);
+
+    /* Start the shared tick */
+    m_tickInterval = 0;
+    setTickInterval (DEFAULT_TICK_INTERVAL);
+}
+
+/**
+ * Destroys all the engines and stops the network and logger threads
+ */
+Fleet::~Fleet() {
+    QMetaObject::invokeMethod (m_scheduler,
+                               "destroyAllEngines",
+                               Qt::BlockingQueuedConnection);
+    m_scheduler->deleteLater();
+
+    m_networkThread.quit();
+    m_networkThread.wait();
+    m_loggerThread.quit();
+    m_loggerThread.wait();
+}
+
+/**
+ * Returns the interval (in milliseconds) of the tick shared by the engines
+ */
+int Fleet::tickInterval() const {
+    return m_tickInterval;
+}
+
+/**
+ * Returns the number of engines hosted by the fleet
+ */
+int Fleet::engineCount() const {
+    return m_engines.count();
+}
+
+/**
+ * Returns a list with all the engines hosted by the fleet
+ */
+QList<DriverStation*> Fleet::engines() const {
+    return m_engines;
+}
+
+/**
+ * Returns the engine at the given \a index, or \c NULL if the index is invalid
+ */
+DriverStation* Fleet::engine (int index) const {
+    if (index >= 0 && index < m_engines.count())
+        return m_engines.at (index);
+
+    return Q_NULLPTR;
+}
+
+/**
+ * Creates a new DS engine in the network thread and returns it once it is
+ * ready for use. The \a name is used to identify the engine in the logs.
+ *
+ * \note The new engine has no protocol, use \c setProtocolType() to load one
+ */
+DriverStation* Fleet::createEngine (const QString& name) {
+    DriverStation* engine = Q_NULLPTR;
+    QMetaObject::invokeMethod (m_scheduler,
+                               "createEngine",
+                               Qt::BlockingQueuedConnection,
+                               Q_RETURN_ARG (DriverStation*, engine),
+                               Q_ARG (QString, name),
+                               Q_ARG (QThread*, &m_loggerThread));
+
+    if (engine) {
+        m_engines.append (engine);
+        emit engineCountChanged (engineCount());
+    }
+
+    return engine;
+}
+
+/**
+ * Changes the interval (in \a msecs) of the tick shared by the engines
+ */
+void Fleet::setTickInterval (int msecs) {
+    if (m_tickInterval != msecs) {
+        m_tickInterval = msecs;
+        QMetaObject::invokeMethod (m_scheduler,
+                                   "setTickInterval",
+                                   Qt::QueuedConnection,
+                                   Q_ARG (int, msecs));
+    }
+}
+
+/**
+ * Stops and deletes the given \a engine
+ */
+void Fleet::destroyEngine (DriverStation* engine) {
+    if (m_engines.removeAll (engine) > 0) {
+        QMetaObject::invokeMethod (m_scheduler,
+                                   "destroyEngine",
+                                   Qt::BlockingQueuedConnection,
+                                   Q_ARG (DriverStation*, engine));
+
+        emit engineCountChanged (engineCount());
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_FLEET_H
+#define _LIB_DS_FLEET_H
+
+#include <QThread>
+#include <DriverStation.h>
+
+class FleetScheduler;
+
+/**
+ * \brief Runs several independent DS engines in a single process
+ *
+ * Each engine is a \c DriverStation with its own configuration, protocol,
+ * sockets and logger. All the engines live in a shared network thread and are
+ * driven by a single timer, while their loggers share another thread.
+ *
+ * This allows simulation farms to drive dozens of (simulated) robots from a
+ * single process, instead of running a full application for each robot.
+ *
+ * \note Since the engines live in the network thread, the application must
+ *       use queued connections (or \c QMetaObject::invokeMethod()) to call
+ *       their slots, for example:
+ *
+ * \code
+ * DriverStation* ds = fleet.createEngine ("Robot 1");
+ * QMetaObject::invokeMethod (ds, "setTeam", Q_ARG (int, 3794));
+ * QMetaObject::invokeMethod (ds, "setProtocolType", Q_ARG (int, 0));
+ * \endcode
+ */
+class Fleet : public QObject {
+    Q_OBJECT
+
+  signals:
+    void engineCountChanged (int count);
+
+  public:
+    explicit Fleet (QObject* parent = Q_NULLPTR);
+    ~Fleet();
+
+    int tickInterval() const;
+    int engineCount() const;
+    QList<DriverStation*> engines() const;
+    DriverStation* engine (int index) const;
+    DriverStation* createEngine (const QString& name);
+
+  public slots:
+    void setTickInterval (int msecs);
+    void destroyEngine (DriverStation* engine);
+
+  private:
+    int m_tickInterval;
+    QThread m_loggerThread;
+    QThread m_networkThread;
+    FleetScheduler* m_scheduler;
+    QList<DriverStation*> m_engines;
+};
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include <QUrl>
+#include <QFileDialog>
+#include <QDesktopServices>
+#include <DriverStation.h>
+
+#include "GuiHelpers.h"
+
+GuiHelpers::GuiHelpers (DriverStation* driverStation, QObject* parent) :
+    QObject (parent) {
+    m_driverStation = driverStation;
+}
+
+/**
+ * Shows an open file dialog and lets the user select a DS log file to load...
+ */
+void GuiHelpers::browseLogs() {
+    QString filter = "*." + m_driverStation->logsExtension();
+    QString file = QFileDialog::getOpenFileName (Q_NULLPTR,
+                                                 tr ("Select a log file..."),
+                                                 m_driverStation->logsPath(),
+                                                 filter);
+
+    if (!file.isEmpty())
+        m_driverStation->openLog (file);
+}
+
+/**
+ * Opens the application logs in an explorer window
+ */
+void GuiHelpers::openLogsPath() {
+    QDesktopServices::openUrl (QUrl::fromLocalFile (m_driverStation->logsPath()));
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_GUI_HELPERS_H
+#define _LIB_DS_GUI_HELPERS_H
+
+#include <QObject>
+
+class DriverStation;
+
+/**
+ * \brief Desktop integration functions of the \c DriverStation
+ *
+ * The LibDS core only depends on the \c core and \c network Qt modules, so
+ * that it can be used in headless applications (e.g. the DS daemon). The
+ * functions that need a desktop environment (file dialogs, file managers)
+ * live here instead, and are only built by the \c LibDS_Gui.pri project.
+ */
+class GuiHelpers : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit GuiHelpers (DriverStation* driverStation,
+                         QObject* parent = Q_NULLPTR);
+
+  public slots:
+    void browseLogs();
+    void openLogsPath();
+
+  private:
+    DriverStation* m_driverStation;
+};
+
+#endif
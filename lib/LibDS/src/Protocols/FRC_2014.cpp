@@ -256,6 +256,18 @@ QByteArray FRC_2014::getRobotPacket() {
     return data;
 }
 
+/**
+ * Generates an urgent packet for the robot, without changing the checksum
+ * state used by the periodic robot packets
+ */
+QByteArray FRC_2014::getUrgentRobotPacket() {
+    CRC32 crc32 = m_crc32;
+    QByteArray data = getRobotPacket();
+    m_crc32 = crc32;
+
+    return data;
+}
+
 /**
  * Gets the team station and robot mode from the FMS
  */
@@ -439,34 +451,36 @@ DS_UByte FRC_2014::getOperationCode() {
 QByteArray FRC_2014::getJoystickData() {
     QByteArray data;
 
-    for (int i = 0; i < maxJoystickCount(); ++i) {
-        bool joystickExists = joysticks()->count() > i;
+    /* Get a consistent copy of the joystick values */
+    const JoystickStore::Snapshot& snapshot = takeJoystickSnapshot();
+
+    /* Query the limits once, instead of once per joystick & axis */
+    const int maxJoysticks = maxJoystickCount();
+    const int maxAxes = maxAxisCount();
+
+    for (int i = 0; i < maxJoysticks; ++i) {
+        bool joystickExists = snapshot.count > i;
+        int index = qMin (i, JoystickStore::MAX_JOYSTICKS - 1);
+        const JoystickStore::State& joystick = snapshot.joysticks [index];
 
-        /* Get number of axes & buttons */
-        int numAxes = joystickExists ? joysticks()->at (i)->numAxes : 0;
-        int numButtons = joystickExists ? joysticks()->at (i)->numButtons : 0;
+        /* Get number of axes & button states */
+        int numAxes = joystickExists ? joystick.numAxes : 0;
+        quint32 buttons = joystickExists ? joystick.buttons : 0;
 
         /* Add axis values */
-        for (int axis = 0; axis < maxAxisCount(); ++axis) {
+        for (int axis = 0; axis < maxAxes; ++axis) {
             /* Joystick connected, add real data */
             if (joystickExists && axis < numAxes)
-                data.append ((DS_SByte) (joysticks()->at (i)->axes [axis] * 127));
+                data.append (joystick.axes [axis]);
 
             /* Joystick disconnected, add neutral data */
             else
                 data.append (static_cast<char> (0x00));
         }
 
-        /* Calculate value of buttons */
-        int button_data = 0;
-        for (int button = 0; button < numButtons; ++button) {
-            if (joystickExists && joysticks()->at (i)->buttons [button])
-                button_data |= static_cast<int> (qPow (2, button));
-        }
-
         /* Add button data */
-        data.append ((button_data & 0xff00) >> 8);
-        data.append ((button_data & 0xff));
+        data.append ((buttons & 0xff00) >> 8);
+        data.append ((buttons & 0xff));
     }
 
     return data;
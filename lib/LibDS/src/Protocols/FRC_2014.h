@@ -56,6 +56,7 @@ class FRC_2014 : public Protocol {
     /* Packet generation functions */
     virtual QByteArray getFMSPacket();
     virtual QByteArray getRobotPacket();
+    virtual QByteArray getUrgentRobotPacket();
 
     /* Packet interpretation functions */
     virtual bool interpretFMSPacket (const QByteArray& data);
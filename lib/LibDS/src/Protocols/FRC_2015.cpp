@@ -223,6 +223,16 @@ void FRC_2015::onRobotWatchdogExpired() {
     m_sendDateTime = false;
 }
 
+/**
+ * The robot replies to each DS packet with the same sequence number
+ */
+int FRC_2015::robotPacketEcho (const QByteArray& data) {
+    if (data.length() < 2)
+        return -1;
+
+    return ((DS_UByte) data.at (0) << 8) | (DS_UByte) data.at (1);
+}
+
 /**
  * Returns the nominal/maximum voltage given by the robot battery.
  */
@@ -303,6 +313,40 @@ QByteArray FRC_2015::getRobotPacket() {
     return data;
 }
 
+/**
+ * Robot packets can be patched in place, since their joystick values are
+ * stored at fixed offsets as long as the joysticks do not change
+ */
+bool FRC_2015::supportsRobotPacketPatching() {
+    return true;
+}
+
+/**
+ * Re-samples the control, request and station bytes and the joystick values
+ * of a robot packet that was generated ahead of time. The header of the
+ * packet (sequence number and tag) is kept as-is.
+ *
+ * The tail of the packet is only encoded again if it carries the date and
+ * time or if the joysticks were registered or removed in the meantime.
+ */
+void FRC_2015::updateRobotPacket (QByteArray* packet) {
+    /* Packet was not generated by us, encode it again */
+    if (packet->size() < 6) {
+        *packet = getRobotPacket();
+        return;
+    }
+
+    (*packet)[3] = getControlCode();
+    (*packet)[4] = getRequestCode();
+    (*packet)[5] = getTeamStationCode();
+
+    if (m_sendDateTime || !patchJoystickData (packet)) {
+        packet->truncate (6);
+        packet->append (m_sendDateTime ? getTimezoneData() :
+                        getJoystickData());
+    }
+}
+
 /**
  * Interprets the packet and follows the instructions sent by the FMS.
  * Possible instructions are:
@@ -319,13 +363,13 @@ bool FRC_2015::interpretFMSPacket (const QByteArray& data) {
         /* Change robot enabled state based on what FMS tells us to do*/
         config()->setEnabled (control & cEnabled);
 
-        /* Get FMS robot mode */
-        if (control & cTeleoperated)
-            config()->updateControlMode (DS::kControlTeleoperated);
-        else if (control & cAutonomous)
+        /* Get FMS robot mode (teleoperated has no flag of its own) */
+        if (control & cAutonomous)
             config()->updateControlMode (DS::kControlAutonomous);
         else if (control & cTest)
             config()->updateControlMode (DS::kControlTest);
+        else
+            config()->updateControlMode (DS::kControlTeleoperated);
 
         /* Update to correct alliance and position */
         config()->updateAlliance (getAlliance (station));
@@ -406,7 +450,7 @@ QByteArray FRC_2015::getTimezoneData() {
     data.append (0x0B);
 
     /* Get current date/time */
-    QDateTime dt = QDateTime::currentDateTime();
+    QDateTime dt = Clock::getInstance()->currentDateTime();
     QDate date = dt.date();
     QTime time = dt.time();
 
@@ -444,43 +488,98 @@ QByteArray FRC_2015::getJoystickData() {
     if (sentRobotPackets() <= 5)
         return data;
 
+    /* Get a consistent copy of the joystick values */
+    const JoystickStore::Snapshot& snapshot = takeJoystickSnapshot();
+
     /* Generate data for each joystick */
-    for (int i = 0; i < joysticks()->count(); ++i) {
-        int numAxes    = joysticks()->at (i)->numAxes;
-        int numPOVs    = joysticks()->at (i)->numPOVs;
-        int numButtons = joysticks()->at (i)->numButtons;
+    for (int i = 0; i < snapshot.count; ++i) {
+        const JoystickStore::State& joystick = snapshot.joysticks [i];
+        int numAxes    = joystick.numAxes;
+        int numPOVs    = joystick.numPOVs;
+        int numButtons = joystick.numButtons;
 
         /* Add joystick information and put the section header */
-        data.append (getJoystickSize (*joysticks()->at (i)) - 1);
+        data.append (getJoystickSize (joystick) - 1);
         data.append (cTagJoystick);
 
         /* Add axis data */
         data.append (numAxes);
         for (int axis = 0; axis < numAxes; ++axis)
-            data.append ((DS_SByte) (joysticks()->at (i)->axes [axis] * 127));
-
-        /* Generate button data */
-        int buttonData = 0;
-        for (int button = 0; button < numButtons; ++button)
-            buttonData += joysticks()->at (i)->buttons [button] ?
-                          qPow (2, button) : 0;
+            data.append (joystick.axes [axis]);
 
-        /* Add button data */
+        /* Add button data (the packed button word, most significant first) */
         data.append (numButtons);
-        data.append ((buttonData & 0xff00) >> 8);
-        data.append ((buttonData & 0xff));
+        for (int byte = (numButtons + 7) / 8 - 1; byte >= 0; --byte)
+            data.append ((joystick.buttons >> (byte * 8)) & 0xff);
 
         /* Add hat/pov data */
         data.append (numPOVs);
         for (int hat = 0; hat < numPOVs; ++hat) {
-            data.append ((joysticks()->at (i)->povs [hat] & 0xff00) >> 8);
-            data.append ((joysticks()->at (i)->povs [hat] & 0xff));
+            data.append ((joystick.povs [hat] & 0xff00) >> 8);
+            data.append ((joystick.povs [hat] & 0xff));
         }
     }
 
     return data;
 }
 
+/**
+ * Overwrites the axis, button and POV values of the joystick data of the
+ * given robot \a packet with the current joystick values.
+ *
+ * Returns \c false (and the tail of the packet must be encoded again) if
+ * the joystick data of the packet does not have the layout that
+ * \c getJoystickData() would generate now.
+ */
+bool FRC_2015::patchJoystickData (QByteArray* packet) {
+    /* Do not send joystick data on DS init */
+    if (sentRobotPackets() <= 5)
+        return packet->size() == 6;
+
+    /* Get a consistent copy of the joystick values */
+    const JoystickStore::Snapshot& snapshot = takeJoystickSnapshot();
+
+    char* data = packet->data();
+    int offset = 6;
+
+    for (int i = 0; i < snapshot.count; ++i) {
+        const JoystickStore::State& joystick = snapshot.joysticks [i];
+        int numAxes    = joystick.numAxes;
+        int numPOVs    = joystick.numPOVs;
+        int numButtons = joystick.numButtons;
+        int size       = getJoystickSize (joystick);
+
+        /* Check the section header and the counts of the joystick */
+        if (offset + size > packet->size()
+                || (DS_UByte) data [offset] != size - 1
+                || (DS_UByte) data [offset + 1] != cTagJoystick
+                || (DS_UByte) data [offset + 2] != numAxes
+                || (DS_UByte) data [offset + 3 + numAxes] != numButtons
+                || (DS_UByte) data [offset + size - 1 - numPOVs * 2]
+                != numPOVs)
+            return false;
+
+        /* Overwrite axis data */
+        offset += 3;
+        for (int axis = 0; axis < numAxes; ++axis)
+            data [offset++] = joystick.axes [axis];
+
+        /* Overwrite button data (most significant byte first) */
+        offset += 1;
+        for (int byte = (numButtons + 7) / 8 - 1; byte >= 0; --byte)
+            data [offset++] = (joystick.buttons >> (byte * 8)) & 0xff;
+
+        /* Overwrite hat/pov data */
+        offset += 1;
+        for (int hat = 0; hat < numPOVs; ++hat) {
+            data [offset++] = (joystick.povs [hat] & 0xff00) >> 8;
+            data [offset++] = (joystick.povs [hat] & 0xff);
+        }
+    }
+
+    return offset == packet->size();
+}
+
 /**
  * This function returns the alliance color referenced by the given \a station
  * code. This function is used to follow the instructions outlined by the
@@ -713,7 +812,7 @@ DS_UByte FRC_2015::getTeamStationCode() {
  * This information will help the robot decide where a information starts and
  * ends for each attached joystick.
  */
-DS_UByte FRC_2015::getJoystickSize (const DS::Joystick& joystick) {
+DS_UByte FRC_2015::getJoystickSize (const JoystickStore::State& joystick) {
     return  5
             + (joystick.numAxes > 0 ? joystick.numAxes : 0)
             + (joystick.numButtons / 8)
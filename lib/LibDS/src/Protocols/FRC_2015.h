@@ -41,6 +41,7 @@ class FRC_2015 : public Protocol {
     virtual void rebootRobot();
     virtual void restartRobotCode();
     virtual void onRobotWatchdogExpired();
+    virtual int robotPacketEcho (const QByteArray& data);
 
     /* Battery information */
     virtual qreal nominalBatteryVoltage();
@@ -57,6 +58,8 @@ class FRC_2015 : public Protocol {
     /* Packet generation functions */
     virtual QByteArray getFMSPacket();
     virtual QByteArray getRobotPacket();
+    virtual void updateRobotPacket (QByteArray* packet);
+    virtual bool supportsRobotPacketPatching();
 
     /* Packet interpretation functions */
     virtual bool interpretFMSPacket (const QByteArray& data);
@@ -65,6 +68,7 @@ class FRC_2015 : public Protocol {
   protected:
     virtual QByteArray getTimezoneData();
     virtual QByteArray getJoystickData();
+    virtual bool patchJoystickData (QByteArray* packet);
 
     virtual DS::Alliance getAlliance (DS_UByte station);
     virtual DS::Position getPosition (DS_UByte station);
@@ -75,7 +79,7 @@ class FRC_2015 : public Protocol {
     virtual DS_UByte getRequestCode();
     virtual DS_UByte getFMSControlCode();
     virtual DS_UByte getTeamStationCode();
-    virtual DS_UByte getJoystickSize (const DS::Joystick& joystick);
+    virtual DS_UByte getJoystickSize (const JoystickStore::State& joystick);
 
   private:
     bool m_restartCode;
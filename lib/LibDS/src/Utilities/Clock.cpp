@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Clock.h"
+
+#include <atomic>
+#include <chrono>
+#include <QTimer>
+#include <QMetaObject>
+#include <QElapsedTimer>
+
+/* Clock used when no other clock has been set */
+static Clock SYSTEM_CLOCK;
+
+/* Clock used by the LibDS */
+static std::atomic<Clock*> CURRENT_CLOCK (&SYSTEM_CLOCK);
+
+Clock::~Clock() {}
+
+/**
+ * Returns the clock that is currently used by the LibDS
+ */
+Clock* Clock::getInstance() {
+    return CURRENT_CLOCK.load (std::memory_order_acquire);
+}
+
+/**
+ * Makes the LibDS use the given \a clock, or the system clock if \a clock is
+ * \c NULL. The clock is not owned by the LibDS, and must outlive every object
+ * that uses it.
+ */
+void Clock::setInstance (Clock* clock) {
+    CURRENT_CLOCK.store (clock ? clock : &SYSTEM_CLOCK,
+                         std::memory_order_release);
+}
+
+/**
+ * Returns the current time of a monotonic clock, in milliseconds
+ */
+qint64 Clock::elapsed() const {
+    return QElapsedTimer::msecsSinceReference();
+}
+
+/**
+ * Returns the current time of the same monotonic clock, in nanoseconds
+ */
+qint64 Clock::nsecsElapsed() const {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds> (steady_clock::now()
+                                       .time_since_epoch()).count();
+}
+
+/**
+ * Returns the current local date and time
+ */
+QDateTime Clock::currentDateTime() const {
+    return QDateTime::currentDateTime();
+}
+
+/**
+ * Invokes the given \a slot (e.g. \c SLOT (update())) of the \a receiver
+ * once after \a msecs milliseconds
+ */
+void Clock::schedule (int msecs, QObject* receiver, const char* slot) {
+    QTimer::singleShot (msecs, Qt::PreciseTimer, receiver, slot);
+}
+
+VirtualClock::VirtualClock (const QDateTime& start) {
+    m_now = 0;
+    m_start = start;
+}
+
+/**
+ * Returns the number of scheduled slots that have not been invoked yet
+ */
+int VirtualClock::pendingTimers() const {
+    QMutexLocker lock (&m_mutex);
+    return m_timers.count();
+}
+
+/**
+ * Moves the time forward by \a msecs milliseconds, invoking every scheduled
+ * slot that becomes due. Returns the number of invoked slots.
+ */
+int VirtualClock::advance (qint64 msecs) {
+    QMutexLocker lock (&m_mutex);
+    qint64 end = m_now + qMax (msecs, qint64 (0));
+
+    int invoked = 0;
+    while (!m_timers.isEmpty() && m_timers.first().deadline <= end) {
+        Timer timer = m_timers.takeFirst();
+        m_now = qMax (m_now, timer.deadline);
+
+        /* Let the slot read the time and schedule new operations */
+        lock.unlock();
+        if (timer.receiver) {
+            QMetaObject::invokeMethod (timer.receiver, timer.slot.constData(),
+                                       Qt::DirectConnection);
+            ++invoked;
+        }
+        lock.relock();
+    }
+
+    m_now = end;
+    return invoked;
+}
+
+/**
+ * Returns the virtual time, in milliseconds
+ */
+qint64 VirtualClock::elapsed() const {
+    QMutexLocker lock (&m_mutex);
+    return m_now;
+}
+
+/**
+ * Returns the virtual time, in nanoseconds
+ */
+qint64 VirtualClock::nsecsElapsed() const {
+    QMutexLocker lock (&m_mutex);
+    return m_now * 1000000;
+}
+
+/**
+ * Returns the start date plus the virtual time
+ */
+QDateTime VirtualClock::currentDateTime() const {
+    QMutexLocker lock (&m_mutex);
+    return m_start.addMSecs (m_now);
+}
+
+/**
+ * Schedules the given \a slot of the \a receiver to be invoked when the
+ * virtual time is advanced by \a msecs milliseconds. Slots with the same
+ * deadline are invoked in the order in which they were scheduled.
+ */
+void VirtualClock::schedule (int msecs, QObject* receiver, const char* slot) {
+    if (!receiver || !slot)
+        return;
+
+    /* SLOT() prepends a code to the signature, keep only the method name */
+    QByteArray name (slot);
+    if (!name.isEmpty() && name.at (0) >= '0' && name.at (0) <= '9')
+        name.remove (0, 1);
+    if (name.contains ('('))
+        name.truncate (name.indexOf ('('));
+
+    Timer timer;
+    timer.slot = name;
+    timer.receiver = receiver;
+
+    QMutexLocker lock (&m_mutex);
+    timer.deadline = m_now + qMax (msecs, 0);
+
+    int index = m_timers.count();
+    while (index > 0 && m_timers.at (index - 1).deadline > timer.deadline)
+        --index;
+
+    m_timers.insert (index, timer);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_CLOCK_H
+#define _LIB_DS_CLOCK_H
+
+#include <QList>
+#include <QMutex>
+#include <QPointer>
+#include <QDateTime>
+
+/**
+ * \brief Provides the time and the timers used by the LibDS
+ *
+ * Every part of the LibDS that needs to know the time or to run an operation
+ * later (e.g. \c DS_Schedule, the watchdogs and the logger) asks the current
+ * clock instead of using \c QTimer, \c QElapsedTimer or \c QDateTime directly.
+ *
+ * The default clock uses the system clocks and the Qt event loop. Tests can
+ * replace it with a \c VirtualClock, which allows them to simulate minutes of
+ * DS operation (watchdog expirations, packet cadences, etc.) in a few
+ * milliseconds and without depending on the load of the computer.
+ *
+ * \note The clock should be replaced before creating any \c DriverStation,
+ *       since the operations scheduled with the previous clock are not moved
+ *       to the new one
+ */
+class Clock {
+  public:
+    virtual ~Clock();
+
+    static Clock* getInstance();
+    static void setInstance (Clock* clock);
+
+    virtual qint64 elapsed() const;
+    virtual qint64 nsecsElapsed() const;
+    virtual QDateTime currentDateTime() const;
+    virtual void schedule (int msecs, QObject* receiver, const char* slot);
+};
+
+/**
+ * \brief Clock whose time only advances when it is told to
+ *
+ * The time starts at zero (and at the given date) and is moved forward with
+ * \c advance(), which invokes every scheduled slot that becomes due in
+ * order, with the time set to the deadline of each slot. Slots may schedule
+ * new operations, which are invoked during the same call if they become due
+ * before the end of the advanced interval.
+ *
+ * Slots are invoked directly from the thread that calls \c advance(), which
+ * should be the thread of the receivers.
+ */
+class VirtualClock : public Clock {
+  public:
+    explicit VirtualClock (const QDateTime& start =
+                               QDateTime (QDate (2016, 1, 1)));
+
+    int pendingTimers() const;
+    int advance (qint64 msecs);
+
+    qint64 elapsed() const;
+    qint64 nsecsElapsed() const;
+    QDateTime currentDateTime() const;
+    void schedule (int msecs, QObject* receiver, const char* slot);
+
+  private:
+    struct Timer {
+        qint64 deadline;
+        QPointer<QObject> receiver;
+        QByteArray slot;
+    };
+
+    qint64 m_now;
+    QDateTime m_start;
+    QList<Timer> m_timers;
+    mutable QMutex m_mutex;
+};
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Histogram.h"
+
+#include <QtMath>
+#include <string.h>
+
+/* Number of bits used to select a sub-bucket (log2 of SUB_BUCKETS) */
+const int SUB_BUCKET_BITS = 3;
+
+/**
+ * Returns the position of the most significant bit set in \a value
+ */
+static int MSB (quint64 value) {
+    int bit = 0;
+    while (value >>= 1)
+        ++bit;
+
+    return bit;
+}
+
+Histogram::Histogram() {
+    reset();
+}
+
+/**
+ * Returns the smallest recorded value
+ */
+qint64 Histogram::min() const {
+    return m_count > 0 ? m_min : 0;
+}
+
+/**
+ * Returns the largest recorded value
+ */
+qint64 Histogram::max() const {
+    return m_max;
+}
+
+/**
+ * Returns the average of the recorded values
+ */
+qreal Histogram::mean() const {
+    if (m_count > 0)
+        return m_total / m_count;
+
+    return 0;
+}
+
+/**
+ * Returns the number of recorded values
+ */
+quint64 Histogram::count() const {
+    return m_count;
+}
+
+/**
+ * Returns the value below which the given \a percent (0 to 100) of the
+ * recorded values fall. The value is rounded up to the upper limit of its
+ * bucket, but never exceeds the largest recorded value.
+ */
+qint64 Histogram::percentile (qreal percent) const {
+    if (m_count == 0)
+        return 0;
+
+    quint64 target = qCeil (qBound (qreal (0), percent, qreal (100))
+                            * m_count / 100);
+    target = qMax (target, quint64 (1));
+
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets [i];
+        if (seen >= target)
+            return qBound (min(), bucketLimit (i), m_max);
+    }
+
+    return m_max;
+}
+
+/**
+ * Returns a single-line description of the distribution, suitable for the
+ * DS log
+ */
+QString Histogram::summary (const QString& unit) const {
+    return QString ("n=%1 min=%2%7 mean=%3%7 p50=%4%7 p99=%5%7 max=%6%7")
+           .arg (m_count)
+           .arg (min())
+           .arg (qRound64 (mean()))
+           .arg (percentile (50))
+           .arg (percentile (99))
+           .arg (max())
+           .arg (unit);
+}
+
+/**
+ * Removes all the recorded values
+ */
+void Histogram::reset() {
+    m_min = 0;
+    m_max = 0;
+    m_total = 0;
+    m_count = 0;
+    memset (m_buckets, 0, sizeof (m_buckets));
+}
+
+/**
+ * Adds the given \a value to the histogram, negative values are recorded
+ * as \c 0
+ */
+void Histogram::record (qint64 value) {
+    value = qMax (value, qint64 (0));
+
+    if (m_count == 0 || value < m_min)
+        m_min = value;
+    if (value > m_max)
+        m_max = value;
+
+    m_count += 1;
+    m_total += value;
+    m_buckets [bucketIndex (value)] += 1;
+}
+
+/**
+ * Returns the index of the bucket that counts the given \a value
+ */
+int Histogram::bucketIndex (qint64 value) {
+    if (value < SUB_BUCKETS)
+        return static_cast<int> (value);
+
+    int shift = MSB (value) - SUB_BUCKET_BITS;
+    int sub = static_cast<int> (value >> shift) - SUB_BUCKETS;
+
+    return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+}
+
+/**
+ * Returns the largest value that is counted by the bucket at \a index
+ */
+qint64 Histogram::bucketLimit (int index) {
+    if (index < SUB_BUCKETS)
+        return index;
+
+    int shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    int sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+
+    return static_cast<qint64> ((quint64 (SUB_BUCKETS + sub + 1) << shift) - 1);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_HISTOGRAM_H
+#define _LIB_DS_HISTOGRAM_H
+
+#include <QString>
+
+/**
+ * \brief Records the distribution of non-negative values (e.g. latencies)
+ *
+ * Values are counted in log-linear buckets: each power of two is split in
+ * \c SUB_BUCKETS buckets of the same width, so the relative error of the
+ * reported percentiles is at most 12.5% regardless of the magnitude of the
+ * values. Recording a value is a few integer operations and never allocates.
+ *
+ * \note This class is not thread-safe
+ */
+class Histogram {
+  public:
+    explicit Histogram();
+
+    static const int SUB_BUCKETS = 8;
+    static const int BUCKET_COUNT = SUB_BUCKETS + 60 * SUB_BUCKETS;
+
+    qint64 min() const;
+    qint64 max() const;
+    qreal mean() const;
+    quint64 count() const;
+    qint64 percentile (qreal percent) const;
+    QString summary (const QString& unit = "us") const;
+
+    void reset();
+    void record (qint64 value);
+
+  private:
+    static int bucketIndex (qint64 value);
+    static qint64 bucketLimit (int index);
+
+  private:
+    qint64 m_min;
+    qint64 m_max;
+    qreal m_total;
+    quint64 m_count;
+    quint64 m_buckets [BUCKET_COUNT];
+};
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_SEQLOCK_H
+#define _LIB_DS_SEQLOCK_H
+
+#include <atomic>
+#include <string.h>
+
+/**
+ * \brief Publishes a plain block of data from any thread to lock-free readers
+ *
+ * Writers are serialized with a spin lock and increment the sequence counter
+ * before and after modifying the data, so the counter is odd while a write is
+ * in progress. Readers copy the data and retry if the counter was odd or has
+ * changed during the copy, which means that readers never block writers and
+ * always obtain a consistent copy.
+ *
+ * Writes must be short (a few stores), since readers and other writers spin
+ * while a write is in progress.
+ *
+ * \note The protected data must be trivially copyable
+ */
+class SeqLock {
+  public:
+    SeqLock() : m_sequence (0) {
+        m_writer.clear();
+    }
+
+    /**
+     * Waits for other writers to finish and marks the data as being modified
+     */
+    void lockForWrite() {
+        while (m_writer.test_and_set (std::memory_order_acquire));
+
+        m_sequence.store (m_sequence.load (std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+    }
+
+    /**
+     * Publishes the modified data and lets other writers continue
+     */
+    void unlockForWrite() {
+        m_sequence.store (m_sequence.load (std::memory_order_relaxed) + 1,
+                          std::memory_order_release);
+        m_writer.clear (std::memory_order_release);
+    }
+
+    /**
+     * Returns the sequence number at which a read may begin, waiting for any
+     * write that is in progress
+     */
+    unsigned readBegin() const {
+        unsigned sequence = m_sequence.load (std::memory_order_acquire);
+        while (sequence & 1)
+            sequence = m_sequence.load (std::memory_order_acquire);
+
+        return sequence;
+    }
+
+    /**
+     * Obtains the \a sequence number at which a read may begin without
+     * waiting. Returns \c false if a write is in progress.
+     */
+    bool tryReadBegin (unsigned* sequence) const {
+        *sequence = m_sequence.load (std::memory_order_acquire);
+        return (*sequence & 1) == 0;
+    }
+
+    /**
+     * Returns \c true if the data was modified since the given \a sequence
+     * was obtained with \c readBegin(), in which case the read must be retried
+     */
+    bool readRetry (unsigned sequence) const {
+        std::atomic_thread_fence (std::memory_order_acquire);
+        return m_sequence.load (std::memory_order_relaxed) != sequence;
+    }
+
+    /**
+     * Copies the given \a source data into \a destination, retrying until a
+     * consistent copy is obtained
+     */
+    template <typename T>
+    void read (const T& source, T* destination) const {
+        unsigned sequence;
+        do {
+            sequence = readBegin();
+            memcpy (destination, &source, sizeof (T));
+        } while (readRetry (sequence));
+    }
+
+  private:
+    std::atomic<unsigned> m_sequence;
+    std::atomic_flag m_writer;
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_SPSC_QUEUE_H
+#define _LIB_DS_SPSC_QUEUE_H
+
+#include <atomic>
+
+/**
+ * \brief Fixed-size lock-free queue between one producer and one consumer
+ *
+ * The producer only writes the tail index and the consumer only writes the
+ * head index, so pushing and popping never block each other. The indices
+ * are padded to keep them in separate cache lines and avoid false sharing.
+ *
+ * \note Only one thread may call \c push() and only one thread may call
+ *       \c pop() at the same time
+ * \note The \a Capacity must be a power of two
+ */
+template <typename T, unsigned Capacity>
+class SpscQueue {
+    static_assert (Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                   "The capacity must be a power of two");
+
+  public:
+    SpscQueue() : m_head (0), m_tail (0) {}
+
+    /**
+     * Returns the number of items in the queue
+     */
+    unsigned size() const {
+        return m_tail.load (std::memory_order_acquire)
+               - m_head.load (std::memory_order_acquire);
+    }
+
+    /**
+     * Returns \c true if the queue has no items
+     */
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    /**
+     * Appends the given \a item to the queue. Returns \c false if the queue
+     * is full.
+     */
+    bool push (const T& item) {
+        unsigned tail = m_tail.load (std::memory_order_relaxed);
+        if (tail - m_head.load (std::memory_order_acquire) == Capacity)
+            return false;
+
+        m_items [tail & (Capacity - 1)] = item;
+        m_tail.store (tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the oldest item of the queue and copies it to \a item.
+     * Returns \c false if the queue is empty.
+     */
+    bool pop (T* item) {
+        unsigned head = m_head.load (std::memory_order_relaxed);
+        if (head == m_tail.load (std::memory_order_acquire))
+            return false;
+
+        *item = m_items [head & (Capacity - 1)];
+        m_head.store (head + 1, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    std::atomic<unsigned> m_head;
+    char m_padding [64 - sizeof (std::atomic<unsigned>)];
+    std::atomic<unsigned> m_tail;
+    T m_items [Capacity];
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "StageTimers.h"
+#include "Tracer.h"
+
+#include <chrono>
+#include <QStringList>
+
+/* Names of the stages (also used in the trace timeline) */
+static const char* STAGE_NAMES [StageTimers::STAGE_COUNT] = {
+    "Generate robot packet",
+    "Send to robot",
+    "Read socket",
+    "Read robot packet",
+    "Config updates",
+    "Signal fan-out",
+};
+
+/* Number of active scopes of each stage in the current thread */
+static thread_local int ACTIVE_SCOPES [StageTimers::STAGE_COUNT] = {0};
+
+/**
+ * Returns the current time of a monotonic clock, in nanoseconds
+ */
+static qint64 NOW() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds> (steady_clock::now()
+                                       .time_since_epoch()).count();
+}
+
+/**
+ * Returns \c true if the given \a stage exists
+ */
+static bool IS_VALID (int stage) {
+    return stage >= 0 && stage < StageTimers::STAGE_COUNT;
+}
+
+/**
+ * Starts measuring the given \a stage, unless the stage is already being
+ * measured by this thread
+ */
+StageTimers::Scope::Scope (int stage) {
+    m_start = 0;
+    m_stage = stage;
+    m_measured = false;
+
+    if (IS_VALID (m_stage)) {
+        m_measured = (ACTIVE_SCOPES [m_stage]++ == 0);
+        if (m_measured)
+            m_start = NOW();
+    }
+}
+
+/**
+ * Records the time elapsed since the scope was created, and adds the stage
+ * to the trace timeline if tracing is enabled
+ */
+StageTimers::Scope::~Scope() {
+    if (IS_VALID (m_stage)) {
+        --ACTIVE_SCOPES [m_stage];
+        if (m_measured) {
+            qint64 elapsed = NOW() - m_start;
+            StageTimers::getInstance()->record (m_stage, elapsed);
+
+            if (Tracer::isEnabled())
+                Tracer::getInstance()->complete ("stages",
+                                                 STAGE_NAMES [m_stage],
+                                                 m_start / 1000,
+                                                 elapsed / 1000);
+        }
+    }
+}
+
+StageTimers::StageTimers() {
+    reset();
+}
+
+/**
+ * Returns the only instance of the class
+ */
+StageTimers* StageTimers::getInstance() {
+    static StageTimers instance;
+    return &instance;
+}
+
+/**
+ * Returns a human-readable name of the given \a stage
+ */
+QString StageTimers::stageName (int stage) {
+    if (IS_VALID (stage))
+        return STAGE_NAMES [stage];
+
+    return "Invalid";
+}
+
+/**
+ * Returns the number of times that the given \a stage ran
+ */
+quint64 StageTimers::count (int stage) const {
+    if (IS_VALID (stage))
+        return m_counters [stage].count.load (std::memory_order_relaxed);
+
+    return 0;
+}
+
+/**
+ * Returns the total time (in nanoseconds) spent in the given \a stage
+ */
+quint64 StageTimers::total (int stage) const {
+    if (IS_VALID (stage))
+        return m_counters [stage].total.load (std::memory_order_relaxed);
+
+    return 0;
+}
+
+/**
+ * Returns the longest run (in nanoseconds) of the given \a stage
+ */
+quint64 StageTimers::max (int stage) const {
+    if (IS_VALID (stage))
+        return m_counters [stage].max.load (std::memory_order_relaxed);
+
+    return 0;
+}
+
+/**
+ * Returns a human-readable table with the counters of every stage, the times
+ * are written in microseconds
+ */
+QString StageTimers::dump() const {
+    QStringList lines;
+
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        quint64 runs = count (i);
+        quint64 mean = runs > 0 ? total (i) / runs : 0;
+
+        lines.append (QString ("%1: n=%2 total=%3us mean=%4us max=%5us")
+                      .arg (stageName (i))
+                      .arg (runs)
+                      .arg (total (i) / 1000)
+                      .arg (mean / 1000.0, 0, 'f', 1)
+                      .arg (max (i) / 1000.0, 0, 'f', 1));
+    }
+
+    return lines.join ("\n");
+}
+
+/**
+ * Clears the counters of every stage
+ */
+void StageTimers::reset() {
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        m_counters [i].count.store (0, std::memory_order_relaxed);
+        m_counters [i].total.store (0, std::memory_order_relaxed);
+        m_counters [i].max.store (0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Adds a run of the given \a stage that took \a nsecs nanoseconds
+ */
+void StageTimers::record (int stage, qint64 nsecs) {
+    if (!IS_VALID (stage))
+        return;
+
+    Counter* counter = &m_counters [stage];
+    quint64 value = static_cast<quint64> (qMax (nsecs, Q_INT64_C (0)));
+
+    counter->count.fetch_add (1, std::memory_order_relaxed);
+    counter->total.fetch_add (value, std::memory_order_relaxed);
+
+    quint64 max = counter->max.load (std::memory_order_relaxed);
+    while (value > max && !counter->max.compare_exchange_weak (
+                max, value, std::memory_order_relaxed));
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_STAGE_TIMERS_H
+#define _LIB_DS_STAGE_TIMERS_H
+
+#include <atomic>
+#include <QString>
+
+/**
+ * \brief Always-on timing counters for the stages of the packet loop
+ *
+ * Each stage keeps the number of times that it ran, the total time spent in
+ * it and the longest run (in nanoseconds, measured with a monotonic clock).
+ * The counters are atomic, so they can be updated from any thread and read
+ * at any time without locking.
+ *
+ * Stages are timed with a \c Scope guard. Stages may be nested (e.g. the
+ * DS_Config updates happen while a robot packet is read), in which case the
+ * time of the inner stage is also included in the outer stage. A stage that
+ * is re-entered (e.g. a config update that triggers another config update)
+ * is only measured once.
+ *
+ * \note The counters are shared by every DS in the process
+ */
+class StageTimers {
+  public:
+    enum Stage {
+        kGenerateRobotPacket = 0,
+        kSendToRobot         = 1,
+        kReadSocket          = 2,
+        kReadRobotPacket     = 3,
+        kConfigUpdates       = 4,
+        kSignalFanOut        = 5,
+    };
+
+    static const int STAGE_COUNT = 6;
+
+    /**
+     * \brief Measures the time until it goes out of scope
+     */
+    class Scope {
+      public:
+        explicit Scope (int stage);
+        ~Scope();
+
+      private:
+        int m_stage;
+        bool m_measured;
+        qint64 m_start;
+    };
+
+    static StageTimers* getInstance();
+    static QString stageName (int stage);
+
+    quint64 count (int stage) const;
+    quint64 total (int stage) const;
+    quint64 max (int stage) const;
+    QString dump() const;
+
+    void reset();
+    void record (int stage, qint64 nsecs);
+
+  protected:
+    explicit StageTimers();
+
+  private:
+    struct Counter {
+        std::atomic<quint64> count;
+        std::atomic<quint64> total;
+        std::atomic<quint64> max;
+    };
+
+    Counter m_counters [STAGE_COUNT];
+};
+
+#endif
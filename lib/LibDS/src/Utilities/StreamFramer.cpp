@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "StreamFramer.h"
+
+#include <QDebug>
+#include <string.h>
+
+/* Initial size of the receive buffer (grows if needed) */
+const int INITIAL_BUFFER_SIZE = 4096;
+
+StreamFramer::StreamFramer() {
+    m_start = 0;
+    m_end = 0;
+    m_buffer.resize (INITIAL_BUFFER_SIZE);
+}
+
+/**
+ * Returns the number of received bytes that do not form a complete frame yet
+ */
+int StreamFramer::bufferedBytes() const {
+    return m_end - m_start;
+}
+
+/**
+ * Returns \c true if there are frames waiting to be written to the socket
+ */
+bool StreamFramer::hasPendingFrames() const {
+    return !m_pending.isEmpty();
+}
+
+/**
+ * Discards any incomplete frame and any frame waiting to be sent.
+ * This function should be called when the underlying socket is re-created.
+ */
+void StreamFramer::reset() {
+    m_start = 0;
+    m_end = 0;
+    m_pending.clear();
+}
+
+/**
+ * Returns all the frames queued with \c enqueueFrame() as a single block of
+ * data and clears the pending buffer
+ */
+QByteArray StreamFramer::takePendingFrames() {
+    QByteArray data = m_pending;
+    m_pending.clear();
+    return data;
+}
+
+/**
+ * Prefixes the given \a data with its length and adds it to the pending
+ * buffer. Returns \c false if the packet is too large to be framed.
+ */
+bool StreamFramer::enqueueFrame (const QByteArray& data) {
+    if (data.size() > MAX_FRAME_SIZE) {
+        qWarning() << "StreamFramer: dropping oversized frame of"
+                   << data.size() << "bytes";
+        return false;
+    }
+
+    m_pending.append ((char) ((data.size() & 0xFF00) >> 8));
+    m_pending.append ((char) (data.size() & 0xFF));
+    m_pending.append (data);
+
+    return true;
+}
+
+/**
+ * Reads all the data available in the given \a device into the receive
+ * buffer and returns the frames that have been completed by it.
+ */
+QList<QByteArray> StreamFramer::read (QIODevice* device) {
+    if (!device)
+        return QList<QByteArray>();
+
+    qint64 available = device->bytesAvailable();
+    while (available > 0) {
+        reserve (static_cast<int> (available));
+
+        qint64 bytes = device->read (m_buffer.data() + m_end,
+                                     m_buffer.size() - m_end);
+        if (bytes <= 0)
+            break;
+
+        m_end += static_cast<int> (bytes);
+        available = device->bytesAvailable();
+    }
+
+    return extractFrames();
+}
+
+/**
+ * Adds the given \a data to the receive buffer and returns the frames that
+ * have been completed by it.
+ */
+QList<QByteArray> StreamFramer::append (const char* data, int length) {
+    if (data && length > 0) {
+        reserve (length);
+        memcpy (m_buffer.data() + m_end, data, length);
+        m_end += length;
+    }
+
+    return extractFrames();
+}
+
+/**
+ * Moves the incomplete frame (if any) to the beginning of the buffer
+ */
+void StreamFramer::compact() {
+    if (m_start == 0)
+        return;
+
+    if (m_end > m_start)
+        memmove (m_buffer.data(), m_buffer.constData() + m_start,
+                 m_end - m_start);
+
+    m_end -= m_start;
+    m_start = 0;
+}
+
+/**
+ * Ensures that the buffer has room for at least \a bytes after the
+ * incomplete frame
+ */
+void StreamFramer::reserve (int bytes) {
+    if (m_buffer.size() - m_end >= bytes)
+        return;
+
+    compact();
+
+    if (m_buffer.size() - m_end < bytes)
+        m_buffer.resize (qMax (m_buffer.size() * 2, m_end + bytes));
+}
+
+/**
+ * Returns every complete frame found in the receive buffer. The frames
+ * are returned without the length header.
+ */
+QList<QByteArray> StreamFramer::extractFrames() {
+    QList<QByteArray> frames;
+    const uchar* data = reinterpret_cast<const uchar*> (m_buffer.constData());
+
+    while (m_end - m_start >= HEADER_SIZE) {
+        int length = (data [m_start] << 8) | data [m_start + 1];
+        if (m_end - m_start - HEADER_SIZE < length)
+            break;
+
+        frames.append (QByteArray (m_buffer.constData() + m_start + HEADER_SIZE,
+                                   length));
+        m_start += HEADER_SIZE + length;
+    }
+
+    if (m_start == m_end) {
+        m_start = 0;
+        m_end = 0;
+    }
+
+    return frames;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_STREAM_FRAMER_H
+#define _LIB_DS_STREAM_FRAMER_H
+
+#include <QList>
+#include <QIODevice>
+#include <QByteArray>
+
+/**
+ * \brief Splits a TCP byte stream into length-prefixed frames
+ *
+ * TCP does not preserve the boundaries of the writes done by the peer, a
+ * single \c readyRead() may contain several packets or only a part of one.
+ * This class prefixes every outgoing packet with its length (16-bit, big
+ * endian) and re-assembles the incoming frames, so that the protocols always
+ * receive one complete packet at a time.
+ *
+ * The receive buffer is allocated once and re-used, the data is read from the
+ * socket directly into the free space at the end of the buffer. Incomplete
+ * frames are kept in the buffer until the rest of the data arrives.
+ *
+ * Outgoing frames are accumulated in a pending buffer, so that all the frames
+ * generated during an event loop iteration can be written with a single call.
+ */
+class StreamFramer {
+  public:
+    explicit StreamFramer();
+
+    static const int HEADER_SIZE = 2;
+    static const int MAX_FRAME_SIZE = 0xFFFF;
+
+    int bufferedBytes() const;
+    bool hasPendingFrames() const;
+
+    void reset();
+    QByteArray takePendingFrames();
+    bool enqueueFrame (const QByteArray& data);
+
+    QList<QByteArray> read (QIODevice* device);
+    QList<QByteArray> append (const char* data, int length);
+
+  private:
+    void compact();
+    void reserve (int bytes);
+    QList<QByteArray> extractFrames();
+
+  private:
+    int m_start;
+    int m_end;
+    QByteArray m_buffer;
+    QByteArray m_pending;
+};
+
+#endif
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "Tracer.h"
+
+#include <chrono>
+#include <QFile>
+#include <QThread>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+std::atomic<bool> Tracer::s_enabled (false);
+
+/**
+ * A single event, protected by its own sequence number (odd while the event
+ * is being written), so that it can be exported while its thread keeps
+ * recording events.
+ */
+struct TraceEvent {
+    std::atomic<quint64> sequence;
+    char phase;
+    const char* name;
+    const char* category;
+    qint64 start;
+    qint64 duration;
+};
+
+/**
+ * The events recorded by a single thread
+ */
+struct Tracer::Ring {
+    int id;
+    QString threadName;
+    std::atomic<quint64> written;
+    TraceEvent events [RING_SIZE];
+};
+
+/* Ring buffer of the current thread */
+static thread_local Tracer::Ring* CURRENT_RING = Q_NULLPTR;
+
+/* Events recorded before this time are not exported */
+static std::atomic<qint64> CLEAR_TIME (0);
+
+Tracer::Tracer() {}
+
+/**
+ * Disables the tracer. The ring buffers are not deleted (see
+ * \c getInstance())
+ */
+Tracer::~Tracer() {
+    s_enabled.store (false);
+}
+
+/**
+ * Returns the only instance of the class.
+ *
+ * The instance and the ring buffers are intentionally leaked: threads that
+ * are still running during static destruction (and are never joined) may
+ * record events into their ring at any time, so they must outlive every
+ * thread. The operating system reclaims the memory when the process exits.
+ */
+Tracer* Tracer::getInstance() {
+    static Tracer* instance = new Tracer;
+    return instance;
+}
+
+/**
+ * Returns the current time of a monotonic clock, in microseconds
+ */
+qint64 Tracer::timestamp() {
+    using namespace std::chrono;
+    return duration_cast<microseconds> (steady_clock::now()
+                                        .time_since_epoch()).count();
+}
+
+/**
+ * Returns the recorded events of every thread as a Chrome trace-event JSON
+ * document
+ */
+QByteArray Tracer::exportJson() {
+    QJsonArray events;
+    qint64 clearTime = CLEAR_TIME.load();
+    qint64 pid = QCoreApplication::applicationPid();
+
+    QMutexLocker locker (&m_mutex);
+    foreach (Ring* ring, m_rings) {
+        QJsonObject args;
+        QJsonObject metadata;
+        args.insert ("name", ring->threadName);
+        metadata.insert ("name", QString ("thread_name"));
+        metadata.insert ("ph", QString ("M"));
+        metadata.insert ("pid", pid);
+        metadata.insert ("tid", ring->id);
+        metadata.insert ("args", args);
+        events.append (metadata);
+
+        quint64 written = ring->written.load (std::memory_order_acquire);
+        quint64 size = static_cast<quint64> (RING_SIZE);
+        quint64 first = written > size ? written - size : 0;
+
+        for (quint64 i = first; i < written; ++i) {
+            TraceEvent* slot = &ring->events [i % RING_SIZE];
+            quint64 sequence = slot->sequence.load (std::memory_order_acquire);
+
+            TraceEvent copy;
+            copy.phase = slot->phase;
+            copy.name = slot->name;
+            copy.category = slot->category;
+            copy.start = slot->start;
+            copy.duration = slot->duration;
+
+            /* The event was overwritten while we copied it */
+            std::atomic_thread_fence (std::memory_order_acquire);
+            if (sequence != i * 2 + 2
+                    || slot->sequence.load (std::memory_order_relaxed) != sequence)
+                continue;
+
+            if (copy.start < clearTime)
+                continue;
+
+            QJsonObject event;
+            event.insert ("name", QString (copy.name));
+            event.insert ("cat", QString (copy.category));
+            event.insert ("ph", QString (QLatin1Char (copy.phase)));
+            event.insert ("ts", copy.start);
+            event.insert ("pid", pid);
+            event.insert ("tid", ring->id);
+
+            if (copy.phase == 'X')
+                event.insert ("dur", copy.duration);
+            else
+                event.insert ("s", QString ("t"));
+
+            events.append (event);
+        }
+    }
+
+    QJsonObject document;
+    document.insert ("traceEvents", events);
+    document.insert ("displayTimeUnit", QString ("ms"));
+    return QJsonDocument (document).toJson (QJsonDocument::Compact);
+}
+
+/**
+ * Writes the recorded events to the given \a file, which can then be opened
+ * with \c chrome://tracing or the Perfetto UI.
+ *
+ * Returns \c false if the file cannot be written
+ */
+bool Tracer::save (const QString& file) {
+    QFile output (file);
+    if (!output.open (QFile::WriteOnly))
+        return false;
+
+    return output.write (exportJson()) >= 0;
+}
+
+/**
+ * Discards the events recorded so far
+ */
+void Tracer::clear() {
+    CLEAR_TIME.store (timestamp());
+}
+
+/**
+ * Starts or stops recording events
+ */
+void Tracer::setEnabled (bool enabled) {
+    s_enabled.store (enabled);
+}
+
+/**
+ * Records an instant event with the given \a category and \a name
+ */
+void Tracer::instant (const char* category, const char* name) {
+    if (isEnabled())
+        write ('i', category, name, timestamp(), 0);
+}
+
+/**
+ * Records a span that began at \a start and lasted \a duration (both in
+ * microseconds, see \c timestamp())
+ */
+void Tracer::complete (const char* category, const char* name,
+                       qint64 start, qint64 duration) {
+    if (isEnabled())
+        write ('X', category, name, start, duration);
+}
+
+/**
+ * Returns the ring buffer of the calling thread, which is created the first
+ * time that the thread records an event
+ */
+Tracer::Ring* Tracer::currentRing() {
+    if (!CURRENT_RING) {
+        Ring* ring = new Ring;
+        ring->written.store (0);
+        for (int i = 0; i < RING_SIZE; ++i)
+            ring->events [i].sequence.store (0);
+
+        QThread* thread = QThread::currentThread();
+        if (thread && !thread->objectName().isEmpty())
+            ring->threadName = thread->objectName();
+
+        QMutexLocker locker (&m_mutex);
+        ring->id = m_rings.count() + 1;
+        if (ring->threadName.isEmpty())
+            ring->threadName = QString ("Thread %1").arg (ring->id);
+
+        m_rings.append (ring);
+        CURRENT_RING = ring;
+    }
+
+    return CURRENT_RING;
+}
+
+/**
+ * Writes an event to the ring buffer of the calling thread
+ */
+void Tracer::write (char phase, const char* category, const char* name,
+                    qint64 start, qint64 duration) {
+    Ring* ring = currentRing();
+    quint64 index = ring->written.load (std::memory_order_relaxed);
+    TraceEvent* slot = &ring->events [index % RING_SIZE];
+
+    slot->sequence.store (index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    slot->phase = phase;
+    slot->name = name;
+    slot->category = category;
+    slot->start = start;
+    slot->duration = duration;
+
+    slot->sequence.store (index * 2 + 2, std::memory_order_release);
+    ring->written.store (index + 1, std::memory_order_release);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef _LIB_DS_TRACER_H
+#define _LIB_DS_TRACER_H
+
+#include <atomic>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QByteArray>
+
+/**
+ * \brief Records a timeline of the DS activity in the Chrome trace format
+ *
+ * When tracing is enabled, spans (e.g. sending a packet) and instant events
+ * (e.g. a watchdog expiration) are written to a ring buffer owned by the
+ * calling thread, so that threads never contend with each other. Each ring
+ * holds the last \c RING_SIZE events of its thread, older events are
+ * overwritten.
+ *
+ * The recorded events can be exported as Chrome trace-event JSON, which can
+ * be opened offline with \c chrome://tracing or the Perfetto UI.
+ *
+ * When tracing is disabled, recording an event costs a single relaxed
+ * atomic load.
+ *
+ * \note Event names and categories are not copied, they must be string
+ *       literals (or otherwise outlive the tracer)
+ */
+class Tracer {
+  public:
+    static const int RING_SIZE = 4096;
+
+    struct Ring;
+
+    /**
+     * \brief Records a span that lasts until it goes out of scope
+     */
+    class Span {
+      public:
+        Span (const char* category, const char* name) {
+            m_start = -1;
+            m_name = name;
+            m_category = category;
+
+            if (Tracer::isEnabled())
+                m_start = Tracer::timestamp();
+        }
+
+        ~Span() {
+            if (m_start >= 0 && Tracer::isEnabled())
+                Tracer::getInstance()->complete (m_category, m_name, m_start,
+                                                 Tracer::timestamp() - m_start);
+        }
+
+      private:
+        qint64 m_start;
+        const char* m_name;
+        const char* m_category;
+    };
+
+    static Tracer* getInstance();
+
+    /**
+     * Returns \c true if events are being recorded
+     */
+    static inline bool isEnabled() {
+        return s_enabled.load (std::memory_order_relaxed);
+    }
+
+    static qint64 timestamp();
+
+    QByteArray exportJson();
+    bool save (const QString& file);
+
+    void clear();
+    void setEnabled (bool enabled);
+    void instant (const char* category, const char* name);
+    void complete (const char* category, const char* name,
+                   qint64 start, qint64 duration);
+
+  protected:
+    explicit Tracer();
+    ~Tracer();
+
+  private:
+    Ring* currentRing();
+    void write (char phase, const char* category, const char* name,
+                qint64 start, qint64 duration);
+
+  private:
+    QMutex m_mutex;
+    QList<Ring*> m_rings;
+    static std::atomic<bool> s_enabled;
+};
+
+#endif
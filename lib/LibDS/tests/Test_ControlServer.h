@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_CONTROL_SERVER
+#define TEST_CONTROL_SERVER
+
+#include <QtTest>
+#include <QLocalSocket>
+#include <Engine.h>
+#include <Core/ControlServer.h>
+
+//==============================================================================
+// CONTROL SERVER TESTS
+//==============================================================================
+
+class Test_ControlServer : public QObject {
+    Q_OBJECT
+
+  private:
+    static ControlDecoder::Command command (int opcode, int value = 0) {
+        ControlDecoder::Command command;
+        memset (&command, 0, sizeof (command));
+        command.opcode = opcode;
+        command.value = value;
+        return command;
+    }
+
+    static ControlDecoder::Command joystickFrame() {
+        ControlDecoder::Command frame = command (ControlDecoder::kJoystick);
+        frame.joystick = 1;
+        frame.axes [0] = -128;
+        frame.axes [11] = 127;
+        frame.buttons = 0x80000001;
+        frame.povs [0] = 270;
+        frame.povs [11] = -1;
+        return frame;
+    }
+
+  private slots:
+    void commandsHaveFixedSizes() {
+        QCOMPARE (ControlDecoder::encode (command (ControlDecoder::kEnable)).size(), 1);
+        QCOMPARE (ControlDecoder::encode (command (ControlDecoder::kTeam, 3794)),
+                  QByteArray::fromHex ("070ed2"));
+        QCOMPARE (ControlDecoder::encode (joystickFrame()).size(),
+                  1 + ControlDecoder::JOYSTICK_PAYLOAD_SIZE);
+        QVERIFY (ControlDecoder::encode (command (0x7f)).isEmpty());
+    }
+
+    void framesAreDecoded() {
+        QByteArray data = ControlDecoder::encode (joystickFrame());
+
+        ControlDecoder decoder;
+        decoder.append (data.constData(), data.size());
+
+        ControlDecoder::Command decoded;
+        QVERIFY (decoder.next (&decoded));
+        QCOMPARE (decoded.opcode, int (ControlDecoder::kJoystick));
+        QCOMPARE (decoded.joystick, 1);
+        QCOMPARE ((int) decoded.axes [0], -128);
+        QCOMPARE ((int) decoded.axes [11], 127);
+        QCOMPARE (decoded.buttons, quint32 (0x80000001));
+        QCOMPARE ((int) decoded.povs [0], 270);
+        QCOMPARE ((int) decoded.povs [11], -1);
+        QVERIFY (!decoder.next (&decoded));
+        QCOMPARE (decoder.bufferedBytes(), 0);
+    }
+
+    void partialCommandsAreBuffered() {
+        QByteArray data = ControlDecoder::encode (command (ControlDecoder::kTeam, 254))
+                          + ControlDecoder::encode (command (ControlDecoder::kDisable));
+
+        ControlDecoder decoder;
+        ControlDecoder::Command decoded;
+        decoder.append (data.constData(), 1);
+        QVERIFY (!decoder.next (&decoded));
+        decoder.append (data.constData() + 1, 1);
+        QVERIFY (!decoder.next (&decoded));
+        QCOMPARE (decoder.bufferedBytes(), 2);
+
+        decoder.append (data.constData() + 2, 2);
+        QVERIFY (decoder.next (&decoded));
+        QCOMPARE (decoded.opcode, int (ControlDecoder::kTeam));
+        QCOMPARE (decoded.value, 254);
+
+        QVERIFY (decoder.next (&decoded));
+        QCOMPARE (decoded.opcode, int (ControlDecoder::kDisable));
+        QCOMPARE (decoder.bufferedBytes(), 0);
+    }
+
+    void unknownOpcodesStopTheDecoder() {
+        QByteArray data = QByteArray::fromHex ("01ff02");
+
+        ControlDecoder decoder;
+        decoder.append (data.constData(), data.size());
+
+        ControlDecoder::Command decoded;
+        QVERIFY (decoder.next (&decoded));
+        QVERIFY (!decoder.next (&decoded));
+        QVERIFY (decoder.hasError());
+        QVERIFY (!decoder.next (&decoded));
+
+        decoder.reset();
+        QVERIFY (!decoder.hasError());
+        QCOMPARE (decoder.bufferedBytes(), 0);
+    }
+
+    void commandsAreApplied() {
+        Engine engine;
+        DriverStation* ds = engine.driverStation();
+        ds->setProtocolType (DriverStation::kFRC2015);
+        QVERIFY (ds->registerJoystick (6, 10, 1));
+        QVERIFY (ds->registerJoystick (6, 10, 1));
+
+        ControlServer server (ds);
+        server.apply (command (ControlDecoder::kTeam, 3794));
+        server.apply (command (ControlDecoder::kControlMode,
+                               DS::kControlAutonomous));
+        server.apply (joystickFrame());
+        QCOMPARE (server.appliedCommands(), quint64 (3));
+
+        QCOMPARE (ds->team(), 3794);
+        QCOMPARE (ds->controlMode(), DS::kControlAutonomous);
+
+        JoystickStore::Snapshot snapshot = ds->joystickStore()->snapshot();
+        const JoystickStore::State& joystick = snapshot.joysticks [1];
+        QCOMPARE ((int) joystick.axes [0], -128);
+        QCOMPARE ((int) joystick.povs [0], 270);
+
+        /* Buttons that the joystick does not have are dropped */
+        QCOMPARE (joystick.buttons, quint32 (0x1));
+
+        /* Out of range values are ignored */
+        server.apply (command (ControlDecoder::kControlMode, 9));
+        ControlDecoder::Command frame = joystickFrame();
+        frame.joystick = 5;
+        server.apply (frame);
+        QCOMPARE (server.ignoredCommands(), quint64 (2));
+        QCOMPARE (ds->controlMode(), DS::kControlAutonomous);
+    }
+
+    void commandsAreReceived() {
+        Engine engine;
+        ControlServer server (engine.driverStation());
+        QString name = QString ("LibDS_Test_Control_%1")
+                       .arg (QCoreApplication::applicationPid());
+        QVERIFY (server.listen (name));
+        QVERIFY (server.isListening());
+
+        QLocalSocket socket;
+        socket.connectToServer (name);
+        QVERIFY (socket.waitForConnected (1000));
+
+        socket.write (ControlDecoder::encode (command (ControlDecoder::kTeam, 1))
+                      + ControlDecoder::encode (command (ControlDecoder::kTeam, 2)));
+        QTRY_COMPARE (server.appliedCommands(), quint64 (2));
+        QCOMPARE (engine.driverStation()->team(), 2);
+
+        /* Clients that send garbage are disconnected */
+        socket.write (QByteArray::fromHex ("ff"));
+        QTRY_COMPARE (socket.state(), QLocalSocket::UnconnectedState);
+
+        server.close();
+        QVERIFY (!server.isListening());
+    }
+};
+
+#endif
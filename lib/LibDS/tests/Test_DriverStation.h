@@ -10,9 +10,97 @@
 #define TEST_DRIVERSTATION
 
 #include <QtTest>
+#include <Engine.h>
+#include <Utilities/Clock.h>
 
 class Test_DriverStation : public QObject {
     Q_OBJECT
+
+  private:
+    VirtualClock* m_clock;
+
+  private slots:
+    void init() {
+        m_clock = new VirtualClock;
+        Clock::setInstance (m_clock);
+    }
+
+    void cleanup() {
+        Clock::setInstance (Q_NULLPTR);
+        delete m_clock;
+    }
+
+    void urgentPacketsDuringLeadTime() {
+        Engine engine;
+        DriverStation* ds = engine.driverStation();
+        ds->setProtocolType (DriverStation::kFRC2015);
+        ds->setRobotPacketLeadTime (5);
+
+        step (&engine, 1000);
+        QList<int> sequences = robotSequences (&engine);
+        QCOMPARE (sequences, QList<int>() << 1);
+
+        /* The second packet is generated 5 ms before its deadline */
+        step (&engine, 1016);
+        QCOMPARE (engine.pendingPackets(), 0);
+
+        /* The urgent packet reuses the number of the pending packet instead
+         * of overtaking it with a newer number */
+        ds->setControlMode (DS::kControlAutonomous);
+        QCOMPARE (ds->urgentRobotPackets(), 1);
+        QCOMPARE (robotSequences (&engine), QList<int>() << 2);
+        sequences.append (2);
+
+        for (qint64 time = 1017; time <= 1050; ++time) {
+            step (&engine, time);
+            sequences.append (robotSequences (&engine));
+        }
+
+        /* The sequence numbers never go back, the pending packet is still
+         * sent at its deadline and the counters were not advanced */
+        for (int i = 1; i < sequences.count(); ++i)
+            QVERIFY (sequences.at (i) >= sequences.at (i - 1));
+
+        QVERIFY (sequences.count (2) >= 2);
+        QCOMPARE (sequences.last(), 3);
+    }
+
+    void roundTripUsesTheClock() {
+        Engine engine;
+        DriverStation* ds = engine.driverStation();
+        ds->setProtocolType (DriverStation::kFRC2015);
+
+        step (&engine, 1000);
+        QList<int> sequences = robotSequences (&engine);
+        QCOMPARE (sequences, QList<int>() << 1);
+
+        /* The robot echoes the sequence number 3 ms later */
+        m_clock->advance (3);
+        engine.receive (Engine::kRobot, QByteArray::fromHex ("0001"));
+        QCOMPARE (ds->metrics()->roundTripCount(), quint64 (1));
+        QCOMPARE (ds->metrics()->lastRoundTrip(), qint64 (3000));
+    }
+
+  private:
+    /* Moves the clock of the LibDS to the given time and steps the engine */
+    void step (Engine* engine, qint64 msecs) {
+        m_clock->advance (msecs - m_clock->elapsed());
+        engine->step (msecs);
+    }
+
+    QList<int> robotSequences (Engine* engine) {
+        int target;
+        QByteArray data;
+        QList<int> sequences;
+
+        while (engine->takePacket (&target, &data)) {
+            if (target == Engine::kRobot && data.size() >= 2)
+                sequences.append (((quint8) data.at (0) << 8)
+                                  | (quint8) data.at (1));
+        }
+
+        return sequences;
+    }
 };
 
 #endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_ENGINE
+#define TEST_ENGINE
+
+#include <QtTest>
+#include <Engine.h>
+#include <Engine_C.h>
+
+//==============================================================================
+// ENGINE TESTS
+//==============================================================================
+
+class Test_Engine : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void stepGeneratesPackets() {
+        Engine engine;
+        engine.driverStation()->setTeam (3794);
+        engine.driverStation()->setProtocolType (DriverStation::kFRC2015);
+
+        engine.step (1000);
+        QCOMPARE (engine.pendingPackets(), 1);
+
+        int target = -1;
+        QByteArray packet;
+        QVERIFY (engine.takePacket (&target, &packet));
+        QCOMPARE (target, int (Engine::kRobot));
+        QVERIFY (packet.size() >= 6);
+        QVERIFY (!engine.takePacket (&target, &packet));
+
+        /* The next robot packet is not due yet */
+        engine.step (1005);
+        QCOMPARE (engine.pendingPackets(), 0);
+
+        engine.step (1020);
+        QCOMPARE (engine.pendingPackets(), 1);
+    }
+
+    void receivedPacketsAreReported() {
+        Engine engine;
+        engine.driverStation()->setProtocolType (DriverStation::kFRC2015);
+        engine.step (1000);
+
+        engine.receive (Engine::kRobot, robotPacket());
+        int changes = engine.step (1010);
+        QVERIFY (changes & Engine::kRobotCommsChanged);
+        QVERIFY (changes & Engine::kCodeStatusChanged);
+        QVERIFY (changes & Engine::kVoltageChanged);
+        QVERIFY (engine.driverStation()->isConnectedToRobot());
+
+        /* Nothing changed since the last step */
+        engine.receive (Engine::kRobot, robotPacket());
+        QCOMPARE (engine.step (1020), 0);
+    }
+
+    void watchdogUsesStepTime() {
+        Engine engine;
+        engine.driverStation()->setProtocolType (DriverStation::kFRC2015);
+        engine.step (1000);
+        engine.receive (Engine::kRobot, robotPacket());
+        engine.step (1010);
+
+        /* The robot watchdog expires after one second without replies */
+        QCOMPARE (engine.step (1500) & Engine::kRobotCommsChanged, 0);
+        QVERIFY (engine.step (2100) & Engine::kRobotCommsChanged);
+        QVERIFY (!engine.driverStation()->isConnectedToRobot());
+    }
+
+    void cInterface() {
+        ds_engine* engine = ds_engine_create (DS_PROTOCOL_2015, 3794);
+        QVERIFY (engine != Q_NULLPTR);
+
+        ds_engine_step (engine, 1000);
+
+        int target = -1;
+        uint8_t small [2];
+        uint8_t buffer [1500];
+        int length = ds_engine_poll (engine, &target, small, sizeof (small));
+        QVERIFY (length < -2);
+
+        /* The packet is kept until it fits in the buffer */
+        QCOMPARE (ds_engine_poll (engine, &target, buffer, sizeof (buffer)),
+                  -length);
+        QCOMPARE (target, DS_TARGET_ROBOT);
+        QCOMPARE (ds_engine_poll (engine, &target, buffer, sizeof (buffer)), 0);
+
+        QByteArray reply = robotPacket();
+        ds_engine_receive (engine, DS_TARGET_ROBOT,
+                           reinterpret_cast<const uint8_t*> (reply.constData()),
+                           reply.size());
+        QVERIFY (ds_engine_step (engine, 1010) & DS_CHANGED_ROBOT_COMMS);
+        QCOMPARE (ds_engine_robot_connected (engine), 1);
+        QCOMPARE (ds_engine_robot_code (engine), 1);
+
+        ds_engine_destroy (engine);
+    }
+
+  private:
+    QByteArray robotPacket() {
+        QByteArray data;
+        data.append ((char) 0x00); /* Sequence */
+        data.append ((char) 0x01);
+        data.append ((char) 0x01); /* Comm. version */
+        data.append ((char) 0x00); /* Control */
+        data.append ((char) 0x20); /* Status (robot has code) */
+        data.append ((char) 0x0C); /* Voltage */
+        data.append ((char) 0x80);
+        data.append ((char) 0x00); /* Request */
+        return data;
+    }
+};
+
+#endif
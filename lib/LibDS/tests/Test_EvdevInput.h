@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_EVDEV_INPUT
+#define TEST_EVDEV_INPUT
+
+#include <QtTest>
+#include <DriverStation.h>
+#include <Core/EvdevInput.h>
+
+#if defined Q_OS_LINUX
+#include <unistd.h>
+#include <linux/input.h>
+#endif
+
+//==============================================================================
+// EVDEV INPUT TESTS
+//==============================================================================
+
+class Test_EvdevInput : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase() {
+        ds = DriverStation::getInstance();
+        ds->setProtocolType (DriverStation::kFRC2015);
+        ds->resetJoysticks();
+
+        input = new EvdevInput (ds);
+        input->setAutoDetect (false);
+        input->start();
+    }
+
+    void injectedDevice() {
+#if defined Q_OS_LINUX
+        int fds [2];
+        QVERIFY (pipe (fds) == 0);
+
+        /* The joystick is registered in our thread */
+        QVERIFY (input->addDevice (fds [0], 2, 4, 1));
+        QTRY_COMPARE (input->joystickId (0), 0);
+        QCOMPARE (ds->joystickCount(), 1);
+
+        /* Events are written to the store by the input thread */
+        sendEvent (fds [1], EV_ABS, ABS_X, 32767);
+        sendEvent (fds [1], EV_KEY, BTN_JOYSTICK + 2, 1);
+        sendEvent (fds [1], EV_ABS, ABS_HAT0X, 1);
+        sendEvent (fds [1], EV_ABS, ABS_HAT0Y, -1);
+
+        QTRY_COMPARE ((int) povAngle(), 45);
+        JoystickStore::Snapshot snapshot = ds->joystickStore()->snapshot();
+        QCOMPARE ((int) snapshot.joysticks [0].axes [0], 127);
+        QCOMPARE (snapshot.joysticks [0].buttons, quint32 (0x04));
+
+        /* Closing the pipe is the same as unplugging the device */
+        close (fds [1]);
+        QTRY_COMPARE (ds->joystickCount(), 0);
+        QCOMPARE (input->joystickId (0), -1);
+#else
+        QSKIP ("evdev is only available on Linux");
+#endif
+    }
+
+    void idsFollowRemovals() {
+#if defined Q_OS_LINUX
+        int fds [2];
+        QVERIFY (pipe (fds) == 0);
+
+        /* The device is registered after another joystick */
+        QVERIFY (ds->registerJoystick (1, 1, 0));
+        QVERIFY (input->addDevice (fds [0], 2, 4, 1));
+        QTRY_COMPARE (input->joystickId (0), 1);
+
+        /* Removing the first joystick moves the device down */
+        ds->removeJoystick (0);
+        QCOMPARE (input->joystickId (0), 0);
+
+        sendEvent (fds [1], EV_ABS, ABS_HAT0X, 1);
+        sendEvent (fds [1], EV_ABS, ABS_HAT0Y, -1);
+        QTRY_COMPARE ((int) povAngle(), 45);
+
+        /* Removing the joystick of the device stops its writes */
+        ds->removeJoystick (0);
+        QCOMPARE (input->joystickId (0), -1);
+        QCOMPARE (ds->joystickCount(), 0);
+
+        close (fds [1]);
+#else
+        QSKIP ("evdev is only available on Linux");
+#endif
+    }
+
+    void cleanupTestCase() {
+        input->stop();
+        delete input;
+    }
+
+  private:
+    int povAngle() {
+        return ds->joystickStore()->snapshot().joysticks [0].povs [0];
+    }
+
+#if defined Q_OS_LINUX
+    void sendEvent (int fd, int type, int code, int value) {
+        struct input_event event;
+        memset (&event, 0, sizeof (event));
+        event.type = type;
+        event.code = code;
+        event.value = value;
+
+        QCOMPARE (write (fd, &event, sizeof (event)), (ssize_t) sizeof (event));
+    }
+#endif
+
+    DriverStation* ds;
+    EvdevInput* input;
+};
+
+#endif
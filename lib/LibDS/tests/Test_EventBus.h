@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_EVENT_BUS
+#define TEST_EVENT_BUS
+
+#include <QtTest>
+#include <Core/EventBus.h>
+#include <Utilities/SpscQueue.h>
+
+//==============================================================================
+// EVENT BUS TESTS
+//==============================================================================
+
+/**
+ * Counts the notifications of a subscriber without reading its events, so
+ * that the tests decide when the events are read
+ */
+class EventCounter : public QObject {
+    Q_OBJECT
+
+  public:
+    EventCounter() : notifications (0) {}
+    int notifications;
+
+  public slots:
+    void notify() {
+        ++notifications;
+    }
+};
+
+class Test_EventBus : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void queueIsBounded() {
+        SpscQueue<int, 4> queue;
+        for (int i = 0; i < 4; ++i)
+            QVERIFY (queue.push (i));
+
+        QVERIFY (!queue.push (4));
+        QCOMPARE (queue.size(), 4u);
+
+        int item = -1;
+        QVERIFY (queue.pop (&item));
+        QCOMPARE (item, 0);
+        QVERIFY (queue.push (4));
+
+        for (int i = 1; i <= 4; ++i) {
+            QVERIFY (queue.pop (&item));
+            QCOMPARE (item, i);
+        }
+
+        QVERIFY (!queue.pop (&item));
+        QVERIFY (queue.isEmpty());
+    }
+
+    void eventsAreFiltered() {
+        EventBus bus;
+        EventCounter counter;
+        EventBus::Subscription subscriber =
+            bus.subscribe (EventBus::mask (EventBus::kTeam), &counter, "notify()");
+        QVERIFY (!subscriber.isNull());
+
+        bus.publish (EventBus::kVoltage, 12.5);
+        QCOMPARE (counter.notifications, 0);
+
+        bus.publish (EventBus::kTeam, 3794);
+        bus.publish (EventBus::kTeam, 254);
+        QCOMPARE (counter.notifications, 1);
+
+        EventBus::Event event;
+        QVERIFY (subscriber->next (&event));
+        QCOMPARE (event.type, int (EventBus::kTeam));
+        QCOMPARE (event.value, 3794);
+        QVERIFY (subscriber->next (&event));
+        QCOMPARE (event.value, 254);
+        QVERIFY (!subscriber->next (&event));
+
+        /* The subscriber is notified again once it has read every event */
+        bus.publish (EventBus::kTeam, 1);
+        QCOMPARE (counter.notifications, 2);
+    }
+
+    void realValuesAreKept() {
+        EventBus bus;
+        EventCounter counter;
+        EventBus::Subscription subscriber =
+            bus.subscribe (EventBus::ALL_EVENTS, &counter, "notify()");
+
+        bus.publish (EventBus::kVoltage, 12.34);
+
+        EventBus::Event event;
+        QVERIFY (subscriber->next (&event));
+        QCOMPARE (event.real, 12.34);
+        QCOMPARE (event.value, 12);
+    }
+
+    void slowSubscribersAreCoalesced() {
+        EventBus bus;
+        EventCounter counter;
+        EventBus::Subscription subscriber =
+            bus.subscribe (EventBus::ALL_EVENTS, &counter, "notify()");
+
+        for (int i = 0; i < 100; ++i)
+            bus.publish (EventBus::kCpuUsage, i);
+
+        bus.publish (EventBus::kTeam, 3794);
+        QVERIFY (subscriber->coalescedEvents() > 0);
+
+        /* The values are read in order and end with the latest ones */
+        int last = -1;
+        int team = 0;
+        EventBus::Event event;
+        while (subscriber->next (&event)) {
+            if (event.type == EventBus::kCpuUsage) {
+                QVERIFY (event.value > last);
+                last = event.value;
+            }
+
+            else if (event.type == EventBus::kTeam)
+                team = event.value;
+        }
+
+        QCOMPARE (last, 99);
+        QCOMPARE (team, 3794);
+    }
+
+    void coalescedValuesArePaired() {
+        EventBus bus;
+        EventCounter counter;
+        EventBus::Subscription subscriber =
+            bus.subscribe (EventBus::ALL_EVENTS, &counter, "notify()");
+
+        for (int i = 0; i < 100; ++i)
+            bus.publish (EventBus::kVoltage, 10 + i * 0.1);
+
+        /* The integer and real values of each event match */
+        EventBus::Event event;
+        while (subscriber->next (&event)) {
+            QCOMPARE (event.type, int (EventBus::kVoltage));
+            QCOMPARE (event.value, qRound (event.real));
+        }
+
+        QVERIFY (subscriber->coalescedEvents() > 0);
+        QVERIFY (qAbs (event.real - 19.9) < 0.001);
+    }
+
+    void subscribersCanBeRemoved() {
+        EventBus bus;
+        EventCounter counter;
+        EventBus::Subscription subscriber =
+            bus.subscribe (EventBus::ALL_EVENTS, &counter, "notify()");
+        QVERIFY (bus.subscribe (EventBus::ALL_EVENTS, &counter, "none()").isNull());
+
+        bus.unsubscribe (subscriber);
+        bus.publish (EventBus::kTeam, 3794);
+
+        EventBus::Event event;
+        QCOMPARE (counter.notifications, 0);
+        QVERIFY (!subscriber->next (&event));
+    }
+};
+
+#endif
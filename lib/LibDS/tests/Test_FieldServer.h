@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_FIELD_SERVER
+#define TEST_FIELD_SERVER
+
+#include <QtTest>
+#include <FieldServer.h>
+
+//==============================================================================
+// FIELD SERVER TESTS
+//==============================================================================
+
+class Test_FieldServer : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase() {
+        QVERIFY (station.bind (QHostAddress::LocalHost, 11200));
+
+        server.setFrequency (50);
+        server.setStation (1, 3794, QHostAddress (QHostAddress::LocalHost));
+        QVERIFY (server.start (11600, 11200));
+    }
+
+    void sendsStationPackets() {
+        QByteArray data = readPacket();
+
+        QCOMPARE (data.size(), 22);
+        QCOMPARE ((int) data.at (5), 1);
+        QCOMPARE ((quint8) data.at (3) & 0x04, 0);
+    }
+
+    void enablesRobotsDuringMatch() {
+        server.startMatch();
+        QCOMPARE (server.matchPhase(), FieldServer::kAutonomous);
+
+        QByteArray data = readPacket();
+        QCOMPARE ((quint8) data.at (3) & 0x06, 0x06);
+
+        server.setBypassed (1, true);
+        data = readPacket();
+        QCOMPARE ((quint8) data.at (3) & 0x04, 0);
+
+        server.setBypassed (1, false);
+        server.abortMatch();
+        QCOMPARE (server.matchPhase(), FieldServer::kPostMatch);
+    }
+
+    void readsStationStatus() {
+        QByteArray data;
+        data.append (static_cast<char> (0x00));
+        data.append (static_cast<char> (0x01));
+        data.append (static_cast<char> (0x00));
+        data.append (static_cast<char> (0x20));
+        data.append (static_cast<char> (3794 >> 8));
+        data.append (static_cast<char> (3794 & 0xff));
+        data.append (static_cast<char> (12));
+        data.append (static_cast<char> (50));
+
+        QSignalSpy spy (&server, SIGNAL (stationStatusChanged (int)));
+        station.writeDatagram (data, QHostAddress::LocalHost, 11600);
+        QVERIFY (spy.wait (1000));
+
+        FieldServer::StationStatus status = server.stationStatus (1);
+        QVERIFY (status.connected);
+        QCOMPARE (status.received, quint64 (1));
+        QCOMPARE (status.voltage, 12.5);
+    }
+
+    void cleanupTestCase() {
+        server.stop();
+    }
+
+  private:
+    QByteArray readPacket() {
+        station.waitForReadyRead (1000);
+        while (station.hasPendingDatagrams() && station.pendingDatagramSize() > 0) {
+            QByteArray data;
+            data.resize (station.pendingDatagramSize());
+            station.readDatagram (data.data(), data.size());
+
+            if (!station.hasPendingDatagrams())
+                return data;
+        }
+
+        return QByteArray();
+    }
+
+    FieldServer server;
+    QUdpSocket station;
+};
+
+#endif
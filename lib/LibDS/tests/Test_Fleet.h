@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_FLEET
+#define TEST_FLEET
+
+#include <QtTest>
+#include <Fleet.h>
+
+//==============================================================================
+// FLEET TESTS
+//==============================================================================
+
+class Test_Fleet : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase() {
+        first = fleet.createEngine ("Robot 1");
+        second = fleet.createEngine ("Robot 2");
+
+        QVERIFY (first != Q_NULLPTR);
+        QVERIFY (second != Q_NULLPTR);
+        QVERIFY (first != second);
+        QCOMPARE (fleet.engineCount(), 2);
+    }
+
+    void enginesShareNetworkThread() {
+        QVERIFY (first->thread() != QThread::currentThread());
+        QVERIFY (first->thread() == second->thread());
+    }
+
+    void enginesAreIndependent() {
+        QMetaObject::invokeMethod (first, "setTeam",
+                                   Qt::BlockingQueuedConnection,
+                                   Q_ARG (int, 3794));
+        QMetaObject::invokeMethod (second, "setTeam",
+                                   Qt::BlockingQueuedConnection,
+                                   Q_ARG (int, 254));
+
+        QCOMPARE (first->team(), 3794);
+        QCOMPARE (second->team(), 254);
+    }
+
+    void destroyEngine() {
+        fleet.destroyEngine (second);
+        QCOMPARE (fleet.engineCount(), 1);
+        QCOMPARE (fleet.engine (0), first);
+    }
+
+  private:
+    Fleet fleet;
+    DriverStation* first;
+    DriverStation* second;
+};
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_HISTOGRAM
+#define TEST_HISTOGRAM
+
+#include <QtTest>
+#include <Utilities/Histogram.h>
+
+//==============================================================================
+// HISTOGRAM TESTS
+//==============================================================================
+
+class Test_Histogram : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void emptyHistogram() {
+        Histogram histogram;
+        QCOMPARE (histogram.count(), quint64 (0));
+        QCOMPARE (histogram.percentile (99), qint64 (0));
+        QCOMPARE (histogram.mean(), qreal (0));
+    }
+
+    void smallValuesAreExact() {
+        Histogram histogram;
+        for (int i = 0; i < 8; ++i)
+            histogram.record (i);
+
+        QCOMPARE (histogram.min(), qint64 (0));
+        QCOMPARE (histogram.max(), qint64 (7));
+        QCOMPARE (histogram.percentile (50), qint64 (3));
+        QCOMPARE (histogram.percentile (100), qint64 (7));
+    }
+
+    void percentiles() {
+        Histogram histogram;
+        for (int i = 1; i <= 1000; ++i)
+            histogram.record (i);
+
+        QCOMPARE (histogram.count(), quint64 (1000));
+        QCOMPARE (histogram.mean(), 500.5);
+
+        /* Log-linear buckets keep the error under 12.5% */
+        qint64 p50 = histogram.percentile (50);
+        qint64 p99 = histogram.percentile (99);
+        QVERIFY (p50 >= 500 && p50 <= 500 * 1.125);
+        QVERIFY (p99 >= 990 && p99 <= 1000);
+        QCOMPARE (histogram.percentile (100), qint64 (1000));
+    }
+
+    void largeAndNegativeValues() {
+        Histogram histogram;
+        histogram.record (-5);
+        histogram.record (Q_INT64_C (0x7FFFFFFFFFFFFFFF));
+
+        QCOMPARE (histogram.min(), qint64 (0));
+        QCOMPARE (histogram.percentile (100), histogram.max());
+
+        histogram.reset();
+        QCOMPARE (histogram.count(), quint64 (0));
+    }
+};
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_IMPAIRMENT
+#define TEST_IMPAIRMENT
+
+#include <QtTest>
+#include <Core/Sockets.h>
+#include <Core/Impairment.h>
+#include <Utilities/Clock.h>
+
+//==============================================================================
+// IMPAIRMENT TESTS
+//==============================================================================
+
+class Test_Impairment : public QObject {
+    Q_OBJECT
+
+  private:
+    VirtualClock* m_clock;
+
+    /**
+     * Sends \a count numbered packets through a stage with the given
+     * \a settings and returns the numbers of the packets that went through
+     */
+    static QList<int> survivors (const Impairment::Settings& settings,
+                                 int count) {
+        Impairment stage (Transport::kRobot);
+        stage.setSettings (settings);
+
+        QSignalSpy spy (&stage, SIGNAL (packetReady (int, QByteArray)));
+        for (int i = 0; i < count; ++i)
+            stage.process (QByteArray::number (i));
+
+        QList<int> numbers;
+        for (int i = 0; i < spy.count(); ++i)
+            numbers.append (spy.at (i).at (1).toByteArray().toInt());
+
+        return numbers;
+    }
+
+  private slots:
+    void init() {
+        m_clock = new VirtualClock;
+        Clock::setInstance (m_clock);
+    }
+
+    void cleanup() {
+        Clock::setInstance (Q_NULLPTR);
+        delete m_clock;
+    }
+
+    void defaultsDoNotImpair() {
+        QCOMPARE (survivors (Impairment::Settings(), 100).count(), 100);
+    }
+
+    void lossIsReproducible() {
+        Impairment::Settings settings;
+        settings.lossRate = 0.3;
+        settings.seed = 42;
+
+        QList<int> first = survivors (settings, 1000);
+        QCOMPARE (survivors (settings, 1000), first);
+        QVERIFY (first.count() > 650 && first.count() < 750);
+
+        settings.seed = 43;
+        QVERIFY (survivors (settings, 1000) != first);
+    }
+
+    void burstsAreLostTogether() {
+        Impairment::Settings settings;
+        settings.burstEnterRate = 0.02;
+        settings.burstExitRate = 0.25;
+        settings.seed = 1;
+
+        QList<int> numbers = survivors (settings, 5000);
+        QVERIFY (numbers.count() < 5000);
+
+        int longestBurst = 0;
+        for (int i = 1; i < numbers.count(); ++i)
+            longestBurst = qMax (longestBurst, numbers.at (i) - numbers.at (i - 1) - 1);
+
+        QVERIFY (longestBurst >= 4);
+    }
+
+    void packetsAreDelayed() {
+        Impairment::Settings settings;
+        settings.delay = 100;
+        settings.jitter = 20;
+
+        Impairment stage (Transport::kRobot);
+        stage.setSettings (settings);
+        QSignalSpy spy (&stage, SIGNAL (packetReady (int, QByteArray)));
+
+        for (int i = 0; i < 50; ++i)
+            stage.process ("packet");
+
+        m_clock->advance (79);
+        QCOMPARE (spy.count(), 0);
+        QCOMPARE (stage.pendingPackets(), 50);
+
+        m_clock->advance (41);
+        QCOMPARE (spy.count(), 50);
+        QCOMPARE (spy.at (0).at (0).toInt(), int (Transport::kRobot));
+    }
+
+    void reorderedPacketsSkipTheDelay() {
+        Impairment::Settings settings;
+        settings.delay = 100;
+        settings.reorderRate = 0.5;
+        settings.seed = 7;
+
+        Impairment stage (Transport::kRobot);
+        stage.setSettings (settings);
+        QSignalSpy spy (&stage, SIGNAL (packetReady (int, QByteArray)));
+
+        for (int i = 0; i < 100; ++i)
+            stage.process ("packet");
+
+        quint64 reordered = stage.statistics().reordered;
+        QVERIFY (reordered > 0 && reordered < 100);
+        QCOMPARE (quint64 (spy.count()), reordered);
+
+        m_clock->advance (100);
+        QCOMPARE (spy.count(), 100);
+    }
+
+    void undelayedPacketsAreNotReordered() {
+        Impairment::Settings settings;
+        settings.reorderRate = 1;
+
+        Impairment stage (Transport::kRobot);
+        stage.setSettings (settings);
+
+        for (int i = 0; i < 10; ++i)
+            stage.process ("packet");
+
+        QCOMPARE (stage.statistics().reordered, quint64 (0));
+    }
+
+    void packetsAreDuplicated() {
+        Impairment::Settings settings;
+        settings.duplicateRate = 1;
+
+        QCOMPARE (survivors (settings, 10).count(), 20);
+    }
+
+    void bandwidthIsCapped() {
+        Impairment::Settings settings;
+        settings.bandwidth = 1000;
+
+        Impairment stage (Transport::kRobot);
+        stage.setSettings (settings);
+        QSignalSpy spy (&stage, SIGNAL (packetReady (int, QByteArray)));
+
+        for (int i = 0; i < 10; ++i)
+            stage.process (QByteArray (100, 'x'));
+
+        QCOMPARE (spy.count(), 0);
+        m_clock->advance (999);
+        QCOMPARE (spy.count(), 9);
+        m_clock->advance (1);
+        QCOMPARE (spy.count(), 10);
+    }
+
+    void socketsImpairBothDirections() {
+        Sockets sockets;
+        LoopbackTransport local;
+        LoopbackTransport remote;
+        LoopbackTransport::connectPair (&local, &remote);
+        sockets.setTransport (&local);
+
+        Impairment::Settings settings;
+        settings.lossRate = 1;
+        sockets.setImpairment (Transport::kRobot, settings);
+
+        for (int i = 0; i < 10; ++i)
+            sockets.sendToRobot ("robot");
+
+        sockets.sendToFMS ("fms");
+        QCOMPARE (remote.pendingPackets(), 1);
+        QCOMPARE (sockets.outgoingImpairment (Transport::kRobot)->statistics().dropped,
+                  quint64 (10));
+
+        QSignalSpy spy (&sockets, SIGNAL (robotPacketReceived (QByteArray)));
+        remote.send (Transport::kRobot, "reply");
+        local.deliverPending();
+        QCOMPARE (spy.count(), 0);
+
+        sockets.clearImpairment (Transport::kRobot);
+        QVERIFY (!sockets.outgoingImpairment (Transport::kRobot));
+
+        remote.send (Transport::kRobot, "reply");
+        local.deliverPending();
+        QCOMPARE (spy.count(), 1);
+    }
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_JOYSTICK_ENCODING
+#define TEST_JOYSTICK_ENCODING
+
+#include <QtTest>
+#include <Protocols/FRC_2014.h>
+#include <Protocols/FRC_2015.h>
+
+//==============================================================================
+// HELPER CLASSES
+//==============================================================================
+
+class EncodingFRC_2014 : public FRC_2014 {
+  public:
+    using FRC_2014::getJoystickData;
+};
+
+class EncodingFRC_2015 : public FRC_2015 {
+  public:
+    using FRC_2015::getJoystickData;
+    int maxButtonCount() {
+        return JoystickStore::MAX_BUTTONS;
+    }
+};
+
+//==============================================================================
+// JOYSTICK ENCODING TESTS
+//==============================================================================
+
+class Test_JoystickEncoding : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase() {
+        DriverStation* ds = DriverStation::getInstance();
+        frc2014.attach (ds, DS_Config::getInstance());
+        frc2015.attach (ds, DS_Config::getInstance());
+
+        /* Worst case: every joystick with every button pressed */
+        store = ds->joystickStore();
+        store->reset();
+        for (int i = 0; i < JoystickStore::MAX_JOYSTICKS; ++i) {
+            store->addJoystick (JoystickStore::MAX_AXES,
+                                JoystickStore::MAX_BUTTONS, 1);
+
+            for (int button = 0; button < JoystickStore::MAX_BUTTONS; ++button)
+                store->setButton (i, button, true);
+        }
+
+        /* The 2015 protocol does not send joysticks during the first packets */
+        for (int i = 0; i < 6; ++i)
+            frc2015.generateRobotPacket();
+    }
+
+    void frc2014Buttons() {
+        QByteArray data = frc2014.getJoystickData();
+        QCOMPARE (data.size(), frc2014.maxJoystickCount() * 8);
+        QCOMPARE ((quint8) data.at (6), quint8 (0xff));
+        QCOMPARE ((quint8) data.at (7), quint8 (0xff));
+    }
+
+    void frc2015Buttons() {
+        QByteArray data = frc2015.getJoystickData();
+        QCOMPARE (data.size(), JoystickStore::MAX_JOYSTICKS * 23);
+        QCOMPARE ((int) data.at (15), JoystickStore::MAX_BUTTONS);
+        QCOMPARE (data.mid (16, 4), QByteArray (4, (char) 0xff));
+
+        store->setButton (0, 31, false);
+        store->setButton (0, 0, false);
+        data = frc2015.getJoystickData();
+        QCOMPARE ((quint8) data.at (16), quint8 (0x7f));
+        QCOMPARE ((quint8) data.at (19), quint8 (0xfe));
+    }
+
+    void frc2014Benchmark() {
+        QBENCHMARK {
+            frc2014.getJoystickData();
+        }
+    }
+
+    void frc2015Benchmark() {
+        QBENCHMARK {
+            frc2015.getJoystickData();
+        }
+    }
+
+    void cleanupTestCase() {
+        store->reset();
+    }
+
+  private:
+    JoystickStore* store;
+    EncodingFRC_2014 frc2014;
+    EncodingFRC_2015 frc2015;
+};
+
+#endif
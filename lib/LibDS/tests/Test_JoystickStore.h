@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_JOYSTICK_STORE
+#define TEST_JOYSTICK_STORE
+
+#include <QtTest>
+#include <Core/JoystickStore.h>
+
+//==============================================================================
+// HELPER CLASSES
+//==============================================================================
+
+class JoystickStoreWriter : public QThread {
+  public:
+    JoystickStoreWriter (JoystickStore* store) : m_store (store) {}
+
+  protected:
+    void run() {
+        for (int i = 0; i < 20000; ++i) {
+            qreal value = (i % 2) ? 1 : -1;
+            for (int axis = 0; axis < JoystickStore::MAX_AXES; ++axis)
+                m_store->setAxis (0, axis, value);
+        }
+    }
+
+  private:
+    JoystickStore* m_store;
+};
+
+//==============================================================================
+// JOYSTICK STORE TESTS
+//==============================================================================
+
+class Test_JoystickStore : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void registration() {
+        JoystickStore store;
+        QVERIFY (store.addJoystick (6, 10, 1));
+        QVERIFY (store.addJoystick (100, 100, 100));
+        QCOMPARE (store.count(), 2);
+
+        JoystickStore::Snapshot snapshot = store.snapshot();
+        QCOMPARE ((int) snapshot.joysticks [0].numAxes, 6);
+        QCOMPARE ((int) snapshot.joysticks [0].numButtons, 10);
+        QCOMPARE ((int) snapshot.joysticks [0].povs [0], -1);
+        QCOMPARE ((int) snapshot.joysticks [1].numAxes, JoystickStore::MAX_AXES);
+        QCOMPARE ((int) snapshot.joysticks [1].numPOVs, JoystickStore::MAX_POVS);
+
+        while (store.count() < JoystickStore::MAX_JOYSTICKS)
+            QVERIFY (store.addJoystick (1, 1, 1));
+
+        QVERIFY (!store.addJoystick (1, 1, 1));
+    }
+
+    void values() {
+        JoystickStore store;
+        store.addJoystick (2, 12, 1);
+
+        store.setAxis (0, 0, 1);
+        store.setAxis (0, 1, -2);
+        store.setAxis (0, 2, 1);
+        store.setPOV (0, 0, 270);
+        store.setButton (0, 0, true);
+        store.setButton (0, 11, true);
+        store.setButton (0, 12, true);
+        store.setButton (3, 0, true);
+
+        JoystickStore::Snapshot snapshot = store.snapshot();
+        const JoystickStore::State& joystick = snapshot.joysticks [0];
+        QCOMPARE ((int) joystick.axes [0], 127);
+        QCOMPARE ((int) joystick.axes [1], -127);
+        QCOMPARE ((int) joystick.axes [2], 0);
+        QCOMPARE ((int) joystick.povs [0], 270);
+        QCOMPARE (joystick.buttons, quint32 (0x801));
+        QVERIFY (JoystickStore::isPressed (joystick, 11));
+        QVERIFY (!JoystickStore::isPressed (joystick, 12));
+
+        store.setButton (0, 0, false);
+        QCOMPARE (store.snapshot().joysticks [0].buttons, quint32 (0x800));
+    }
+
+    void frames() {
+        JoystickStore store;
+        store.addJoystick (2, 4, 1);
+
+        DS_SByte axes [JoystickStore::MAX_AXES] = { 100, -50, 25 };
+        qint16 povs [JoystickStore::MAX_POVS] = { 90, 180 };
+        store.setJoystick (0, axes, 0xff, povs);
+
+        JoystickStore::Snapshot snapshot = store.snapshot();
+        const JoystickStore::State& joystick = snapshot.joysticks [0];
+        QCOMPARE ((int) joystick.axes [0], 100);
+        QCOMPARE ((int) joystick.axes [1], -50);
+        QCOMPARE ((int) joystick.axes [2], 0);
+        QCOMPARE ((int) joystick.povs [0], 90);
+        QCOMPARE ((int) joystick.povs [1], -1);
+        QCOMPARE (joystick.buttons, quint32 (0xf));
+        QCOMPARE (joystick.version, quint32 (1));
+
+        /* Writing the same frame again is not a change */
+        store.setJoystick (0, axes, 0xf, povs);
+        QCOMPARE (store.snapshot().joysticks [0].version, quint32 (1));
+    }
+
+    void removal() {
+        JoystickStore store;
+        store.addJoystick (1, 0, 0);
+        store.addJoystick (2, 0, 0);
+        store.setAxis (1, 1, 1);
+
+        store.removeJoystick (0);
+        QCOMPARE (store.count(), 1);
+        QCOMPARE ((int) store.snapshot().joysticks [0].numAxes, 2);
+        QCOMPARE ((int) store.snapshot().joysticks [0].axes [1], 127);
+
+        store.reset();
+        QCOMPARE (store.count(), 0);
+    }
+
+    void timestamps() {
+        JoystickStore store;
+        store.addJoystick (1, 1, 0);
+
+        store.setAxis (0, 0, 1);
+        QCOMPARE (store.snapshot().joysticks [0].changeTime, qint64 (0));
+
+        /* Only the first unsent change is timestamped */
+        store.setTimestampsEnabled (true);
+        store.setAxis (0, 0, 0);
+        JoystickStore::Snapshot first = store.snapshot();
+        store.setButton (0, 0, true);
+        JoystickStore::Snapshot second = store.snapshot();
+
+        QVERIFY (first.joysticks [0].changeTime != 0);
+        QCOMPARE (second.joysticks [0].changeTime, first.joysticks [0].changeTime);
+        QVERIFY (second.joysticks [0].version > first.joysticks [0].version);
+
+        /* Values that do not change are not timestamped */
+        store.markSent (second);
+        store.setButton (0, 0, true);
+        QCOMPARE (store.snapshot().joysticks [0].changeTime, qint64 (0));
+    }
+
+    void changesAfterTheSnapshot() {
+        JoystickStore store;
+        store.addJoystick (1, 1, 0);
+        store.setTimestampsEnabled (true);
+
+        store.setAxis (0, 0, 1);
+        JoystickStore::Snapshot sent = store.snapshot();
+
+        /* The change that follows the snapshot keeps its own time, not the
+         * time at which the snapshot was sent */
+        qint64 before = JoystickStore::timestamp();
+        store.setAxis (0, 0, 0);
+        qint64 after = JoystickStore::timestamp();
+        store.setButton (0, 0, true);
+
+        QTest::qSleep (5);
+        store.markSent (sent);
+
+        qint64 changeTime = store.snapshot().joysticks [0].changeTime;
+        QVERIFY (changeTime >= before);
+        QVERIFY (changeTime <= after);
+    }
+
+    void consistentSnapshots() {
+        JoystickStore store;
+        store.addJoystick (JoystickStore::MAX_AXES, 0, 0);
+
+        JoystickStoreWriter writer (&store);
+        writer.start();
+
+        /* Every write changes all the axes, snapshots must never mix them */
+        JoystickStore::Snapshot snapshot;
+        while (!writer.isFinished()) {
+            store.snapshot (&snapshot);
+
+            const DS_SByte* axes = snapshot.joysticks [0].axes;
+            for (int axis = 1; axis < JoystickStore::MAX_AXES; ++axis) {
+                if (axes [axis] != axes [0])
+                    QFAIL ("Torn joystick snapshot");
+            }
+        }
+
+        writer.wait();
+    }
+};
+
+#endif
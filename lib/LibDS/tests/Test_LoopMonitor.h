@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_LOOP_MONITOR
+#define TEST_LOOP_MONITOR
+
+#include <QtTest>
+#include <Core/LoopMonitor.h>
+#include <Utilities/Clock.h>
+
+//==============================================================================
+// LOOP MONITOR TESTS
+//==============================================================================
+
+class Test_LoopMonitor : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void firstFireIsNotMeasured() {
+        LoopMonitor monitor;
+        monitor.mark (LoopMonitor::kRobotPackets);
+        QCOMPARE (monitor.intervals (LoopMonitor::kRobotPackets)->count(),
+                  quint64 (0));
+    }
+
+    void latenessIsMeasured() {
+        VirtualClock clock;
+        Clock::setInstance (&clock);
+
+        LoopMonitor monitor;
+        monitor.setPeriod (LoopMonitor::kRobotPackets, 5);
+
+        /* The loops are timed with the clock of the LibDS */
+        monitor.mark (LoopMonitor::kRobotPackets);
+        clock.advance (20);
+        monitor.mark (LoopMonitor::kRobotPackets);
+        Clock::setInstance (Q_NULLPTR);
+
+        const Histogram* intervals = monitor.intervals (LoopMonitor::kRobotPackets);
+        QCOMPARE (intervals->count(), quint64 (1));
+        QVERIFY (intervals->max() >= 20000);
+        QVERIFY (monitor.maxLateness (LoopMonitor::kRobotPackets) >= 15000);
+
+        /* Other loops are not affected */
+        QCOMPARE (monitor.maxLateness (LoopMonitor::kFMSPackets), qint64 (0));
+    }
+
+    void tickTimesAreUsed() {
+        LoopMonitor monitor;
+        monitor.setPeriod (LoopMonitor::kFMSPackets, 500);
+
+        /* A tick at time zero is a valid first fire */
+        monitor.mark (LoopMonitor::kFMSPackets, 0);
+        monitor.mark (LoopMonitor::kFMSPackets, 600000);
+
+        const Histogram* intervals = monitor.intervals (LoopMonitor::kFMSPackets);
+        QCOMPARE (intervals->count(), quint64 (1));
+        QCOMPARE (monitor.maxLateness (LoopMonitor::kFMSPackets),
+                  qint64 (100000));
+    }
+
+    void earlyFiresAreNotLate() {
+        LoopMonitor monitor;
+        monitor.setPeriod (LoopMonitor::kElapsedTime, 1000);
+        monitor.mark (LoopMonitor::kElapsedTime);
+        monitor.mark (LoopMonitor::kElapsedTime);
+        QCOMPARE (monitor.maxLateness (LoopMonitor::kElapsedTime), qint64 (0));
+    }
+
+    void periodChangeResets() {
+        LoopMonitor monitor;
+        monitor.mark (LoopMonitor::kRadioPackets);
+        monitor.mark (LoopMonitor::kRadioPackets);
+        monitor.setPeriod (LoopMonitor::kRadioPackets, 100);
+        QCOMPARE (monitor.intervals (LoopMonitor::kRadioPackets)->count(),
+                  quint64 (0));
+        QCOMPARE (monitor.period (LoopMonitor::kRadioPackets), 100);
+    }
+
+    void invalidLoops() {
+        LoopMonitor monitor;
+        monitor.mark (-1);
+        monitor.mark (LoopMonitor::LOOP_COUNT);
+        QVERIFY (monitor.intervals (LoopMonitor::LOOP_COUNT) == Q_NULLPTR);
+        QVERIFY (monitor.summary (-1).isEmpty());
+    }
+};
+
+#endif
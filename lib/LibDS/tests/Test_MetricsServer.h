@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_METRICS_SERVER
+#define TEST_METRICS_SERVER
+
+#include <QtTest>
+#include <QTcpSocket>
+#include <Core/Metrics.h>
+#include <Core/MetricsServer.h>
+
+//==============================================================================
+// METRICS SERVER TESTS
+//==============================================================================
+
+class Test_MetricsServer : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void countersAreRendered() {
+        Metrics metrics;
+        metrics.packetSent (Metrics::kRobot);
+        metrics.packetSent (Metrics::kRobot);
+        metrics.packetReceived (Metrics::kFMS);
+        metrics.watchdogExpired (Metrics::kRadio);
+        metrics.recordRoundTrip (1500);
+        metrics.setVoltage (12.5);
+
+        MetricsServer server;
+        server.addSource (&metrics);
+
+        QByteArray output = server.render();
+        QVERIFY (output.contains ("# TYPE ds_packets_sent_total counter\n"));
+        QVERIFY (output.contains ("ds_packets_sent_total{target=\"robot\"} 2\n"));
+        QVERIFY (output.contains ("ds_packets_received_total{target=\"fms\"} 1\n"));
+        QVERIFY (output.contains ("ds_watchdog_expirations_total{target=\"radio\"} 1\n"));
+        QVERIFY (output.contains ("ds_robot_rtt_seconds_count 1\n"));
+        QVERIFY (output.contains ("ds_robot_rtt_last_seconds 0.001500\n"));
+        QVERIFY (output.contains ("ds_robot_voltage_volts 12.500\n"));
+    }
+
+    void instancesAreLabeled() {
+        Metrics first;
+        Metrics second;
+        second.setPacketLoss (25);
+
+        MetricsServer server;
+        server.addSource (&first, "team1");
+        server.addSource (&second, "team2");
+
+        QByteArray output = server.render();
+        QVERIFY (output.contains ("ds_robot_packet_loss_percent{instance=\"team1\"} 0\n"));
+        QVERIFY (output.contains ("ds_robot_packet_loss_percent{instance=\"team2\"} 25\n"));
+
+        server.removeSource (&second);
+        QVERIFY (!server.render().contains ("team2"));
+    }
+
+    void answersHttpRequests() {
+        Metrics metrics;
+        metrics.packetSent (Metrics::kFMS);
+
+        MetricsServer server;
+        server.addSource (&metrics);
+        QVERIFY (server.listen (9487));
+        QVERIFY (server.isListening());
+
+        QTcpSocket socket;
+        socket.connectToHost (QHostAddress::LocalHost, 9487);
+        QVERIFY (socket.waitForConnected (1000));
+        socket.write ("GET /metrics HTTP/1.0\r\n\r\n");
+
+        QByteArray response;
+        QTRY_VERIFY (response.append (socket.readAll()).contains (
+                         "ds_packets_sent_total{target=\"fms\"} 1\n"));
+        QVERIFY (response.startsWith ("HTTP/1.0 200 OK\r\n"));
+
+        server.close();
+        QVERIFY (!server.isListening());
+    }
+
+    void rejectsOtherMethods() {
+        Metrics metrics;
+        MetricsServer server;
+        server.addSource (&metrics);
+        QVERIFY (server.listen (9488));
+
+        QTcpSocket socket;
+        socket.connectToHost (QHostAddress::LocalHost, 9488);
+        QVERIFY (socket.waitForConnected (1000));
+        socket.write ("POST /metrics HTTP/1.0\r\n\r\n");
+
+        QByteArray response;
+        QTRY_VERIFY (response.append (socket.readAll()).contains ("\r\n\r\n"));
+        QVERIFY (response.startsWith ("HTTP/1.0 405"));
+    }
+};
+
+#endif
@@ -34,11 +34,10 @@ class Test_NetConsoleSender : public QObject {
         });
 
         netconsole.sendMessage (message);
-        QTest::qWait (100);
     }
 
     void verifyMessage() {
-        QCOMPARE (received, message);
+        QTRY_COMPARE (received, message);
     }
 
   private:
@@ -68,11 +67,10 @@ class Test_NetConsoleReceiver : public QObject {
         });
 
         sender.writeDatagram (message.toUtf8(), QHostAddress::Broadcast, port);
-        QTest::qWait (100);
     }
 
     void verifyMessage() {
-        QCOMPARE (received, message);
+        QTRY_COMPARE (received, message);
     }
 
   private:
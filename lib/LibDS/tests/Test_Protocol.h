@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_PROTOCOL
+#define TEST_PROTOCOL
+
+#include <QtTest>
+#include <Protocols/FRC_2014.h>
+#include <Protocols/FRC_2015.h>
+
+//==============================================================================
+// PROTOCOL TESTS
+//==============================================================================
+
+class Test_Protocol : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void urgentPacketsKeepSequence() {
+        FRC_2015 protocol;
+        protocol.generateRobotPacket();
+        protocol.generateRobotPacket();
+
+        /* Urgent packets carry the number of the next periodic packet */
+        QByteArray urgent = protocol.generateUrgentRobotPacket();
+        QCOMPARE (protocol.sentRobotPackets(), 2);
+        QCOMPARE (protocol.sentRobotPacketsSinceConnect(), 2);
+        QCOMPARE (sequence (urgent), 3);
+
+        /* The periodic numbering is not disturbed */
+        QByteArray periodic = protocol.generateRobotPacket();
+        QCOMPARE (sequence (periodic), 3);
+        QCOMPARE (protocol.sentRobotPackets(), 3);
+    }
+
+    void pipelinedPacketsArePatched() {
+        DriverStation* ds = DriverStation::getInstance();
+        JoystickStore* store = ds->joystickStore();
+
+        FRC_2015 protocol;
+        protocol.attach (ds, DS_Config::getInstance());
+        store->reset();
+        store->addJoystick (2, 8, 1);
+
+        /* The 2015 protocol does not send joysticks during the first packets */
+        for (int i = 0; i < 6; ++i)
+            protocol.generateRobotPacket();
+
+        /* Generate the packet ahead of time, then change the joystick */
+        QByteArray packet = protocol.generateRobotPacket();
+        store->setAxis (0, 1, 0.5);
+        store->setButton (0, 3, true);
+        store->setPOV (0, 0, 90);
+
+        const char* buffer = packet.constData();
+        protocol.patchRobotPacket (&packet);
+
+        /* Header and counters are kept, the body has the latest values */
+        QCOMPARE (sequence (packet), 7);
+        QCOMPARE (protocol.sentRobotPackets(), 7);
+        QVERIFY (protocol.joysticksEncoded());
+        QCOMPARE (packet.mid (2),
+                  protocol.generateUrgentRobotPacket().mid (2));
+
+        /* The values were written in place */
+        QVERIFY (packet.constData() == buffer);
+
+        /* A new joystick changes the layout, so the data is encoded again */
+        store->addJoystick (1, 2, 0);
+        protocol.patchRobotPacket (&packet);
+        QCOMPARE (packet.mid (2),
+                  protocol.generateUrgentRobotPacket().mid (2));
+
+        store->reset();
+    }
+
+    void onlyPatchablePacketsArePipelined() {
+        FRC_2014 frc2014;
+        FRC_2015 frc2015;
+
+        /* 2014 packets carry a checksum of the whole packet */
+        QVERIFY (!frc2014.supportsRobotPacketPatching());
+        QVERIFY (frc2015.supportsRobotPacketPatching());
+    }
+
+    void urgentPacketsKeepProtocolState() {
+        DriverStation* ds = DriverStation::getInstance();
+        JoystickStore* store = ds->joystickStore();
+        store->reset();
+        store->addJoystick (2, 8, 1);
+
+        FRC_2014 protocol;
+        FRC_2014 reference;
+        protocol.attach (ds, DS_Config::getInstance());
+        reference.attach (ds, DS_Config::getInstance());
+
+        protocol.generateRobotPacket();
+        reference.generateRobotPacket();
+        JoystickStore::Snapshot sent = protocol.joystickSnapshot();
+
+        /* The snapshot of the last periodic packet is kept */
+        store->setAxis (0, 0, 1);
+        protocol.generateUrgentRobotPacket();
+        protocol.generateUrgentRobotPacket();
+        QVERIFY (protocol.joysticksEncoded());
+        QCOMPARE (protocol.joystickSnapshot().joysticks [0].version,
+                  sent.joysticks [0].version);
+
+        /* The periodic packets (and their checksums) are not disturbed */
+        QCOMPARE (protocol.generateRobotPacket(),
+                  reference.generateRobotPacket());
+
+        store->reset();
+    }
+
+  private:
+    int sequence (const QByteArray& data) {
+        return ((quint8) data.at (0) << 8) | (quint8) data.at (1);
+    }
+};
+
+#endif
@@ -10,7 +10,9 @@
 #define TEST_SOCKETS
 
 #include <QtTest>
+#include <QTcpServer>
 #include <Core/Sockets.h>
+#include <Core/SocketTuning.h>
 
 //==============================================================================
 // SOCKET SENDER TESTS (UDP)
@@ -21,26 +23,28 @@ class Test_SocketsSenderUDP : public QObject {
 
   private slots:
     void initTestCase() {
-        int fmsPort = 1160;
-        int radPort = 1140;
-        int robPort = 1110;
-
+        QHostAddress address (QHostAddress::LocalHost);
         testData = QByteArray ("@Ahead)Together!FRC^2016");
 
+        /* The receivers use ports chosen by the system */
+        QVERIFY (fmsReceiver.bind (address, 0));
+        QVERIFY (radReceiver.bind (address, 0));
+        QVERIFY (robReceiver.bind (address, 0));
+
         sockets.setFMSSocketType (DS::kSocketTypeUDP);
         sockets.setRadioSocketType (DS::kSocketTypeUDP);
         sockets.setRobotSocketType (DS::kSocketTypeUDP);
 
+        sockets.setFMSAddress (address);
+        sockets.setRadioAddress (address);
+        sockets.setRobotAddress (address);
+
         sockets.setFMSInputPort (0);
         sockets.setRadioInputPort (0);
         sockets.setRobotInputPort (0);
-        sockets.setFMSOutputPort (fmsPort);
-        sockets.setRadioOutputPort (radPort);
-        sockets.setRobotOutputPort (robPort);
-
-        fmsReceiver.bind (DS_LISTENER, fmsPort, DS_BIND_MODE);
-        radReceiver.bind (DS_LISTENER, radPort, DS_BIND_MODE);
-        robReceiver.bind (DS_LISTENER, robPort, DS_BIND_MODE);
+        sockets.setFMSOutputPort (fmsReceiver.localPort());
+        sockets.setRadioOutputPort (radReceiver.localPort());
+        sockets.setRobotOutputPort (robReceiver.localPort());
 
         connect (&fmsReceiver, &QUdpSocket::readyRead, [ = ]() {
             fmsData = DS::readSocket (&fmsReceiver);
@@ -57,20 +61,18 @@ class Test_SocketsSenderUDP : public QObject {
         sockets.sendToFMS (testData);
         sockets.sendToRadio (testData);
         sockets.sendToRobot (testData);
-
-        QTest::qWait (100);
     }
 
     void checkFMS() {
-        QCOMPARE (fmsData, testData);
+        QTRY_COMPARE (fmsData, testData);
     }
 
     void checkRadio() {
-        QCOMPARE (radData, testData);
+        QTRY_COMPARE (radData, testData);
     }
 
     void checkRobot() {
-        QCOMPARE (robData, testData);
+        QTRY_COMPARE (robData, testData);
     }
 
   private:
@@ -94,13 +96,13 @@ class Test_SocketsSenderTCP : public QObject {
 
   private slots:
     void initTestCase() {
-        int fmsPort = 1120;
-        int radPort = 1130;
-        int robPort = 1150;
-
-        address = DS_LISTENER;
+        QHostAddress address (QHostAddress::LocalHost);
         testData = QByteArray ("Hello World");
 
+        QVERIFY (fmsServer.listen (address));
+        QVERIFY (radServer.listen (address));
+        QVERIFY (robServer.listen (address));
+
         sockets.setFMSSocketType (DS::kSocketTypeTCP);
         sockets.setRadioSocketType (DS::kSocketTypeTCP);
         sockets.setRobotSocketType (DS::kSocketTypeTCP);
@@ -109,56 +111,189 @@ class Test_SocketsSenderTCP : public QObject {
         sockets.setRadioAddress (address);
         sockets.setRobotAddress (address);
 
-        sockets.setFMSOutputPort (fmsPort);
-        sockets.setRadioOutputPort (radPort);
-        sockets.setRobotOutputPort (robPort);
-
-        fmsReceiver.connectToHost (address, fmsPort, QIODevice::ReadOnly);
-        radReceiver.connectToHost (address, radPort, QIODevice::ReadOnly);
-        robReceiver.connectToHost (address, robPort, QIODevice::ReadOnly);
-
-        connect (&fmsReceiver, &QUdpSocket::readyRead, [ = ]() {
-            fmsData = DS::readSocket (&fmsReceiver);
-        });
-
-        connect (&radReceiver, &QUdpSocket::readyRead, [ = ]() {
-            radData = DS::readSocket (&radReceiver);
-        });
-
-        connect (&robReceiver, &QUdpSocket::readyRead, [ = ]() {
-            robData = DS::readSocket (&robReceiver);
-        });
+        sockets.setFMSOutputPort (fmsServer.serverPort());
+        sockets.setRadioOutputPort (radServer.serverPort());
+        sockets.setRobotOutputPort (robServer.serverPort());
 
         sockets.sendToFMS (testData);
         sockets.sendToRadio (testData);
         sockets.sendToRobot (testData);
-
-        QTest::qWait (100);
     }
 
     void checkFMS() {
-        QCOMPARE (fmsData, testData);
+        checkStream (&fmsServer);
     }
 
     void checkRadio() {
-        QCOMPARE (radData, testData);
+        checkStream (&radServer);
     }
 
     void checkRobot() {
-        QCOMPARE (robData, testData);
+        checkStream (&robServer);
     }
 
   private:
-    Sockets sockets;
-    QHostAddress address;
-    QTcpSocket fmsReceiver;
-    QTcpSocket radReceiver;
-    QTcpSocket robReceiver;
+    void checkStream (QTcpServer* server) {
+        QTRY_VERIFY (server->hasPendingConnections());
+        QTcpSocket* stream = server->nextPendingConnection();
+        QVERIFY (stream);
+
+        int size = StreamFramer::HEADER_SIZE + testData.size();
+        QTRY_VERIFY (stream->bytesAvailable() >= size);
+        QByteArray data = DS::readSocket (stream);
+
+        /* The packet is prefixed with its length (16-bit, big endian) */
+        QCOMPARE (data.size(), size);
+        QCOMPARE (data.left (StreamFramer::HEADER_SIZE),
+                  QByteArray::fromHex ("000b"));
+
+        StreamFramer framer;
+        QList<QByteArray> frames = framer.append (data.constData(),
+                                                  data.size());
+        QCOMPARE (frames.count(), 1);
+        QCOMPARE (frames.first(), testData);
+    }
 
-    QByteArray fmsData;
-    QByteArray radData;
-    QByteArray robData;
+  private:
+    Sockets sockets;
+    QTcpServer fmsServer;
+    QTcpServer radServer;
+    QTcpServer robServer;
     QByteArray testData;
 };
 
+//==============================================================================
+// SOCKET LOOPBACK TESTS
+//==============================================================================
+
+class Test_SocketsLoopback : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void packetsReachThePeer() {
+        Sockets sockets;
+        LoopbackTransport local;
+        LoopbackTransport remote;
+        LoopbackTransport::connectPair (&local, &remote);
+        sockets.setTransport (&local);
+        QVERIFY (sockets.transport() == &local);
+
+        QSignalSpy spy (&remote, SIGNAL (packetReceived (int, QByteArray)));
+        sockets.sendToFMS ("fms");
+        sockets.sendToRadio ("radio");
+        sockets.sendToRobot ("robot");
+        sockets.sendToRobotNow ("urgent");
+        QCOMPARE (remote.pendingPackets(), 4);
+
+        /* Packets are delivered in order, with their target */
+        QCOMPARE (remote.deliverPending(), 4);
+        QCOMPARE (spy.count(), 4);
+        QCOMPARE (spy.at (0).at (0).toInt(), int (Transport::kFMS));
+        QCOMPARE (spy.at (0).at (1).toByteArray(), QByteArray ("fms"));
+        QCOMPARE (spy.at (1).at (0).toInt(), int (Transport::kRadio));
+        QCOMPARE (spy.at (2).at (0).toInt(), int (Transport::kRobot));
+        QCOMPARE (spy.at (3).at (1).toByteArray(), QByteArray ("urgent"));
+    }
+
+    void packetsReachTheProtocol() {
+        Sockets sockets;
+        LoopbackTransport local;
+        LoopbackTransport remote;
+        LoopbackTransport::connectPair (&local, &remote);
+        sockets.setTransport (&local);
+
+        QSignalSpy fms (&sockets, SIGNAL (fmsPacketReceived (QByteArray)));
+        QSignalSpy robot (&sockets, SIGNAL (robotPacketReceived (QByteArray)));
+
+        QByteArray reply ("reply");
+        remote.send (Transport::kRobot, reply);
+        remote.send (Transport::kFMS, "fms");
+
+        /* Delivery happens in the event loop of the receiving transport */
+        QCOMPARE (robot.count(), 0);
+        QTRY_COMPARE (robot.count(), 1);
+        QCOMPARE (fms.count(), 1);
+        QCOMPARE (robot.at (0).at (0).toByteArray(), reply);
+
+        /* The data is shared, not copied */
+        QCOMPARE (robot.at (0).at (0).toByteArray().constData(),
+                  reply.constData());
+    }
+
+    void peersAreUnlinked() {
+        LoopbackTransport first;
+        LoopbackTransport second;
+        LoopbackTransport* third = new LoopbackTransport;
+
+        /* A new pair replaces the previous peers of both transports */
+        LoopbackTransport::connectPair (&first, &second);
+        LoopbackTransport::connectPair (&first, third);
+        QVERIFY (first.peer() == third);
+        QVERIFY (!second.peer());
+
+        /* A destroyed peer no longer receives packets */
+        delete third;
+        QVERIFY (!first.peer());
+        first.send (Transport::kRobot, "robot");
+        QCOMPARE (second.pendingPackets(), 0);
+    }
+
+    void transportCanBeRemoved() {
+        Sockets sockets;
+        LoopbackTransport local;
+        LoopbackTransport remote;
+        LoopbackTransport::connectPair (&local, &remote);
+
+        sockets.setTransport (&local);
+        sockets.setTransport (Q_NULLPTR);
+        QVERIFY (!sockets.transport());
+
+        /* Without sockets or transport, packets go nowhere */
+        sockets.sendToRobot ("robot");
+        QCOMPARE (remote.pendingPackets(), 0);
+
+        QSignalSpy robot (&sockets, SIGNAL (robotPacketReceived (QByteArray)));
+        remote.send (Transport::kRobot, "robot");
+        local.deliverPending();
+        QCOMPARE (robot.count(), 0);
+    }
+};
+
+//==============================================================================
+// SOCKET TUNING TESTS
+//==============================================================================
+
+class Test_SocketTuning : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void lowLatencyReceiverKeepsReading() {
+        QUdpSocket receiver;
+        QVERIFY (receiver.bind (QHostAddress::LocalHost, 0));
+        SocketTuning::apply (&receiver, DS::kSocketProfileLowLatency, true);
+
+        quint32 drops = 0;
+        QList<QByteArray> received;
+        connect (&receiver, &QUdpSocket::readyRead, [&]() {
+            received.append (SocketTuning::readDatagrams (
+                                 &receiver, DS::kSocketProfileLowLatency,
+                                 &drops));
+        });
+
+        /* Each datagram is read in its own event loop iteration, so the
+         * socket must keep emitting readyRead() after the first read */
+        QUdpSocket sender;
+        for (int i = 0; i < 5; ++i) {
+            QByteArray data = QByteArray::number (i);
+            sender.writeDatagram (data, QHostAddress::LocalHost,
+                                  receiver.localPort());
+
+            QTRY_COMPARE (received.count(), i + 1);
+            QCOMPARE (received.last(), data);
+        }
+
+        QCOMPARE (drops, quint32 (0));
+    }
+};
+
 #endif
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_STAGE_TIMERS
+#define TEST_STAGE_TIMERS
+
+#include <QtTest>
+#include <Utilities/StageTimers.h>
+
+//==============================================================================
+// STAGE TIMERS TESTS
+//==============================================================================
+
+class Test_StageTimers : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void init() {
+        timers = StageTimers::getInstance();
+        timers->reset();
+    }
+
+    void recordKeepsTotalsAndMax() {
+        timers->record (StageTimers::kSendToRobot, 100);
+        timers->record (StageTimers::kSendToRobot, 300);
+        timers->record (StageTimers::kSendToRobot, 200);
+
+        QCOMPARE (timers->count (StageTimers::kSendToRobot), quint64 (3));
+        QCOMPARE (timers->total (StageTimers::kSendToRobot), quint64 (600));
+        QCOMPARE (timers->max (StageTimers::kSendToRobot), quint64 (300));
+        QCOMPARE (timers->count (StageTimers::kReadSocket), quint64 (0));
+    }
+
+    void scopeMeasuresElapsedTime() {
+        {
+            StageTimers::Scope timer (StageTimers::kReadSocket);
+            QTest::qSleep (5);
+        }
+
+        QCOMPARE (timers->count (StageTimers::kReadSocket), quint64 (1));
+        QVERIFY (timers->max (StageTimers::kReadSocket) >= 5000000);
+    }
+
+    void reenteredStagesAreMeasuredOnce() {
+        {
+            StageTimers::Scope outer (StageTimers::kConfigUpdates);
+            StageTimers::Scope inner (StageTimers::kConfigUpdates);
+            StageTimers::Scope fanOut (StageTimers::kSignalFanOut);
+        }
+
+        QCOMPARE (timers->count (StageTimers::kConfigUpdates), quint64 (1));
+        QCOMPARE (timers->count (StageTimers::kSignalFanOut), quint64 (1));
+
+        /* The stage can be measured again after the outer scope ends */
+        { StageTimers::Scope again (StageTimers::kConfigUpdates); }
+        QCOMPARE (timers->count (StageTimers::kConfigUpdates), quint64 (2));
+    }
+
+    void dumpListsEveryStage() {
+        QStringList lines = timers->dump().split ("\n");
+        QCOMPARE (lines.count(), StageTimers::STAGE_COUNT);
+        QVERIFY (lines.first().startsWith (StageTimers::stageName (0)));
+    }
+
+    void cleanupTestCase() {
+        timers->reset();
+    }
+
+  private:
+    StageTimers* timers;
+};
+
+#endif
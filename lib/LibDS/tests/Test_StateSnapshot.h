@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_STATE_SNAPSHOT
+#define TEST_STATE_SNAPSHOT
+
+#include <QtTest>
+#include <Core/StateSnapshot.h>
+
+//==============================================================================
+// HELPER CLASSES
+//==============================================================================
+
+/**
+ * Reads the snapshot while it is being published and counts the copies in
+ * which the values do not belong to the same state
+ */
+class StateSnapshotReader : public QThread {
+  public:
+    StateSnapshotReader (const StateSnapshot* snapshot) :
+        tornReads (0), versionDrops (0), m_snapshot (snapshot) {}
+
+    int tornReads;
+    int versionDrops;
+
+  protected:
+    void run() {
+        StateSnapshot::State state;
+        memset (&state, 0, sizeof (state));
+
+        for (int i = 0; i < 20000; ++i) {
+            quint64 previous = state.version;
+            m_snapshot->read (&state);
+
+            if (state.version < previous)
+                ++versionDrops;
+
+            if (state.team != state.packetLoss
+                    || state.team != state.sentRobotPackets)
+                ++tornReads;
+        }
+    }
+
+  private:
+    const StateSnapshot* m_snapshot;
+};
+
+//==============================================================================
+// STATE SNAPSHOT TESTS
+//==============================================================================
+
+class Test_StateSnapshot : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void versionsIncrease() {
+        StateSnapshot snapshot;
+        QCOMPARE (snapshot.version(), quint64 (0));
+
+        StateSnapshot::State state;
+        memset (&state, 0, sizeof (state));
+        state.version = 100;
+        state.team = 3794;
+        state.voltage = 12.5;
+        state.enableStatus = DS::kEnabled;
+
+        QCOMPARE (snapshot.publish (state), quint64 (1));
+        QCOMPARE (snapshot.publish (state), quint64 (2));
+        QCOMPARE (snapshot.version(), quint64 (2));
+
+        StateSnapshot::State copy = snapshot.read();
+        QCOMPARE (copy.version, quint64 (2));
+        QCOMPARE (copy.team, 3794);
+        QCOMPARE (copy.voltage, 12.5);
+        QCOMPARE (copy.enableStatus, DS::kEnabled);
+    }
+
+    void olderCopiesAreRefreshed() {
+        StateSnapshot snapshot;
+        StateSnapshot::State state;
+        memset (&state, 0, sizeof (state));
+        QVERIFY (!snapshot.readIfNewer (&state));
+
+        state.team = 1;
+        snapshot.publish (state);
+
+        StateSnapshot::State copy;
+        memset (&copy, 0, sizeof (copy));
+        QVERIFY (snapshot.readIfNewer (&copy));
+        QCOMPARE (copy.team, 1);
+        QVERIFY (!snapshot.readIfNewer (&copy));
+
+        state.team = 2;
+        snapshot.publish (state);
+        QVERIFY (snapshot.readIfNewer (&copy));
+        QCOMPARE (copy.team, 2);
+    }
+
+    void readersNeverSeeTornStates() {
+        StateSnapshot snapshot;
+        StateSnapshotReader reader (&snapshot);
+        reader.start();
+
+        StateSnapshot::State state;
+        memset (&state, 0, sizeof (state));
+        for (int i = 0; reader.isRunning(); ++i) {
+            state.team = i;
+            state.packetLoss = i;
+            state.sentRobotPackets = i;
+            snapshot.publish (state);
+        }
+
+        QVERIFY (reader.wait());
+        QCOMPARE (reader.tornReads, 0);
+        QCOMPARE (reader.versionDrops, 0);
+    }
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_STREAM_FRAMER
+#define TEST_STREAM_FRAMER
+
+#include <QtTest>
+#include <Utilities/StreamFramer.h>
+
+//==============================================================================
+// STREAM FRAMER TESTS
+//==============================================================================
+
+class Test_StreamFramer : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase() {
+        first = QByteArray ("@Ahead)Together!FRC^2016");
+        second = QByteArray (300, 'x');
+
+        StreamFramer sender;
+        QVERIFY (sender.enqueueFrame (first));
+        QVERIFY (sender.enqueueFrame (second));
+        QVERIFY (!sender.enqueueFrame (QByteArray (0x10000, 'y')));
+
+        stream = sender.takePendingFrames();
+        QVERIFY (!sender.hasPendingFrames());
+    }
+
+    void coalescedFrames() {
+        StreamFramer receiver;
+        QList<QByteArray> frames = receiver.append (stream.constData(),
+                                                    stream.size());
+
+        QCOMPARE (frames.count(), 2);
+        QCOMPARE (frames.at (0), first);
+        QCOMPARE (frames.at (1), second);
+        QCOMPARE (receiver.bufferedBytes(), 0);
+    }
+
+    void splitFrames() {
+        StreamFramer receiver;
+        QList<QByteArray> frames;
+
+        for (int i = 0; i < stream.size(); ++i)
+            frames.append (receiver.append (stream.constData() + i, 1));
+
+        QCOMPARE (frames.count(), 2);
+        QCOMPARE (frames.at (0), first);
+        QCOMPARE (frames.at (1), second);
+    }
+
+    void deviceReads() {
+        QBuffer device;
+        device.setData (stream + stream.left (5));
+        device.open (QIODevice::ReadOnly);
+
+        StreamFramer receiver;
+        QList<QByteArray> frames = receiver.read (&device);
+
+        QCOMPARE (frames.count(), 2);
+        QCOMPARE (receiver.bufferedBytes(), 5);
+
+        receiver.reset();
+        QCOMPARE (receiver.bufferedBytes(), 0);
+    }
+
+  private:
+    QByteArray first;
+    QByteArray second;
+    QByteArray stream;
+};
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_TELEMETRY_EXPORT
+#define TEST_TELEMETRY_EXPORT
+
+#include <QtTest>
+#include <Core/TelemetryExport.h>
+
+#if !defined Q_OS_WIN
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+//==============================================================================
+// TELEMETRY EXPORT TESTS
+//==============================================================================
+
+class Test_TelemetryExport : public QObject {
+    Q_OBJECT
+
+  private:
+    static QString uniqueKey (const char* name) {
+        return QString ("LibDS_Test_%1_%2")
+               .arg (name)
+               .arg (QCoreApplication::applicationPid());
+    }
+
+  private slots:
+    void readersSeePublishedValues() {
+        TelemetryExport writer;
+        QVERIFY (writer.create (uniqueKey ("values")));
+        QVERIFY (writer.isOwner());
+
+        TelemetryExport::Values values;
+        memset (&values, 0, sizeof (values));
+        values.millivolts = 12340;
+        values.robotCommStatus = 1;
+        values.packetLoss = 7;
+        values.roundTrip = 1500;
+        values.joystickCount = 1;
+        values.joysticks [0].numAxes = 2;
+        values.joysticks [0].axes [1] = -128;
+        values.joysticks [0].buttons = 0x5;
+        writer.publish (values);
+
+        TelemetryExport reader;
+        QVERIFY (reader.attach (uniqueKey ("values")));
+        QVERIFY (reader.isAttached());
+        QVERIFY (!reader.isOwner());
+
+        TelemetryExport::Values copy;
+        QVERIFY (reader.read (&copy));
+        QCOMPARE (copy.updates, quint64 (1));
+        QCOMPARE (copy.millivolts, 12340);
+        QCOMPARE (int (copy.robotCommStatus), 1);
+        QCOMPARE (int (copy.packetLoss), 7);
+        QCOMPARE (copy.roundTrip, qint64 (1500));
+        QCOMPARE (copy.joystickCount, quint32 (1));
+        QCOMPARE (int (copy.joysticks [0].numAxes), 2);
+        QCOMPARE (int (copy.joysticks [0].axes [1]), -128);
+        QCOMPARE (copy.joysticks [0].buttons, quint32 (0x5));
+
+        values.millivolts = 11000;
+        writer.publish (values);
+        QVERIFY (reader.read (&copy));
+        QCOMPARE (copy.updates, quint64 (2));
+        QCOMPARE (copy.millivolts, 11000);
+    }
+
+    void readersDoNotPublish() {
+        TelemetryExport writer;
+        QVERIFY (writer.create (uniqueKey ("readonly")));
+
+        TelemetryExport reader;
+        QVERIFY (reader.attach (uniqueKey ("readonly")));
+
+        TelemetryExport::Values values;
+        memset (&values, 0, sizeof (values));
+        values.millivolts = 9000;
+        reader.publish (values);
+
+        TelemetryExport::Values copy;
+        QVERIFY (reader.read (&copy));
+        QCOMPARE (copy.updates, quint64 (0));
+        QCOMPARE (copy.millivolts, 0);
+    }
+
+    void attachFailsWithoutBlock() {
+        TelemetryExport reader;
+        QVERIFY (!reader.attach (uniqueKey ("missing")));
+        QVERIFY (!reader.isAttached());
+
+        TelemetryExport::Values copy;
+        QVERIFY (!reader.read (&copy));
+    }
+
+    void joysticksAreCopied() {
+        JoystickStore store;
+        store.addJoystick (2, 8, 1);
+        store.setAxis (0, 1, 1);
+        store.setButton (0, 3, true);
+        store.setPOV (0, 0, 90);
+
+        TelemetryExport::Values values;
+        memset (&values, 0, sizeof (values));
+        TelemetryExport::copyJoysticks (store.snapshot(), &values);
+
+        QCOMPARE (values.joystickCount, quint32 (1));
+        QCOMPARE (int (values.joysticks [0].numAxes), 2);
+        QCOMPARE (int (values.joysticks [0].numButtons), 8);
+        QCOMPARE (int (values.joysticks [0].numPOVs), 1);
+        QCOMPARE (int (values.joysticks [0].axes [1]), 127);
+        QCOMPARE (values.joysticks [0].buttons, quint32 (0x8));
+        QCOMPARE (int (values.joysticks [0].povs [0]), 90);
+    }
+
+#if !defined Q_OS_WIN
+    void blockHasAPosixName() {
+        TelemetryExport writer;
+        QVERIFY (writer.create (uniqueKey ("posix")));
+
+        /* Programs that do not use Qt open the block by its name */
+        QByteArray name = "/" + uniqueKey ("posix").toUtf8();
+        int fd = shm_open (name.constData(), O_RDONLY, 0);
+        QVERIFY (fd != -1);
+        ::close (fd);
+
+        writer.close();
+        QVERIFY (shm_open (name.constData(), O_RDONLY, 0) == -1);
+    }
+#endif
+
+    void closeReleasesBlock() {
+        TelemetryExport writer;
+        QVERIFY (writer.create (uniqueKey ("close")));
+        writer.close();
+        QVERIFY (!writer.isOwner());
+        QVERIFY (writer.key().isEmpty());
+
+        TelemetryExport reader;
+        QVERIFY (!reader.attach (uniqueKey ("close")));
+    }
+};
+
+#endif
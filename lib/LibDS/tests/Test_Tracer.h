@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2016 Alex Spataru <alex_spataru@outlook.com>
+ *
+ * This file is part of the LibDS, which is released under the MIT license.
+ * For more information, please read the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef TEST_TRACER
+#define TEST_TRACER
+
+#include <thread>
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <Utilities/Tracer.h>
+
+//==============================================================================
+// TRACER TESTS
+//==============================================================================
+
+class Test_Tracer : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void init() {
+        tracer = Tracer::getInstance();
+        tracer->clear();
+    }
+
+    void cleanup() {
+        tracer->setEnabled (false);
+    }
+
+    void nothingIsRecordedWhenDisabled() {
+        tracer->setEnabled (false);
+        tracer->instant ("test", "Disabled event");
+        { Tracer::Span span ("test", "Disabled span"); }
+
+        QCOMPARE (events ("test").count(), 0);
+    }
+
+    void spansAndInstantsAreExported() {
+        tracer->setEnabled (true);
+        tracer->instant ("test", "Instant");
+        {
+            Tracer::Span span ("test", "Span");
+            QTest::qSleep (2);
+        }
+
+        QList<QJsonObject> list = events ("test");
+        QCOMPARE (list.count(), 2);
+        QCOMPARE (list.at (0).value ("ph").toString(), QString ("i"));
+        QCOMPARE (list.at (1).value ("ph").toString(), QString ("X"));
+        QCOMPARE (list.at (1).value ("name").toString(), QString ("Span"));
+        QVERIFY (list.at (1).value ("dur").toDouble() >= 2000);
+    }
+
+    void ringKeepsTheLatestEvents() {
+        tracer->setEnabled (true);
+        for (int i = 0; i < Tracer::RING_SIZE + 10; ++i)
+            tracer->instant ("test", "Overflow");
+
+        QCOMPARE (events ("test").count(), Tracer::RING_SIZE);
+    }
+
+    void threadsHaveTheirOwnRings() {
+        tracer->setEnabled (true);
+        tracer->instant ("test", "Main thread");
+
+        std::thread worker ([] {
+            Tracer::getInstance()->instant ("test", "Worker thread");
+        });
+        worker.join();
+
+        QList<QJsonObject> list = events ("test");
+        QCOMPARE (list.count(), 2);
+        QVERIFY (list.at (0).value ("tid") != list.at (1).value ("tid"));
+    }
+
+  private:
+    QList<QJsonObject> events (const QString& category) {
+        QJsonObject document = QJsonDocument::fromJson (tracer->exportJson())
+                               .object();
+
+        QList<QJsonObject> list;
+        foreach (const QJsonValue& value, document.value ("traceEvents").toArray()) {
+            if (value.toObject().value ("cat").toString() == category)
+                list.append (value.toObject());
+        }
+
+        return list;
+    }
+
+    Tracer* tracer;
+};
+
+#endif
@@ -11,9 +11,125 @@
 
 #include <QtTest>
 #include <Core/Watchdog.h>
+#include <Core/DS_Common.h>
+
+//==============================================================================
+// HELPER CLASSES
+//==============================================================================
+
+/**
+ * Reschedules itself with \c DS_Schedule, like the packet loops of the DS
+ */
+class PeriodicTask : public QObject {
+    Q_OBJECT
+
+  public:
+    PeriodicTask (int interval) : runs (0), m_interval (interval) {
+        DS_Schedule (m_interval, this, SLOT (run()));
+    }
+
+    int runs;
+    QList<qint64> times;
+
+  public slots:
+    void run() {
+        ++runs;
+        times.append (Clock::getInstance()->elapsed());
+        DS_Schedule (m_interval, this, SLOT (run()));
+    }
+
+  private:
+    int m_interval;
+};
+
+//==============================================================================
+// WATCHDOG TESTS
+//==============================================================================
 
 class Test_Watchdog : public QObject {
     Q_OBJECT
+
+  private:
+    VirtualClock* m_clock;
+
+  private slots:
+    void init() {
+        m_clock = new VirtualClock;
+        Clock::setInstance (m_clock);
+    }
+
+    void cleanup() {
+        Clock::setInstance (Q_NULLPTR);
+        delete m_clock;
+    }
+
+    void expiresAfterDeadline() {
+        Watchdog watchdog;
+        QSignalSpy spy (&watchdog, SIGNAL (expired()));
+        watchdog.setExpirationTime (1000);
+
+        m_clock->advance (999);
+        QCOMPARE (spy.count(), 0);
+
+        m_clock->advance (1);
+        QCOMPARE (spy.count(), 1);
+
+        /* The watchdog keeps expiring while it is not fed */
+        m_clock->advance (60 * 1000);
+        QCOMPARE (spy.count(), 61);
+    }
+
+    void resetPostponesExpiration() {
+        Watchdog watchdog;
+        QSignalSpy spy (&watchdog, SIGNAL (expired()));
+        watchdog.setExpirationTime (1000);
+
+        /* Feed the watchdog at 50 Hz for a whole match */
+        for (int i = 0; i < 150 * 50; ++i) {
+            m_clock->advance (20);
+            watchdog.reset();
+        }
+
+        QCOMPARE (spy.count(), 0);
+
+        /* Resets only move the deadline, a single check is pending */
+        QCOMPARE (m_clock->pendingTimers(), 1);
+
+        m_clock->advance (1000);
+        QCOMPARE (spy.count(), 1);
+    }
+
+    void externalClockUsesTicks() {
+        Watchdog watchdog;
+        QSignalSpy spy (&watchdog, SIGNAL (expired()));
+        watchdog.setExpirationTime (100);
+        watchdog.setExternalClock (true);
+
+        m_clock->advance (1000);
+        QCOMPARE (spy.count(), 0);
+
+        watchdog.tick (0);
+        watchdog.tick (99);
+        QCOMPARE (spy.count(), 0);
+        watchdog.tick (100);
+        QCOMPARE (spy.count(), 1);
+    }
+
+    void scheduledTasksKeepCadence() {
+        PeriodicTask task (20);
+
+        m_clock->advance (1000);
+        QCOMPARE (task.runs, 50);
+        QCOMPARE (task.times.first(), qint64 (20));
+        QCOMPARE (task.times.last(), qint64 (1000));
+        QCOMPARE (m_clock->elapsed(), qint64 (1000));
+    }
+
+    void virtualDateAdvances() {
+        QDateTime start = m_clock->currentDateTime();
+        m_clock->advance (90 * 1000);
+        QCOMPARE (start.secsTo (m_clock->currentDateTime()), qint64 (90));
+    }
 };
 
 #endif
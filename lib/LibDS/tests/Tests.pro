@@ -25,6 +25,15 @@
 QT += testlib
 TARGET = LibDS_Test
 
+#
+# The tests use every protocol and switch between them at runtime, so they
+# can only be built in the default configuration (without LIBDS_PROTOCOL)
+#
+
+!isEmpty (LIBDS_PROTOCOL) {
+    error ("The tests cannot be built with LIBDS_PROTOCOL=$$LIBDS_PROTOCOL")
+}
+
 include ($$PWD/../LibDS.pri)
 
 SOURCES += \
@@ -34,6 +43,24 @@ HEADERS += \
     $$PWD/Test_CRC32.h \
     $$PWD/Test_DriverStation.h \
     $$PWD/Test_DS_Config.h \
+    $$PWD/Test_Fleet.h \
+    $$PWD/Test_FieldServer.h \
+    $$PWD/Test_Histogram.h \
+    $$PWD/Test_LoopMonitor.h \
+    $$PWD/Test_StageTimers.h \
+    $$PWD/Test_Tracer.h \
+    $$PWD/Test_MetricsServer.h \
+    $$PWD/Test_Engine.h \
+    $$PWD/Test_TelemetryExport.h \
+    $$PWD/Test_ControlServer.h \
+    $$PWD/Test_EventBus.h \
+    $$PWD/Test_StateSnapshot.h \
+    $$PWD/Test_Impairment.h \
+    $$PWD/Test_JoystickStore.h \
+    $$PWD/Test_JoystickEncoding.h \
+    $$PWD/Test_EvdevInput.h \
     $$PWD/Test_NetConsole.h \
     $$PWD/Test_Sockets.h \
+    $$PWD/Test_StreamFramer.h \
+    $$PWD/Test_Protocol.h \
     $$PWD/Test_Watchdog.h
@@ -7,25 +7,62 @@
  */
 
 #include "Test_CRC32.h"
+#include "Test_Fleet.h"
+#include "Test_Histogram.h"
+#include "Test_LoopMonitor.h"
+#include "Test_StageTimers.h"
+#include "Test_Tracer.h"
+#include "Test_MetricsServer.h"
+#include "Test_Engine.h"
+#include "Test_TelemetryExport.h"
+#include "Test_ControlServer.h"
+#include "Test_EventBus.h"
+#include "Test_StateSnapshot.h"
+#include "Test_Impairment.h"
+#include "Test_FieldServer.h"
+#include "Test_EvdevInput.h"
+#include "Test_JoystickStore.h"
+#include "Test_JoystickEncoding.h"
 #include "Test_Sockets.h"
+#include "Test_Protocol.h"
 #include "Test_Watchdog.h"
 #include "Test_DS_Config.h"
 #include "Test_NetConsole.h"
+#include "Test_StreamFramer.h"
 #include "Test_DriverStation.h"
 
 int main (int argc, char* argv[]) {
-    QApplication app (argc, argv);
+    QCoreApplication app (argc, argv);
+    int status = 0;
 
-    QTest::qExec (new Test_CRC32, argc, argv);
-    QTest::qExec (new Test_Watchdog, argc, argv);
-    QTest::qExec (new Test_DS_Config, argc, argv);
-    QTest::qExec (new Test_DriverStation, argc, argv);
-    QTest::qExec (new Test_SocketsSenderUDP, argc, argv);
-    QTest::qExec (new Test_SocketsSenderTCP, argc, argv);
-    QTest::qExec (new Test_NetConsoleSender, argc, argv);
-    QTest::qExec (new Test_NetConsoleReceiver, argc, argv);
+    status |= QTest::qExec (new Test_CRC32, argc, argv);
+    status |= QTest::qExec (new Test_Watchdog, argc, argv);
+    status |= QTest::qExec (new Test_DS_Config, argc, argv);
+    status |= QTest::qExec (new Test_DriverStation, argc, argv);
+    status |= QTest::qExec (new Test_Fleet, argc, argv);
+    status |= QTest::qExec (new Test_FieldServer, argc, argv);
+    status |= QTest::qExec (new Test_Histogram, argc, argv);
+    status |= QTest::qExec (new Test_LoopMonitor, argc, argv);
+    status |= QTest::qExec (new Test_StageTimers, argc, argv);
+    status |= QTest::qExec (new Test_Tracer, argc, argv);
+    status |= QTest::qExec (new Test_MetricsServer, argc, argv);
+    status |= QTest::qExec (new Test_Engine, argc, argv);
+    status |= QTest::qExec (new Test_TelemetryExport, argc, argv);
+    status |= QTest::qExec (new Test_ControlServer, argc, argv);
+    status |= QTest::qExec (new Test_EventBus, argc, argv);
+    status |= QTest::qExec (new Test_StateSnapshot, argc, argv);
+    status |= QTest::qExec (new Test_JoystickStore, argc, argv);
+    status |= QTest::qExec (new Test_JoystickEncoding, argc, argv);
+    status |= QTest::qExec (new Test_EvdevInput, argc, argv);
+    status |= QTest::qExec (new Test_StreamFramer, argc, argv);
+    status |= QTest::qExec (new Test_Protocol, argc, argv);
+    status |= QTest::qExec (new Test_SocketsSenderUDP, argc, argv);
+    status |= QTest::qExec (new Test_SocketsSenderTCP, argc, argv);
+    status |= QTest::qExec (new Test_SocketsLoopback, argc, argv);
+    status |= QTest::qExec (new Test_SocketTuning, argc, argv);
+    status |= QTest::qExec (new Test_Impairment, argc, argv);
+    status |= QTest::qExec (new Test_NetConsoleSender, argc, argv);
+    status |= QTest::qExec (new Test_NetConsoleReceiver, argc, argv);
 
-    QTimer::singleShot (2000, Qt::PreciseTimer, qApp, SLOT (quit()));
-
-    return app.exec();
+    return status;
 }